@@ -0,0 +1,29 @@
+## prob = bench_problem (m, n, density)
+##
+## Builds a random feasible linear problem with m constraints, n variables and 
+## the given density of the constraint matrix, used by the benchmark scripts in 
+## this directory. The random generators are seeded, so repeated calls return 
+## the same problem.
+
+function prob = bench_problem(m, n, density)
+
+  rand("seed", 42);
+  randn("seed", 42);
+
+  A = sprandn(m, n, density);
+  x = rand(n, 1);
+  r = A * x;
+
+  prob.sense = "min";
+  prob.c     = randn(1, n);
+  prob.A     = A;
+  prob.blc   = (r - rand(m, 1))';
+  prob.buc   = (r + rand(m, 1))';
+  prob.blx   = zeros(1, n);
+  prob.bux   = 10 * ones(1, n);
+
+  # Keep some infinite bounds in the files
+  prob.blc(1:3:end) = -Inf;
+  prob.bux(1:5:end) = Inf;
+
+endfunction
@@ -0,0 +1,45 @@
+## Measures the throughput in MB/s of mosek_read on an MPS file with the native 
+## reader against reading through MOSEK (the default). Run from Octave with the 
+## package loaded:
+##
+##   pkg load octmosek
+##   addpath("bench"); bench_reader
+##
+## The size of the problem can be changed by defining m, n and density before 
+## running the script. Results are printed as the best of 'reps' repetitions.
+
+if (!exist("m", "var"))        m = 50000;       endif
+if (!exist("n", "var"))        n = 100000;      endif
+if (!exist("density", "var"))  density = 2e-4;  endif
+if (!exist("reps", "var"))     reps = 3;        endif
+
+prob = bench_problem(m, n, density);
+file = [tempname() ".mps"];
+
+unwind_protect
+  mosek_write(prob, file, struct("verbose", 0));
+  info = dir(file);
+  mbytes = info.bytes / 2^20;
+
+  printf("MPS file of %.1f MB with %d nonzeros\n", mbytes, nnz(prob.A));
+  printf("%-8s %12s %12s\n", "reader", "time (s)", "MB/s");
+
+  readers = {"mosek", "native"};
+  for k = 1:numel(readers)
+    opts = struct("verbose", 0, "reader", readers{k});
+    best = Inf;
+    for rep = 1:reps
+      t = tic(); r = mosek_read(file, opts); best = min(best, toc(t));
+    endfor
+
+    if (nnz(r.prob.A) != nnz(prob.A))
+      warning("The %s reader returned %d nonzeros", readers{k}, nnz(r.prob.A));
+    endif
+
+    printf("%-8s %12.3f %12.1f\n", readers{k}, best, mbytes / best);
+  endfor
+unwind_protect_cleanup
+  if (exist(file, "file"))
+    delete(file);
+  endif
+end_unwind_protect
@@ -0,0 +1,45 @@
+## Compares the time to load a problem from a binary snapshot (.omsk) with the 
+## round trips through the OPF and MPS formats of MOSEK (writing the file and 
+## reading it back with mosek_read). Run from Octave with the package loaded:
+##
+##   pkg load octmosek
+##   addpath("bench"); bench_snapshot
+##
+## The size of the problem can be changed by defining m, n and density before 
+## running the script. Results are printed as the best of 'reps' repetitions.
+
+if (!exist("m", "var"))        m = 20000;       endif
+if (!exist("n", "var"))        n = 40000;       endif
+if (!exist("density", "var"))  density = 5e-4;  endif
+if (!exist("reps", "var"))     reps = 3;        endif
+
+prob = bench_problem(m, n, density);
+quiet = struct("verbose", 0);
+formats = {"omsk", "opf", "mps"};
+
+printf("Problem with %d constraints, %d variables and %d nonzeros\n", m, n, nnz(prob.A));
+printf("%-6s %12s %12s %12s\n", "format", "size (MB)", "write (s)", "read (s)");
+
+for k = 1:numel(formats)
+  file = [tempname() "." formats{k}];
+  unwind_protect
+    twrite = Inf;
+    tread = Inf;
+    for rep = 1:reps
+      t = tic(); mosek_write(prob, file, quiet); twrite = min(twrite, toc(t));
+      t = tic(); r = mosek_read(file, quiet);   tread = min(tread, toc(t));
+    endfor
+
+    # The problem should survive the round trip
+    if (nnz(r.prob.A) != nnz(prob.A) || max(abs(r.prob.c - prob.c)) > 1e-12 * max(abs(prob.c)))
+      warning("The problem changed in the round trip through %s", formats{k});
+    endif
+
+    info = dir(file);
+    printf("%-6s %12.2f %12.3f %12.3f\n", formats{k}, info.bytes / 2^20, twrite, tread);
+  unwind_protect_cleanup
+    if (exist(file, "file"))
+      delete(file);
+    endif
+  end_unwind_protect
+endfor
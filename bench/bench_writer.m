@@ -0,0 +1,55 @@
+## Measures the throughput in MB/s of mosek_write with the native writer 
+## against writing through MOSEK (the default), for the MPS, LP and OPF 
+## formats. Each file written by the native writer is read back by MOSEK and 
+## compared to the problem, which should match exactly. Run from Octave with 
+## the package loaded:
+##
+##   pkg load octmosek
+##   addpath("bench"); bench_writer
+##
+## The size of the problem can be changed by defining m, n and density before 
+## running the script. Results are printed as the best of 'reps' repetitions.
+
+if (!exist("m", "var"))        m = 50000;       endif
+if (!exist("n", "var"))        n = 100000;      endif
+if (!exist("density", "var"))  density = 2e-4;  endif
+if (!exist("reps", "var"))     reps = 3;        endif
+
+prob = bench_problem(m, n, density);
+printf("Problem with %d constraints, %d variables and %d nonzeros\n", m, n, nnz(prob.A));
+printf("%-6s %-8s %12s %12s %12s\n", "format", "writer", "size (MB)", "time (s)", "MB/s");
+
+formats = {"mps", "lp", "opf"};
+writers = {"mosek", "native"};
+for f = 1:numel(formats)
+  file = [tempname() "." formats{f}];
+
+  unwind_protect
+    for k = 1:numel(writers)
+      opts = struct("verbose", 0, "writer", writers{k});
+      best = Inf;
+      for rep = 1:reps
+        t = tic(); mosek_write(prob, file, opts); best = min(best, toc(t));
+      endfor
+
+      info = dir(file);
+      mbytes = info.bytes / 2^20;
+      printf("%-6s %-8s %12.1f %12.3f %12.1f\n", formats{f}, writers{k}, mbytes, best, mbytes / best);
+
+      # Round trip: the file read back by MOSEK should be the same problem
+      if (strcmp(writers{k}, "native"))
+        r = mosek_read(file, struct("verbose", 0));
+        same = isequal(r.prob.A, prob.A) && isequal(r.prob.c, prob.c) ...
+            && isequal(r.prob.blc, prob.blc) && isequal(r.prob.buc, prob.buc) ...
+            && isequal(r.prob.blx, prob.blx) && isequal(r.prob.bux, prob.bux);
+        if (!same)
+          warning("The %s file of the native writer was not read back as the same problem", formats{f});
+        endif
+      endif
+    endfor
+  unwind_protect_cleanup
+    if (exist(file, "file"))
+      delete(file);
+    endif
+  end_unwind_protect
+endfor
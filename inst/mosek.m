@@ -32,7 +32,7 @@
 ## @item ..intsub                        @tab INTEGER VECTOR    @tab (OPTIONAL)         
 ## @item ..iparam/dparam/sparam          @tab STRUCTURE         @tab (OPTIONAL)         
 ## @item ....<MSK_PARAM>                 @tab STRING / SCALAR   @tab (OPTIONAL)         
-## @item ..sol                           @tab STRUCTURE         @tab (OPTIONAL)         
+## @item ..sol                           @tab STRUCTURE/STRING  @tab (OPTIONAL)         
 ## @item ....itr/bas/int                 @tab STRUCTURE         @tab (OPTIONAL)
 ## @end multitable
 ##
@@ -43,6 +43,27 @@
 ## @item ..useparam                      @tab BOOLEAN            @tab (OPTIONAL)         
 ## @item ..writebefore                   @tab STRING (filepath)  @tab (OPTIONAL)         
 ## @item ..writeafter                    @tab STRING (filepath)  @tab (OPTIONAL)         
+## @item ..incumbent                     @tab STRUCTURE          @tab (OPTIONAL)         
+## @item ....file                        @tab STRING (filepath)  @tab (OPTIONAL)         
+## @item ....ringbuffer                  @tab STRING (filepath)  @tab (OPTIONAL)         
+## @item ....ringsize                    @tab SCALAR             @tab (OPTIONAL)         
+## @item ....callback                    @tab FUNCTION HANDLE    @tab (OPTIONAL)         
+## @item ....interval                    @tab SCALAR             @tab (OPTIONAL)         
+## @item ..terminate                     @tab STRUCTURE          @tab (OPTIONAL)         
+## @item ....deadline                    @tab SCALAR             @tab (OPTIONAL)         
+## @item ....objtarget                   @tab SCALAR             @tab (OPTIONAL)         
+## @item ....stalltime                   @tab SCALAR             @tab (OPTIONAL)         
+## @item ....relgap                      @tab SCALAR             @tab (OPTIONAL)         
+## @item ..timeslice                     @tab SCALAR             @tab (OPTIONAL)         
+## @item ..skcodes                       @tab BOOLEAN            @tab (OPTIONAL)         
+## @item ..soltypes                      @tab STRING LIST        @tab (OPTIONAL)         
+## @item ..solitems                      @tab STRING LIST        @tab (OPTIONAL)         
+## @item ..lazysol                       @tab BOOLEAN            @tab (OPTIONAL)         
+## @item ..outbuf                        @tab STRUCT             @tab (OPTIONAL)         
+## @item ..outcol                        @tab SCALAR             @tab (OPTIONAL)         
+## @item ..solfile                       @tab STRING             @tab (OPTIONAL)         
+## @item ..sparseitems                   @tab STRING LIST        @tab (OPTIONAL)         
+## @item ..paramprofile                  @tab STRING             @tab (OPTIONAL)         
 ## @end multitable
 ##
 ## The optimization problem should be described in a structure of definitions. 
@@ -61,19 +82,118 @@
 ## Parameters can also be specified for the MOSEK call. @var{iparam} is integer-
 ## typed parameters, @var{dparam} ia double-typed parameters and @var{sparam} 
 ## is string-typed parameters. These parameters can be ignored by setting the 
-## option @var{useparam} to FALSE (the default is TRUE).
+## option @var{useparam} to FALSE (the default is TRUE). Parameter sets used 
+## in many calls can be defined once by @code{mosek_paramprofile} and selected 
+## by the option @var{paramprofile}, which is applied before @var{iparam}, 
+## @var{dparam} and @var{sparam}.
 ##
 ## Initial solutions are specified in @var{sol} and should have the same format 
 ## as the solution returned by the function call. This solution can be ignored 
-## by setting the option @var{usesol} to FALSE (the default is TRUE).
+## by setting the option @var{usesol} to FALSE (the default is TRUE). The 
+## @var{sol} may also be the path of a solution file written by 
+## @code{mosek_savesol}, which is loaded into MOSEK with one bulk call per 
+## solution type without passing through Octave.
+##
+## The @var{problem} may also be a lazy problem of class "mosek_problem" 
+## returned by @code{mosek_read} with the option @var{lazyprob}. A copy of its 
+## MOSEK task (with any initial solution) is then optimized as it is, without 
+## passing the problem through Octave, and the lazy problem is left unchanged. 
+## The parameter profile of option @var{paramprofile} is applied to the copy.
 ##
 ## The amount of information printed by the interface can be limited by 
 ## @var{verbose} (default=10). The generated model can be exported to any 
 ## standard modelling fileformat (e.g. lp, opf, lp or mbt), with (resp. without) 
 ## the identified solution using @var{writeafter} (resp. @var{writebefore}). 
+## Both files are written from a copy of the task on a background thread, so 
+## @var{writebefore} overlaps with the optimization and @var{writeafter} with 
+## the extraction of the solution. MOSEK can not copy the problem and solution 
+## status of a solution into another task, so a @var{writeafter} file holding 
+## solutions (.opf or .mbt) is written from the task itself before the 
+## solution is extracted. The outcome of each write is returned in the result, 
+## and a failed write only gives a warning.
 ##
 ## The optimization process can be terminated at any moment using CTRL + C.
 ##
+## The integer solutions found by the mixed-integer optimizer can be followed 
+## during the solve through the sinks in @var{incumbent}. Each new incumbent 
+## is appended to the binary @var{file}, written to a memory-mapped 
+## @var{ringbuffer} of @var{ringsize} slots (default=16), and passed as a 
+## structure with fields @var{xx}, @var{obj}, @var{time} and @var{count} to 
+## the function @var{callback}, which is called at most once every 
+## @var{interval} milliseconds (default=0). Both files start with a 64 byte 
+## header holding a magic string and the number of variables, and store each 
+## incumbent as the doubles [time, obj, xx] in the native byte order of the 
+## machine. Slots of the ring buffer are additionally prefixed by their 
+## incumbent number. Pressing CTRL + C or raising an error in @var{callback} 
+## stops the solve, and the interruption or error is passed on once MOSEK has 
+## returned.
+##
+## The solve can be stopped early by the rules in @var{terminate}: a wall-clock 
+## @var{deadline} in seconds, an objective target @var{objtarget} for the 
+## incumbent, a @var{stalltime} in seconds without an improving incumbent, and a 
+## relative gap @var{relgap} between incumbent and bound. For problems without 
+## integer variables, the primal and dual objectives of the interior-point 
+## iterates take the place of incumbent and bound: the objective target is met 
+## by primal feasible iterates only, and a shrinking gap counts as improvement. 
+## The simplex optimizers do not report these objectives, so only the deadline 
+## applies to them (with a warning). Times count from the start of each call, 
+## so with @var{timeslice} the rules apply per slice and @code{mosek_resume} 
+## should be given the remaining time. A solve stopped by a rule returns the 
+## best solution available, and the response message names the rule.
+##
+## Solves can be split into time slices of @var{timeslice} seconds. When a 
+## slice expires, or the solve is interrupted, the solution found so far is 
+## returned together with a token in @var{resume}, and the task is kept alive 
+## until the solve is continued by function @code{mosek_resume}.
+##
+## The status keys @var{skc} and @var{skx} of the solution are returned as 
+## cell arrays of strings, unless @var{skcodes} is TRUE (the default is FALSE) 
+## in which case they are returned as uint8 vectors of codes. These are much 
+## cheaper to build and can be translated by the table from @code{mosek_skmap}. 
+## Initial solutions are accepted in both formats.
+##
+## The solution types and items to return can be limited by @var{soltypes} 
+## (e.g. @{"int"@}) and @var{solitems} (e.g. @{"xx", "skx"@}), given as a 
+## string or a cell array of strings. Anything not listed is neither fetched 
+## from MOSEK nor allocated. By default all solution types and items are 
+## returned. The solution and problem status are always returned.
+##
+## Solution slices listed in @var{sparseitems} (e.g. @{"xx", "slx", "sux"@}) 
+## are returned as sparse row vectors instead of dense row vectors. This 
+## saves memory when most entries are exactly zero, as is often the case for 
+## duals and network flows.
+##
+## If @var{lazysol} is TRUE (the default is FALSE), the returned @var{sol} is 
+## an object of class "mosek_solution" that keeps the task alive and fetches 
+## each item from MOSEK on first access (e.g. r.sol.itr.xx), caching it 
+## afterwards. It is fetched in full where a structure is needed, e.g. when 
+## passed back as an initial solution. The task is released with the last 
+## copy of the object, or by @code{mosek_clean}. 
+## Suspended time-sliced solves always return the solution as a structure.
+## The first such object locks the interface in memory (see @code{mlock}), 
+## so it is not unloaded by @code{clear} or @code{pkg unload} until Octave 
+## exits.
+##
+## Solution slices meant for columns of preallocated matrices can be named in 
+## @var{outbuf}, organized like the solution (e.g. outbuf.itr.xx = X). Each 
+## matrix must be a full real matrix with one row per element of the slice 
+## and at least @var{outcol} columns (the default is 1). Octave values can not 
+## be written in place, so the matrices are only checked: each slice is 
+## returned as a column in @var{outbuf} of the result, and omitted from the 
+## returned solution. Only the slice is allocated per call, and storing it 
+## with e.g. X(:,k) = r.outbuf.itr.xx writes into X without copying it (as 
+## long as X is not shared with another variable).
+##
+## For very large models the solution can be streamed in chunks to the binary 
+## file @var{solfile}, such that only the solution and problem status are 
+## returned in @var{sol} together with the path in @var{solfile}. The file 
+## starts with a 64 byte header ("OMSKSOL1", uint32 version, uint32 number of 
+## items, uint64 number of variables and constraints), followed by a table of 
+## 40 byte items (char[16] name such as "itr.xx", uint32 type, uint32 unused, 
+## uint64 length, uint64 offset). The types are 1 for doubles, 2 for uint8 
+## status key codes and 3 for int32 status codes, and every offset is a 
+## multiple of 8 bytes, such that the data can be read or mapped in place.
+##
 ## @multitable {.......................} {....................................} 
 ## @item problem                         @tab Problem description
 ## @item ..sense                         @tab Objective sense, e.g. "max" or "min"
@@ -101,6 +221,27 @@
 ## @item ..useparam                      @tab Whether to use the specified parameter settings 
 ## @item ..writebefore                   @tab Filepath used to export model 
 ## @item ..writeafter                    @tab Filepath used to export model and solution 
+## @item ..incumbent                     @tab Sinks for integer solutions during the solve 
+## @item ....file                        @tab Filepath of appended incumbents 
+## @item ....ringbuffer                  @tab Filepath of memory-mapped ring buffer 
+## @item ....ringsize                    @tab Number of slots in the ring buffer 
+## @item ....callback                    @tab Function called with each incumbent 
+## @item ....interval                    @tab Minimum milliseconds between calls 
+## @item ..terminate                     @tab Rules for early termination 
+## @item ....deadline                    @tab Wall-clock seconds allowed for the solve 
+## @item ....objtarget                   @tab Incumbent objective good enough to stop 
+## @item ....stalltime                   @tab Seconds allowed without objective improvement 
+## @item ....relgap                      @tab Relative optimality gap good enough to stop 
+## @item ..timeslice                     @tab Seconds before the solve is suspended 
+## @item ..skcodes                       @tab Whether to return status keys as codes 
+## @item ..soltypes                      @tab Solution types to return (itr/bas/int) 
+## @item ..solitems                      @tab Solution items to return (skc/skx/xc/xx/...) 
+## @item ..lazysol                       @tab Whether to fetch solution items on access 
+## @item ..outbuf                        @tab Preallocated matrices for solution slices 
+## @item ..outcol                        @tab Column of outbuf matrices to check 
+## @item ..solfile                       @tab Binary file to stream the solution to 
+## @item ..sparseitems                   @tab Solution slices to return as sparse 
+## @item ..paramprofile                  @tab Parameter profile to apply 
 ## @end multitable
 ##
 ## @sp 1
@@ -115,15 +256,22 @@
 ## @item ....itr/bas/int		@tab STRUCTURE		@tab (SOLVER DEPENDENT) 
 ## @item ......solsta			@tab STRING		@tab 			
 ## @item ......prosta			@tab STRING		@tab 			
-## @item ......skx			@tab STRING VECTOR	@tab 			
-## @item ......skc			@tab STRING VECTOR	@tab 			
-## @item ......xx			@tab REAL VECTOR	@tab 			
-## @item ......xc			@tab REAL VECTOR	@tab 			
+## @item ......skx			@tab STRING/CODE VECTOR	@tab 			
+## @item ......skc			@tab STRING/CODE VECTOR	@tab 			
+## @item ......xx			@tab REAL/SPARSE VECTOR	@tab 			
+## @item ......xc			@tab REAL/SPARSE VECTOR	@tab 			
 ## @item ......slc			@tab REAL VECTOR	@tab (NOT IN int) 	
 ## @item ......suc			@tab REAL VECTOR	@tab (NOT IN int) 	
 ## @item ......slx			@tab REAL VECTOR	@tab (NOT IN int) 	
 ## @item ......sux 			@tab REAL VECTOR	@tab (NOT IN int) 	
 ## @item ......snx 			@tab REAL VECTOR	@tab (NOT IN int/bas) 
+## @item ..resume			@tab SCALAR		@tab (TIME-SLICED ONLY) 
+## @item ..solfile			@tab STRING		@tab (SOLFILE ONLY) 
+## @item ..outbuf			@tab STRUCTURE		@tab (OUTBUF ONLY) 
+## @item ..writebefore/writeafter	@tab STRUCTURE		@tab (WRITE ONLY) 	
+## @item ....response			@tab STRUCTURE		@tab 			
+## @item ....time			@tab SCALAR		@tab 			
+## @item ....wait			@tab SCALAR		@tab 			
 ## @end multitable
 ## 
 ## The result is a named list containing the response of the MOSEK optimization 
@@ -163,6 +311,13 @@
 ## @item ......slx			@tab Dual variable for variable lower bounds  
 ## @item ......sux 			@tab Dual variable for variable lower bounds  
 ## @item ......snx 			@tab Dual variable of conic constraints 
+## @item ..resume			@tab Token of a suspended solve 
+## @item ..solfile			@tab Binary file holding the solution 
+## @item ..outbuf			@tab Solution slices as columns 
+## @item ..writebefore/writeafter	@tab Outcome of the model file export 
+## @item ....response			@tab Response of the write 
+## @item ....time			@tab Seconds spent writing 
+## @item ....wait			@tab Seconds the result waited for the write 
 ## @end multitable
 ##
 ## @sp 1
@@ -184,7 +339,7 @@
 ## @end group
 ## @end example
 ##
-## @seealso{mosek_version,mosek_clean}
+## @seealso{mosek_solvefile,mosek_resume,mosek_skmap,mosek_paramprofile,mosek_tune,mosek_savesol,mosek_loadsol,mosek_version,mosek_clean}
 ##
 ## @end deftypefn 
 
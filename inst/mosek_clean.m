@@ -9,6 +9,8 @@
 ## automatically take place at the next call to the function @code{mosek} given 
 ## a valid problem description, using a small amount of extra time.
 ##
+## Any suspended time-sliced solves and parameter profiles are released as well.
+##
 ## @seealso{mosek}
 ##
 ## @end deftypefn
@@ -0,0 +1,120 @@
+## -*- texinfo -*-
+## @deftypefn{Loadable Function} {@var{r} =} mosek_convert (@var{inputs}, @var{outputs}, @var{opts} {= struct()})
+## 
+## >> Convert model files between fileformats.
+## 
+## Reads each model file into a MOSEK task and writes it from there in the 
+## fileformat of the output path, without building the problem in Octave. 
+## This is faster and uses less memory than @code{mosek_read} followed by 
+## @code{mosek_write}.
+## 
+## @sp 1
+## ========== Arguments ==========
+## @sp 1
+## @multitable {..............} {..................} {...........}
+## @item inputs 			 @tab STRING (filepath)  @tab			
+## @item outputs 			 @tab STRING (filepath)  @tab			
+## @end multitable
+##
+## @multitable {..............} {..................} {...........}
+## @item opts                            @tab STRUCTURE          @tab (OPTIONAL)         
+## @item ..verbose                       @tab SCALAR             @tab (OPTIONAL)         
+## @item ..usesol                        @tab BOOLEAN            @tab (OPTIONAL)         
+## @item ..useparam                      @tab BOOLEAN            @tab (OPTIONAL)         
+## @item ..reader                        @tab STRING             @tab (OPTIONAL)          
+## @end multitable
+##
+## The @var{inputs} and @var{outputs} should be absolute paths to model files, 
+## or cell arrays with the same number of such paths. The fileformats are 
+## given by the extensions as in @code{mosek_read} and @code{mosek_write}, 
+## including compressed files and snapshots (extension @code{.omsk}). Snapshots 
+## and MPS files read by the native reader (@var{reader} is "native") are 
+## loaded into the task from their problem description, and snapshots are 
+## written from one.
+##
+## The initial solution and parameters of the input are written to the output 
+## if the fileformat allows it and @var{usesol} (resp. @var{useparam}) is TRUE. 
+## Both are FALSE by default, as for @code{mosek_read} and @code{mosek_write}.
+##
+## @multitable {..............} {...............................................} 
+## @item inputs 			 @tab Filepath to the model to read
+## @item outputs 			 @tab Filepath to the model to write
+## @end multitable
+## 
+## @multitable {..............} {...............................................} 
+## @item opts                            @tab Options 
+## @item ..verbose                       @tab Output logging verbosity 
+## @item ..usesol                        @tab Whether to write the initial solution 
+## @item ..useparam                      @tab Whether to write all parameters 
+## @item ..reader                        @tab Reader of MPS files ("native" or "mosek") 
+## @end multitable
+##
+## @sp 1
+## ========== Value ==========
+## @sp 1
+## @multitable {...............} {..................} {...........}
+## @item r				@tab STRUCTURE		@tab 			
+## @item ..response			@tab STRUCTURE		@tab 			
+## @item ....code			@tab SCALAR		@tab 			
+## @item ....msg			@tab STRING		@tab 			
+## @item ..results			@tab STRUCT ARRAY	@tab (MULTIPLE FILES)	
+## @item ....response			@tab STRUCTURE		@tab			
+## @end multitable
+##
+## The result is a named list containing the response of the interface when 
+## converting the model file. A response code of zero is the signal of success.
+##
+## If @var{inputs} is a cell array of paths, the files are converted in 
+## parallel with one task per file, starting the next file as soon as one is 
+## done and holding at most two models per processor in memory at a time. The result contains the struct array @var{results} of the same 
+## shape as @var{inputs} with the response of each file in input order. A file 
+## that cannot be converted does not stop the others, so the response of each 
+## file should be checked.
+##
+## @multitable {...............} {............................................} 
+## @item r				@tab Result 
+## @item ..response			@tab Response from the interface 
+## @item ....code			@tab ID-code of response 
+## @item ....msg			@tab Human-readable message 
+## @item ..results			@tab Response of each file 
+## @end multitable
+##
+## @sp 1
+## ========== Examples ==========
+## @sp 1
+## @example
+## @group
+## pkg_root = pkg("list")@{strcmp(@{[pkg("list")@{:@}].name@},"octmosek")@}.dir;
+## modelfile = fullfile(pkg_root, "extdata", "milo1.opf");
+## rr = mosek_convert(modelfile, fullfile(tempdir, "milo1.mps"));
+## if (rr.response.code ~= 0)
+##   error("Failed to convert model file");
+## endif
+## @end group
+## @end example
+##
+## @seealso{mosek_read,mosek_write}
+##
+## @end deftypefn                 
+
+function r = mosek_convert(inputs, outputs, opts=struct())
+
+  if (nargin < 2 || nargin > 3 || nargout > 1)
+    print_usage();
+  endif
+
+  old_val = page_screen_output;
+  unwind_protect
+    page_screen_output(0);
+    try
+  
+      r = __mosek_convert__(inputs, outputs, opts);
+
+    catch
+      error(strcat(lasterr,"\n"));    % Newline prevents printing call-sequence
+    end_try_catch
+  unwind_protect_cleanup
+    page_screen_output(old_val);
+  end_unwind_protect 
+  
+endfunction
@@ -0,0 +1,133 @@
+## -*- texinfo -*-
+## @deftypefn{Loadable Function} {@var{r} =} mosek_inspect (@var{modelfile}, @var{opts} {= struct()})
+## 
+## >> Summarize a model file.
+## 
+## Returns the dimensions and summary statistics of a model in any of the 
+## fileformats read by @code{mosek_read}, without building the problem in 
+## Octave. This is useful to classify many model files quickly, e.g. to 
+## schedule their optimization.
+## 
+## @sp 1
+## ========== Arguments ==========
+## @sp 1
+## @multitable {..............} {..................} {...........}
+## @item modelfile 			 @tab STRING (filepath)  @tab			
+## @end multitable
+##
+## @multitable {..............} {..................} {...........}
+## @item opts                            @tab STRUCTURE          @tab (OPTIONAL)         
+## @item ..verbose                       @tab SCALAR             @tab (OPTIONAL)         
+## @item ..reader                        @tab STRING             @tab (OPTIONAL)          
+## @end multitable
+##
+## The @var{modelfile} should be an absolute path to a model file, or a cell 
+## array of such paths. Snapshots (extension @code{.omsk}) are summarized from 
+## their header and memory-mapped arrays. MPS files are scanned by the native 
+## reader of @code{mosek_read}, keeping only the row indexes of the constraint 
+## matrix, unless @var{reader} is "mosek" (the default is "native" for this 
+## function). MPS files rejected by the native reader (e.g. with quadratic 
+## sections) are read by MOSEK instead. All other files are read by MOSEK, and 
+## the constraint matrix is summarized from the task one column at a time.
+##
+## The amount of information printed by the interface can be limited by 
+## @var{verbose} (default=10).
+##
+## @multitable {..............} {...............................................} 
+## @item modelfile 			 @tab Filepath to the model
+## @end multitable
+## 
+## @multitable {..............} {...............................................} 
+## @item opts                            @tab Options 
+## @item ..verbose                       @tab Output logging verbosity 
+## @item ..reader                        @tab Reader of MPS files ("native" or "mosek") 
+## @end multitable
+##
+## @sp 1
+## ========== Value ==========
+## @sp 1
+## @multitable {...............} {..................} {...........}
+## @item r				@tab STRUCTURE		@tab 			
+## @item ..response			@tab STRUCTURE		@tab 			
+## @item ....code			@tab SCALAR		@tab 			
+## @item ....msg			@tab STRING		@tab 			
+## @item ..info				@tab STRUCTURE		@tab			
+## @item ....sense			@tab STRING		@tab			
+## @item ....numvar			@tab SCALAR		@tab			
+## @item ....numcon			@tab SCALAR		@tab			
+## @item ....numanz			@tab SCALAR		@tab			
+## @item ....numintvar			@tab SCALAR		@tab			
+## @item ....numcone			@tab SCALAR		@tab			
+## @item ....intfraction		@tab SCALAR		@tab			
+## @item ....rownz			@tab NUMERIC VECTOR	@tab			
+## @item ....colnz			@tab NUMERIC VECTOR	@tab			
+## @item ....arange			@tab NUMERIC VECTOR	@tab			
+## @item ..results			@tab STRUCT ARRAY	@tab (MULTIPLE FILES)	
+## @item ....info			@tab STRUCTURE		@tab			
+## @item ....response			@tab STRUCTURE		@tab			
+## @end multitable
+##
+## The result is a named list containing the response of the interface when 
+## inspecting the model file. A response code of zero is the signal of success.
+##
+## On success, the result contains the summary @var{info} of the model. The 
+## vectors @var{rownz} and @var{colnz} hold the smallest and largest number of 
+## non-zeros in a row and column of the constraint matrix, and @var{arange} the 
+## smallest and largest absolute value of its non-zeros (each empty if there 
+## are none). The @var{intfraction} is the share of integer variables.
+##
+## If @var{modelfile} is a cell array of paths, the files are inspected in 
+## parallel, and the result contains the struct array @var{results} of the same 
+## shape with the summary and response of each file in input order, while 
+## @var{info} is absent. A file that cannot be inspected does not stop the 
+## others, so the response of each file should be checked.
+##
+## @multitable {...............} {............................................} 
+## @item r				@tab Result 
+## @item ..response			@tab Response from the interface 
+## @item ....code			@tab ID-code of response 
+## @item ....msg			@tab Human-readable message 
+## @item ..info				@tab Summary of the model
+## @item ..results			@tab Summary and response of each file 
+## @end multitable
+##
+## @sp 1
+## ========== Examples ==========
+## @sp 1
+## @example
+## @group
+## pkg_root = pkg("list")@{strcmp(@{[pkg("list")@{:@}].name@},"octmosek")@}.dir;
+## modelfile = fullfile(pkg_root, "extdata", "milo1.opf");
+## rr = mosek_inspect(modelfile);
+## if (rr.response.code ~= 0)
+##   error("Failed to inspect model file");
+## endif
+## printf("%d x %d, %d integer\n", rr.info.numcon, rr.info.numvar, rr.info.numintvar);
+## @end group
+## @end example
+##
+## @seealso{mosek_read}
+##
+## @end deftypefn                 
+
+function r = mosek_inspect(modelfile, opts=struct())
+
+  if (nargin < 1 || nargin > 2 || nargout > 1)
+    print_usage();
+  endif
+
+  old_val = page_screen_output;
+  unwind_protect
+    page_screen_output(0);
+    try
+  
+      r = __mosek_inspect__(modelfile, opts);
+
+    catch
+      error(strcat(lasterr,"\n"));    % Newline prevents printing call-sequence
+    end_try_catch
+  unwind_protect_cleanup
+    page_screen_output(old_val);
+  end_unwind_protect 
+  
+endfunction
@@ -0,0 +1,86 @@
+## -*- texinfo -*-
+## @deftypefn{Loadable Function} {@var{r} =} mosek_loadsol (@var{solfile}, @var{opts} {= struct()})
+## 
+## >> Load a solution from a binary file.
+##
+## Reads a solution file written by @code{mosek_savesol}, or by the option 
+## @var{solfile} of @code{mosek}, into a solution compliant with the output of 
+## function @code{mosek}. Status keys are returned as strings, or as uint8 codes 
+## if the option @var{skcodes} is TRUE (the default is FALSE).
+##
+## To warm start a solve, it is cheaper to give the path of the solution file 
+## as the initial solution @var{sol} of the problem than to load it first.
+##
+## @sp 1
+## ========== Arguments ==========
+## @sp 1
+## @multitable {..............} {..................} {...........}
+## @item solfile 			 @tab STRING (filepath)	@tab			
+## @end multitable
+##
+## @multitable {..............} {..................} {...........}
+## @item opts                            @tab STRUCTURE          @tab (OPTIONAL)         
+## @item ..verbose                       @tab SCALAR             @tab (OPTIONAL)         
+## @item ..skcodes                       @tab BOOLEAN            @tab (OPTIONAL)         
+## @end multitable
+##
+## @multitable {..............} {...............................................} 
+## @item solfile 			 @tab Filepath of the solution file
+## @item opts                            @tab Options 
+## @item ..verbose                       @tab Output logging verbosity 
+## @item ..skcodes                       @tab Whether to return status keys as codes 
+## @end multitable
+##
+## @sp 1
+## ========== Value ==========
+## @sp 1
+## @multitable {..............} {..................} {...........}
+## @item r				@tab STRUCTURE		@tab 			
+## @item ..response			@tab STRUCTURE		@tab 			
+## @item ....code			@tab SCALAR		@tab 			
+## @item ....msg			@tab STRING		@tab 			
+## @item ..sol				@tab STRUCTURE		@tab 			
+## @end multitable
+##
+## The result is a named list containing the response of the interface when 
+## reading the solution file. A response code of zero is the signal of success.
+## On success, the result contains the solution @var{sol} as returned by 
+## @code{mosek}, except for the solution items that were not saved.
+##
+## @sp 1
+## ========== Examples ==========
+## @sp 1
+## @example
+## @group
+## r = mosek(lo1);
+## mosek_savesol("lo1.sol", r.sol);
+## rr = mosek_loadsol("lo1.sol");
+## xx = rr.sol.bas.xx;
+## @end group
+## @end example
+##
+## @seealso{mosek,mosek_savesol}
+##
+## @end deftypefn
+
+function r = mosek_loadsol(solfile, opts=struct())
+
+  if (nargin < 1 || nargin > 2 || nargout > 1)
+    print_usage();
+  endif
+
+  old_val = page_screen_output;
+  unwind_protect
+    page_screen_output(0);
+    try
+
+      r = __mosek_loadsol__(solfile, opts);
+
+    catch
+      error(strcat(lasterr,"\n"));    % Newline prevents printing call-sequence
+    end_try_catch
+  unwind_protect_cleanup
+    page_screen_output(old_val);
+  end_unwind_protect
+
+endfunction
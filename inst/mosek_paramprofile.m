@@ -0,0 +1,77 @@
+## -*- texinfo -*-
+## @deftypefn{Loadable Function} {@var{r} =} mosek_paramprofile (@var{name}, @var{iparam} {= struct()}, @var{dparam} {= struct()}, @var{sparam} {= struct()})
+## 
+## >> Define a named set of parameters.
+##
+## Validates the parameter settings once and stores them under @var{name}, such 
+## that later calls to @code{mosek} and @code{mosek_resume} can refer to them by 
+## the option @var{paramprofile}. Applying a profile involves no name lookups, 
+## and is skipped entirely on a task where the same profile was the last one 
+## applied (e.g. when resuming a time-sliced solve). Parameters given in the 
+## problem description are applied after the profile and take precedence.
+##
+## The parameters are specified as in the problem description of function 
+## @code{mosek}. Calling the function with only a @var{name} removes the 
+## profile, and all profiles are removed by @code{mosek_clean}.
+##
+## @sp 1
+## ========== Arguments ==========
+## @sp 1
+## @multitable {..............} {..................} {...........}
+## @item name 				 @tab STRING		@tab			
+## @item iparam 			 @tab STRUCTURE		@tab (OPTIONAL)		
+## @item dparam 			 @tab STRUCTURE		@tab (OPTIONAL)		
+## @item sparam 			 @tab STRUCTURE		@tab (OPTIONAL)		
+## @end multitable
+##
+## @sp 1
+## ========== Value ==========
+## @sp 1
+##
+## @multitable {..............} {..................} {...........}
+## @item r				@tab STRUCTURE		@tab 			
+## @item ..response			@tab STRUCTURE		@tab 			
+## @item ....code			@tab SCALAR		@tab 			
+## @item ....msg			@tab STRING		@tab 			
+## @end multitable
+##
+## The result contains the response of the interface, where a response code of 
+## zero is the signal of success.
+##
+## @sp 1
+## ========== Examples ==========
+## @sp 1
+##
+## @example
+## @group
+## mosek_paramprofile("fast", struct("OPTIMIZER", "FREE_SIMPLEX"), 
+##                    struct("OPTIMIZER_MAX_TIME", 10));
+## r = mosek(lo1, struct("paramprofile", "fast"));
+## @end group
+## @end example
+##
+## @seealso{mosek,mosek_tune,mosek_clean}
+##
+## @end deftypefn
+
+function r = mosek_paramprofile(name, varargin)
+
+  if (nargin < 1 || nargin > 4 || nargout > 1)
+    print_usage();
+  endif
+
+  old_val = page_screen_output;
+  unwind_protect
+    page_screen_output(0);
+    try
+
+      r = __mosek_paramprofile__(name, varargin{:});
+
+    catch
+      error(strcat(lasterr,"\n"));    % Newline prevents printing call-sequence
+    end_try_catch
+  unwind_protect_cleanup
+    page_screen_output(old_val);
+  end_unwind_protect
+  
+endfunction
@@ -12,7 +12,7 @@
 ## ========== Arguments ==========
 ## @sp 1
 ## @multitable {..............} {..................} {...........}
-## @item modelfile 			 @tab STRING (filepath)  @tab			
+## @item modelfile 			 @tab STRING (filepath) / UINT8 VECTOR  @tab			
 ## @end multitable
 ##
 ## @multitable {..............} {..................} {...........}
@@ -20,19 +20,55 @@
 ## @item ..verbose                       @tab SCALAR             @tab (OPTIONAL)         
 ## @item ..usesol                        @tab BOOLEAN            @tab (OPTIONAL)         
 ## @item ..useparam                      @tab BOOLEAN            @tab (OPTIONAL)          
+## @item ..nondefault                    @tab BOOLEAN            @tab (OPTIONAL)          
+## @item ..reader                        @tab STRING             @tab (OPTIONAL)          
+## @item ..lazyprob                      @tab BOOLEAN            @tab (OPTIONAL)          
+## @item ..format                        @tab STRING             @tab (OPTIONAL)          
 ## @end multitable
 ##
-## The @var{modelfile} should be an absolute path to a model file. 
+## The @var{modelfile} should be an absolute path to a model file. Compressed 
+## model files with a last extension of @code{.gz} or @code{.zst} (e.g. 
+## @code{model.opf.gz}) are decompressed on the fly, without temporary files. 
+## Files with the extension @code{.omsk} are binary snapshots written by 
+## @code{mosek_write}, and are mapped into memory and read without creating a 
+## MOSEK task.
+##
+## If the option @var{format} is given (one of "mps", "lp", "opf", "mbt" or 
+## "xml"), the @var{modelfile} is the model itself as a uint8 vector (use 
+## @code{uint8(str)} for a string), e.g. received over a socket, and is streamed 
+## to MOSEK through a pipe without touching the disk. This is only available on UNIX-alike platforms, and the 
+## model is always read by MOSEK.
 ##
 ## The amount of information printed by the interface can be limited by 
 ## @var{verbose} (default=10). Whether to read the initial solution, if one 
 ## such exists in the model file, is indicated by @var{usesol} which by default 
 ## is FALSE. Whether to read the full list of parameter settings, some of which 
 ## may have been changed by the model file, is indicated by @var{useparam} 
-## which by default is FALSE.
+## which by default is FALSE. If @var{nondefault} is TRUE (the default is 
+## FALSE), only the parameters differing from the MOSEK defaults are read, 
+## which keeps the problem small and quick to pass back to @code{mosek}.
+##
+## The model file is read by MOSEK unless @var{reader} is "native" (the default 
+## is "mosek"), in which case MPS files are parsed by the interface itself on 
+## all processors, and the constraint matrix is built directly in Octave without 
+## creating a MOSEK task. The native reader supports the free MPS format with 
+## integer markers and the RHS, RANGES, BOUNDS and CSECTION sections, but no 
+## quadratic sections, parameters or initial solutions. As in MOSEK, bounds of 
+## magnitude 1e30 or more are read as infinite.
+##
+## If @var{lazyprob} is TRUE (the default is FALSE), the returned @var{prob} is 
+## an object of class "mosek_problem" that keeps the MOSEK task alive and 
+## fetches each item on first access (e.g. r.prob.A), caching it afterwards. 
+## It is fetched in full where a structure is needed, e.g. by @code{struct} or 
+## @code{mosek_write}. Passed to @code{mosek}, a copy of the task is optimized 
+## as it is without passing the problem through Octave, and the object can 
+## still be used afterwards. The task is released with the last copy of the 
+## object, or by @code{mosek_clean}. The first such object locks the interface 
+## in memory (see @code{mlock}). This option requires a single model read 
+## by MOSEK (not a snapshot or the native reader).
 ##
 ## @multitable {..............} {...............................................} 
-## @item modelfile 			 @tab Filepath to the model
+## @item modelfile 			 @tab Filepath to the model (or the model itself)
 ## @end multitable
 ## 
 ## @multitable {..............} {...............................................} 
@@ -40,6 +76,10 @@
 ## @item ..verbose                       @tab Output logging verbosity 
 ## @item ..usesol                        @tab Whether to use the initial solution 
 ## @item ..useparam                      @tab Whether to use the specified parameter settings 
+## @item ..nondefault                    @tab Whether to read only non-default parameters 
+## @item ..reader                        @tab Reader of the model file ("mosek" or "native") 
+## @item ..lazyprob                      @tab Whether to fetch problem items on access 
+## @item ..format                        @tab Format of a model given in memory 
 ## @item ..writebefore                   @tab Filepath used to export model 
 ## @item ..writeafter                    @tab Filepath used to export model and solution 
 ## @end multitable
@@ -53,6 +93,9 @@
 ## @item ....code			@tab SCALAR		@tab 			
 ## @item ....msg			@tab STRING		@tab 			
 ## @item ..prob				@tab STRUCTURE		@tab			
+## @item ..results			@tab STRUCT ARRAY	@tab (MULTIPLE FILES)	
+## @item ....prob			@tab STRUCTURE		@tab			
+## @item ....response			@tab STRUCTURE		@tab			
 ## @end multitable
 ##
 ## The result is a named list containing the response of the MOSEK optimization 
@@ -63,12 +106,20 @@
 ## data. This problem specification is compliant with the input specifications 
 ## of function @code{mosek}.
 ##
+## If @var{modelfile} is a cell array of paths, the files are parsed in 
+## parallel with one MOSEK task per file, holding at most two models per 
+## processor in memory at a time, and the result contains the struct 
+## array @var{results} of the same shape with the problem and response of each 
+## file in input order, while @var{prob} is absent. A file that cannot be read 
+## does not stop the others, so the response of each file should be checked.
+##
 ## @multitable {...............} {............................................} 
 ## @item r				@tab Result 
 ## @item ..response			@tab Response from the MOSEK optimization library 
 ## @item ....code			@tab ID-code of response 
 ## @item ....msg			@tab Human-readable message 
 ## @item ..prob				@tab Problem desciption
+## @item ..results			@tab Problem and response of each file 
 ## @end multitable
 ##
 ## @sp 1
@@ -110,7 +161,30 @@
 ## @end group
 ## @end example
 ##
-## @seealso{mosek,mosek_write}
+## @example
+## @group
+## files = @{"lo1.opf", "milo1.opf", "cqo1.opf"@};
+## rr = mosek_read(fullfile(pkg_root, "extdata", files));
+## ok = arrayfun(@@(x) x.response.code == 0, rr.results);
+## @end group
+## @end example
+##
+## @example
+## @group
+## rr = mosek_read(modelfile, struct("lazyprob", true));
+## numvar = numel(rr.prob.c);
+## r = mosek(rr.prob);
+## @end group
+## @end example
+##
+## @example
+## @group
+## rr = mosek_write(lo1, "", struct("format", "opf"));
+## rr = mosek_read(rr.data, struct("format", "opf"));
+## @end group
+## @end example
+##
+## @seealso{mosek,mosek_write,mosek_inspect}
 ##
 ## @end deftypefn                 
 
@@ -0,0 +1,78 @@
+## -*- texinfo -*-
+## @deftypefn{Loadable Function} {@var{r} =} mosek_resume (@var{token}, @var{opts} {= struct()})
+## 
+## >> Resume a time-sliced optimization.
+## 
+## Continues an optimization that was suspended because its time slice expired 
+## or because it was interrupted, as signalled by the field @var{resume} in the 
+## result of function @code{mosek} when the option @var{timeslice} was used. 
+## The suspended task is kept alive between the calls, such that the solve 
+## continues from its retained state: the simplex optimizer hot-starts from the 
+## basic solution, and the mixed-integer optimizer starts from the best integer 
+## solution found so far. Note that the interior-point optimizer can not be 
+## warm-started and will restart from scratch.
+##
+## @sp 1
+## ========== Arguments ==========
+## @sp 1
+## @multitable {.......................} {..................} {...........}
+## @item token                           @tab SCALAR             @tab                    
+## @end multitable
+##
+## @multitable {.......................} {..................} {...........}
+## @item opts                            @tab STRUCTURE          @tab (OPTIONAL)         
+## @item ..verbose                       @tab SCALAR             @tab (OPTIONAL)         
+## @item ..timeslice                     @tab SCALAR             @tab (OPTIONAL)         
+## @end multitable
+##
+## All options of function @code{mosek} that concern the solve itself are 
+## recognized. If the time slice expires again, the result will again contain 
+## the field @var{resume}. Otherwise the suspended task is released. Invalid 
+## options are reported without touching the suspended task, which can then 
+## be resumed again with corrected options. Only tokens of suspended solves 
+## are accepted, so the tasks behind lazy solutions and problems can not be 
+## resumed (or released) by this function.
+## Suspended tasks can also be released by function @code{mosek_clean}.
+##
+## @sp 1
+## ========== Value ==========
+## @sp 1
+## The result has the same format as the result of function @code{mosek}.
+##
+## @sp 1
+## ========== Examples ==========
+## @sp 1
+## @example
+## @group
+## r = mosek(prob, struct("timeslice", 10));
+## while (isfield(r, "resume"))
+##   r = mosek_resume(r.resume, struct("timeslice", 10));
+## endwhile
+## @end group
+## @end example
+##
+## @seealso{mosek,mosek_clean}
+##
+## @end deftypefn 
+
+function r = mosek_resume(token, opts=struct())
+
+  if (nargin < 1 || nargin > 2 || nargout > 1)
+    print_usage();
+  endif
+
+  old_val = page_screen_output;
+  unwind_protect
+    page_screen_output(0);
+    try
+
+      r = __mosek_resume__(token, opts);
+
+    catch
+      error(strcat(lasterr,"\n"));    % Newline prevents printing call-sequence
+    end_try_catch
+  unwind_protect_cleanup
+    page_screen_output(old_val);
+  end_unwind_protect
+
+endfunction
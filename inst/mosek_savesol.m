@@ -0,0 +1,83 @@
+## -*- texinfo -*-
+## @deftypefn{Loadable Function} {@var{r} =} mosek_savesol (@var{solfile}, @var{sol})
+## 
+## >> Save a solution to a binary file.
+##
+## Writes the solution @var{sol} of function @code{mosek} to a compact binary 
+## file, such that it can be used as an initial solution later. Status keys are 
+## stored as codes and the solution items as raw vectors. If @var{sol} is a lazy 
+## solution (see option @var{lazysol} of @code{mosek}), the solution is written 
+## straight from the task without creating the Octave values.
+##
+## A saved solution is used for warm starts by giving its path as the initial 
+## solution @var{sol} of the problem, whereby it is loaded into MOSEK with one 
+## bulk call per solution type. It can also be read back into Octave by 
+## @code{mosek_loadsol}. The file has the format of the option @var{solfile} of 
+## @code{mosek}, except that the header counts zero variables (resp. 
+## constraints) if @var{sol} has no items of that kind. The items of a saved 
+## solution are checked against the problem when it is used, and missing items 
+## are taken as unknown status keys and zero vectors.
+##
+## @sp 1
+## ========== Arguments ==========
+## @sp 1
+## @multitable {..............} {..................} {...........}
+## @item solfile 			 @tab STRING (filepath)	@tab			
+## @item sol 				 @tab STRUCTURE		@tab			
+## @end multitable
+##
+## @multitable {..............} {...............................................} 
+## @item solfile 			 @tab Filepath of the solution file
+## @item sol 				 @tab Solution returned by @code{mosek}
+## @end multitable
+##
+## @sp 1
+## ========== Value ==========
+## @sp 1
+## @multitable {..............} {..................} {...........}
+## @item r				@tab STRUCTURE		@tab 			
+## @item ..response			@tab STRUCTURE		@tab 			
+## @item ....code			@tab SCALAR		@tab 			
+## @item ....msg			@tab STRING		@tab 			
+## @end multitable
+##
+## The result is a named list containing the response of the interface when 
+## writing the solution file. A response code of zero is the signal of success.
+##
+## @sp 1
+## ========== Examples ==========
+## @sp 1
+## @example
+## @group
+## r = mosek(lo1);
+## mosek_savesol("lo1.sol", r.sol);
+## lo1.sol = "lo1.sol";
+## r = mosek(lo1);
+## @end group
+## @end example
+##
+## @seealso{mosek,mosek_loadsol}
+##
+## @end deftypefn
+
+function r = mosek_savesol(solfile, sol)
+
+  if (nargin ~= 2 || nargout > 1)
+    print_usage();
+  endif
+
+  old_val = page_screen_output;
+  unwind_protect
+    page_screen_output(0);
+    try
+
+      r = __mosek_savesol__(solfile, sol);
+
+    catch
+      error(strcat(lasterr,"\n"));    % Newline prevents printing call-sequence
+    end_try_catch
+  unwind_protect_cleanup
+    page_screen_output(old_val);
+  end_unwind_protect
+
+endfunction
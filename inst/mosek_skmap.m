@@ -0,0 +1,46 @@
+## -*- texinfo -*-
+## @deftypefn{Loadable Function} {@var{r} =} mosek_skmap ()
+## 
+## >> Names of the status key codes.
+##
+## Retrieves a cell array @var{r} with the name of each status key code, such 
+## that code @var{k} is named by @code{@var{r}@{@var{k}+1@}}. The codes are 
+## returned in the solution fields @var{skc} and @var{skx} when function 
+## @code{mosek} is called with the option @var{skcodes} set to TRUE.
+##
+## @sp 1
+## ========== Examples ==========
+## @sp 1
+## @example
+## @group
+## r = mosek(lo1, struct("skcodes", true));
+## skmap = mosek_skmap();
+## skx = skmap(double(r.sol.bas.skx) + 1);
+## @end group
+## @end example
+##
+## @seealso{mosek}
+##
+## @end deftypefn
+
+function r = mosek_skmap()
+
+  if (nargin > 0 || nargout > 1)
+    print_usage();
+  endif
+
+  old_val = page_screen_output;
+  unwind_protect
+    page_screen_output(0);
+    try
+
+      r = __mosek_skmap__();
+
+    catch
+      error(strcat(lasterr,"\n"));    % Newline prevents printing call-sequence
+    end_try_catch
+  unwind_protect_cleanup
+    page_screen_output(old_val);
+  end_unwind_protect  
+
+endfunction
@@ -0,0 +1,129 @@
+## -*- texinfo -*-
+## @deftypefn{Loadable Function} {@var{r} =} mosek_solvefile (@var{modelfile}, @var{opts} {= struct()})
+## 
+## >> Solve a model file.
+## 
+## Solves the model in a file directly, without returning the problem to 
+## Octave and passing it back to @code{mosek}. The file is read into a MOSEK 
+## task that is optimized in place, and only the solution is returned. This 
+## saves the time and memory of the round trip for large models.
+## 
+## @sp 1
+## ========== Arguments ==========
+## @sp 1
+## @multitable {..............} {..................} {...........}
+## @item modelfile 			 @tab STRING (filepath)  @tab			
+## @end multitable
+##
+## @multitable {..............} {..................} {...........}
+## @item opts                            @tab STRUCTURE          @tab (OPTIONAL)         
+## @item ..verbose                       @tab SCALAR             @tab (OPTIONAL)         
+## @item ..usesol                        @tab BOOLEAN            @tab (OPTIONAL)         
+## @item ..useparam                      @tab BOOLEAN            @tab (OPTIONAL)         
+## @item ..reader                        @tab STRING             @tab (OPTIONAL)          
+## @item ..paramprofile                  @tab STRING             @tab (OPTIONAL)          
+## @end multitable
+##
+## The @var{modelfile} should be an absolute path to a model file in any of 
+## the fileformats read by @code{mosek_read}, or a cell array of such paths. 
+## Snapshots (extension @code{.omsk}) and MPS files read by the native reader 
+## (@var{reader} is "native") are loaded into the task from their problem 
+## description, while all other files are read by MOSEK itself.
+##
+## The initial solution and parameters of the file are used unless 
+## @var{usesol} or @var{useparam} are false (default=true). A parameter 
+## profile of @code{mosek_paramprofile} can be applied with @var{paramprofile} 
+## instead. All other options of @code{mosek} are accepted for a single file.
+##
+## @multitable {..............} {...............................................} 
+## @item modelfile 			 @tab Filepath to the model
+## @end multitable
+## 
+## @multitable {..............} {...............................................} 
+## @item opts                            @tab Options 
+## @item ..verbose                       @tab Output logging verbosity 
+## @item ..usesol                        @tab Whether to use the initial solution of the file 
+## @item ..useparam                      @tab Whether to use the parameters of the file 
+## @item ..reader                        @tab Reader of MPS files ("native" or "mosek") 
+## @item ..paramprofile                  @tab Name of a parameter profile 
+## @end multitable
+##
+## @sp 1
+## ========== Value ==========
+## @sp 1
+## @multitable {...............} {..................} {...........}
+## @item r				@tab STRUCTURE		@tab 			
+## @item ..response			@tab STRUCTURE		@tab 			
+## @item ....code			@tab SCALAR		@tab 			
+## @item ....msg			@tab STRING		@tab 			
+## @item ..sol				@tab STRUCTURE		@tab			
+## @item ..results			@tab STRUCT ARRAY	@tab (MULTIPLE FILES)	
+## @item ....sol			@tab STRUCTURE		@tab			
+## @item ....response			@tab STRUCTURE		@tab			
+## @end multitable
+##
+## The result is a named list as returned by @code{mosek}, containing the 
+## response of the interface and the solution @var{sol} of the model.
+##
+## If @var{modelfile} is a cell array of paths, the files are solved in 
+## parallel with one task per file, starting the next file as soon as a solve 
+## is done and holding at most two models per processor in memory at a time. 
+## The result contains the struct array 
+## @var{results} of the same shape with the solution and response of each 
+## file in input order. Options interacting with Octave during the solve 
+## (@var{incumbent}, @var{terminate}, @var{timeslice}, @var{lazysol}, 
+## @var{outbuf}, @var{solfile}, @var{writebefore} and @var{writeafter}) are 
+## not supported in this case. Each solve uses the threads set by the 
+## parameters of its task, which can be limited through a parameter profile. 
+## A file that cannot be solved does not stop the others, so the response of 
+## each file should be checked.
+##
+## @multitable {...............} {............................................} 
+## @item r				@tab Result 
+## @item ..response			@tab Response from the interface 
+## @item ....code			@tab ID-code of response 
+## @item ....msg			@tab Human-readable message 
+## @item ..sol				@tab Solution to the model
+## @item ..results			@tab Solution and response of each file 
+## @end multitable
+##
+## @sp 1
+## ========== Examples ==========
+## @sp 1
+## @example
+## @group
+## pkg_root = pkg("list")@{strcmp(@{[pkg("list")@{:@}].name@},"octmosek")@}.dir;
+## modelfile = fullfile(pkg_root, "extdata", "milo1.opf");
+## rr = mosek_solvefile(modelfile);
+## if (rr.response.code ~= 0)
+##   error("Failed to solve model file");
+## endif
+## rr.sol.int.xx
+## @end group
+## @end example
+##
+## @seealso{mosek,mosek_read,mosek_paramprofile}
+##
+## @end deftypefn                 
+
+function r = mosek_solvefile(modelfile, opts=struct())
+
+  if (nargin < 1 || nargin > 2 || nargout > 1)
+    print_usage();
+  endif
+
+  old_val = page_screen_output;
+  unwind_protect
+    page_screen_output(0);
+    try
+  
+      r = __mosek_solvefile__(modelfile, opts);
+
+    catch
+      error(strcat(lasterr,"\n"));    % Newline prevents printing call-sequence
+    end_try_catch
+  unwind_protect_cleanup
+    page_screen_output(old_val);
+  end_unwind_protect 
+  
+endfunction
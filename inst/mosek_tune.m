@@ -0,0 +1,115 @@
+## -*- texinfo -*-
+## @deftypefn{Loadable Function} {@var{r} =} mosek_tune (@var{problem}, @var{space}, @var{opts} {= struct()})
+## 
+## >> Search parameter sets for the fastest solve of a problem.
+##
+## Solves the @var{problem} once for every combination of candidate parameter 
+## values in the search @var{space}, each on its own copy of the loaded task and 
+## using a pool of worker threads. Each copy is made when its trial starts and 
+## released when it ends, so at most @var{threads} copies are held at a time. 
+## A trial is stopped when it exceeds 
+## @var{trialtime} seconds, when the total @var{budget} of seconds is spent, or 
+## when it has run @var{killratio} times longer than the fastest finished trial. 
+## Trials not yet started when the budget is spent are skipped. Unless the 
+## problem sets the MOSEK parameter NUM_THREADS, the processors are shared 
+## evenly among the @var{threads} running trials. CTRL+C stops all trials 
+## with an error.
+##
+## The search @var{space} has the fields @var{iparam}, @var{dparam} and 
+## @var{sparam}, each a structure holding the candidate values of one parameter 
+## per field as a vector, a string or a cell array. At most @var{maxtrials} 
+## combinations are accepted. The problem description and the remaining options 
+## are those of function @code{mosek}, and parameters of the problem apply to 
+## all trials unless overwritten by the search space.
+##
+## @sp 1
+## ========== Arguments ==========
+## @sp 1
+## @multitable {..............} {..................} {...........}
+## @item problem 			 @tab STRUCTURE		@tab			
+## @item space 				 @tab STRUCTURE		@tab			
+## @item ..iparam			 @tab STRUCTURE		@tab (OPTIONAL)		
+## @item ..dparam			 @tab STRUCTURE		@tab (OPTIONAL)		
+## @item ..sparam			 @tab STRUCTURE		@tab (OPTIONAL)		
+## @item opts 				 @tab STRUCTURE		@tab (OPTIONAL)		
+## @item ..threads			 @tab SCALAR		@tab (OPTIONAL)		
+## @item ..budget			 @tab SCALAR		@tab (OPTIONAL)		
+## @item ..trialtime			 @tab SCALAR		@tab (OPTIONAL)		
+## @item ..killratio			 @tab SCALAR		@tab (OPTIONAL)		
+## @item ..maxtrials			 @tab SCALAR		@tab (OPTIONAL)		
+## @item ..profile			 @tab STRING		@tab (OPTIONAL)		
+## @end multitable
+##
+## The defaults are two threads, no budget or trial time, a kill ratio of two 
+## and at most 256 trials. If a @var{profile} name is given, the parameter set 
+## of the fastest finished trial is defined as a parameter profile (see 
+## @code{mosek_paramprofile}).
+##
+## @sp 1
+## ========== Value ==========
+## @sp 1
+##
+## @multitable {..............} {..................} {...........}
+## @item r				@tab STRUCTURE		@tab 			
+## @item ..response			@tab STRUCTURE		@tab 			
+## @item ....code			@tab SCALAR		@tab 			
+## @item ....msg			@tab STRING		@tab 			
+## @item ..trials			@tab STRUCT ARRAY	@tab 			
+## @item ....iparam			@tab STRUCTURE		@tab 			
+## @item ....dparam			@tab STRUCTURE		@tab 			
+## @item ....sparam			@tab STRUCTURE		@tab 			
+## @item ....status			@tab STRING		@tab 			
+## @item ....reason			@tab STRING		@tab 			
+## @item ....time			@tab SCALAR		@tab 			
+## @item ....response			@tab SCALAR		@tab 			
+## @item ....solsta			@tab STRING		@tab 			
+## @item ....pobj			@tab SCALAR		@tab 			
+## @item ..profile			@tab STRING		@tab (OPTIONAL)		
+## @end multitable
+##
+## The trials are ranked with the finished ones first, then by solution status 
+## (optimal or certificates before near optimal, before the rest), and then 
+## fastest first among optimal solutions and best objective first among the 
+## others. The status of a trial is "finished", "killed", "skipped" or "failed", 
+## and the reason names the limit ("trialtime", "budget" or "killratio") or 
+## "response" for a failed solve. The primal objective and solution status are taken from 
+## the integer, basic or interior-point solution, in that order of preference.
+##
+## @sp 1
+## ========== Examples ==========
+## @sp 1
+##
+## @example
+## @group
+## space.iparam = struct("OPTIMIZER", @{@{"FREE_SIMPLEX", "INTPNT"@}@});
+## space.dparam = struct("INTPNT_TOL_REL_GAP", [1e-6 1e-8]);
+## r = mosek_tune(lo1, space, struct("threads", 4, "profile", "tuned"));
+## r = mosek(lo1, struct("paramprofile", "tuned"));
+## @end group
+## @end example
+##
+## @seealso{mosek,mosek_paramprofile}
+##
+## @end deftypefn
+
+function r = mosek_tune(problem, space, opts = struct())
+
+  if (nargin < 2 || nargin > 3 || nargout > 1)
+    print_usage();
+  endif
+
+  old_val = page_screen_output;
+  unwind_protect
+    page_screen_output(0);
+    try
+
+      r = __mosek_tune__(problem, space, opts);
+
+    catch
+      error(strcat(lasterr,"\n"));    % Newline prevents printing call-sequence
+    end_try_catch
+  unwind_protect_cleanup
+    page_screen_output(old_val);
+  end_unwind_protect
+  
+endfunction
@@ -23,6 +23,8 @@
 ## @item ..verbose                       @tab SCALAR             @tab (OPTIONAL)         
 ## @item ..usesol                        @tab BOOLEAN            @tab (OPTIONAL)         
 ## @item ..useparam                      @tab BOOLEAN            @tab (OPTIONAL)         
+## @item ..format                        @tab STRING             @tab (OPTIONAL)         
+## @item ..writer                        @tab STRING             @tab (OPTIONAL)         
 ## @item ..writebefore                   @tab STRING (filepath)  @tab (OPTIONAL)         
 ## @item ..writeafter                    @tab STRING (filepath)  @tab (OPTIONAL)         
 ## @end multitable
@@ -32,7 +34,31 @@
 ##
 ## The @var{modelfile} should be an absolute path to the model file. If the 
 ## file extension is @code{.opf}, the model will be written in the Optimization 
-## Problem Format. Other formats include lp, mps and mbt.
+## Problem Format. Other formats include lp, mps and mbt. The model file is 
+## compressed if the extension of the format is followed by @code{.gz} (gzip) 
+## or @code{.zst} (zstd, e.g. @code{model.mps.zst}). Zstd files are compressed 
+## on a background thread while MOSEK writes the model, and require OctMOSEK to 
+## be built with zstd support on a UNIX-alike platform. The extension 
+## @code{.omsk} selects a binary snapshot of the problem description, which is 
+## written without loading the problem into MOSEK and can be read back quickly 
+## by @code{mosek_read}. A snapshot stores the parameters and initial solution 
+## of the problem description (not the full list of parameter settings).
+##
+## If the option @var{format} is given (one of "mps", "lp", "opf", "mbt" or 
+## "xml"), the @var{modelfile} should be empty, and the model is returned as 
+## the uint8 vector @var{data} of the result. It is streamed from MOSEK through 
+## a pipe without touching the disk, which is only available on UNIX-alike 
+## platforms. Use @code{char(r.data)} to obtain the text formats as a string.
+##
+## If the option @var{writer} is "native" (default="mosek"), MPS, LP and OPF 
+## files are written by the interface straight from the problem description 
+## without loading it into MOSEK, formatting the constraint matrix on all 
+## processors and appending it to the file in pieces. Rows, columns and cones 
+## are named R1, C1 and K1 onwards, and parameters and initial solutions are 
+## not written. LP and OPF files list the constraints row by row, so a 
+## transposed copy of the constraint matrix is held while writing, and the LP 
+## format can not hold cones. Compressed files are not supported by this 
+## writer.
 ##
 ## The amount of information printed by the interface can be limited by 
 ## @var{verbose} (default=10). Whether to write the initial solution, if one 
@@ -54,6 +80,8 @@
 ## @item ..verbose                       @tab Output logging verbosity 
 ## @item ..usesol                        @tab Whether to use the initial solution 
 ## @item ..useparam                      @tab Whether to use the specified parameter settings 
+## @item ..format                        @tab Format of a model returned in memory 
+## @item ..writer                        @tab Writer of model files ("mosek" or "native") 
 ## @item ..writebefore                   @tab Filepath used to export model 
 ## @item ..writeafter                    @tab Filepath used to export model and solution 
 ## @end multitable
@@ -67,17 +95,20 @@
 ## @item ..response			@tab STRUCTURE		@tab 			
 ## @item ....code			@tab SCALAR		@tab 			
 ## @item ....msg			@tab STRING		@tab 			
+## @item ..data			@tab UINT8 VECTOR	@tab (FORMAT)		
 ## @end multitable
 ##
 ## The result is a named list containing the response of the MOSEK optimization 
 ## library when writing to the model file. A response code of zero is the signal
-## of success.
+## of success. On success with the option @var{format}, the result contains the 
+## model in @var{data}.
 ##
 ## @multitable {..............} {............................................} 
 ## @item r				@tab Result 
 ## @item ..response			@tab Response from the MOSEK optimization library 
 ## @item ....code			@tab ID-code of response 
 ## @item ....msg			@tab Human-readable message 
+## @item ..data			@tab Model in the given format 
 ## @end multitable
 ##
 ## @sp 1
@@ -103,7 +134,7 @@
 ## @end group
 ## @end example
 ##
-## @seealso{mosek,mosek_read}
+## @seealso{mosek,mosek_read,mosek_convert}
 ##
 ## @end deftypefn                              
 
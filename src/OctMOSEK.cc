@@ -36,14 +36,21 @@
 #include "omsk_utils_interface.h"
 #include "omsk_obj_arguments.h"
 #include "omsk_obj_mosek.h"
+#include "omsk_utils_mosek.h"
+#include "omsk_obj_tuning.h"
+#include "omsk_utils_snapshot.h"
+#include "omsk_utils_solfile.h"
+#include "omsk_obj_lazy.h"
 
 #include <octave/oct.h>
 #include <octave/ov-struct.h>
 
 #include <string>
+#include <vector>
 #include <exception>
 
 using std::string;
+using std::vector;
 using std::exception;
 
 
@@ -64,10 +71,14 @@ INTERNAL FUNCTION: __mosek__ 								\n\
 		reset_global_variables();
 		printdebug("Function 'mosek' was called");
 
-		// Validate input arguments
+		// Validate input arguments (a lazy problem of mosek_read is not materialized)
 		Octave_map arg0;
+		const octave_mosek_problem *lazyprob = NULL;
 		if (!args.empty()) {
-			arg0 = args(0).map_value();
+			lazyprob = dynamic_cast<const octave_mosek_problem*>(&args(0).get_rep());
+			if (lazyprob == NULL) {
+				arg0 = args(0).map_value();
+			}
 			if (error_state) {
 				throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
 			}
@@ -83,14 +94,28 @@ INTERNAL FUNCTION: __mosek__ 								\n\
 		// Read input arguments: problem and options
 		problem_type probin;
 		probin.options.OCT_read(arg1);
-		probin.OCT_read(arg0);
 
-		// Create task and load problem into MOSEK
 		Task_handle task;
-		probin.MOSEK_write(task);
+		if (lazyprob != NULL) {
+			// Copy the task of the lazy problem, and optimize it as it is
+			// (apart from the parameter profile, otherwise set by MOSEK_write)
+			lazyprob->getshared()->copy(task);
+			if (!probin.options.paramprofile.empty()) {
+				global_profiles.get(probin.options.paramprofile).apply(task);
+			}
 
-		// Solve the problem
-		msk_solve(ret_val, task, probin.options);
+		} else {
+			probin.OCT_read(arg0);
+
+			// Create task and load problem into MOSEK
+			probin.MOSEK_write(task);
+		}
+
+		// Solve the problem (keeping the task if it can be resumed)
+		if (msk_solve(ret_val, task, probin.options)) {
+			int token = global_registry.adopt(task, true);
+			ret_val.assign("resume", octave_value(static_cast<double>(token)));
+		}
 
 		// Print warning summary
 		if (mosek_interface_warnings > 0) {
@@ -112,6 +137,222 @@ INTERNAL FUNCTION: __mosek__ 								\n\
 }
 
 
+DEFUN_DLD (__mosek_resume__, args, nargout, "\
+r = mosek_resume(token, opts)                               \n\
+------------------------------------------------------------\n\
+The use of internal functions is not encouraged.            \n\
+INTERNAL FUNCTION: __mosek_resume__                         \n\
+") {
+	const string ARGNAMES[] = {"token","options"};
+	const string ARGTYPES[] = {"scalar","struct"};
+
+	// Create structure for returned data
+	Octave_map ret_val;
+	int token = 0;
+	bool solving = false;
+
+	try {
+		// Start the program
+		reset_global_variables();
+		printdebug("Function 'mosek_resume' was called");
+
+		// Validate input arguments
+		if (!args.empty()) {
+			double arg0 = args(0).scalar_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+			}
+			token = scalar2int(arg0);
+		}
+		Octave_map arg1;
+		if (args.length()-1 >= 1) {
+			arg1 = args(1).map_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[1] + " should be a " + ARGTYPES[1] + ".");
+			}
+		}
+
+		// Read input arguments: options
+		options_type options;
+		options.OCT_read(arg1);
+
+		// Look up the parameter profile before touching the suspended task,
+		// such that bad options leave it resumable
+		const Parameter_profile *profile = NULL;
+		if (!options.paramprofile.empty()) {
+			profile = &global_profiles.get(options.paramprofile);
+		}
+
+		// Continue the solve on the suspended task (releasing it when done),
+		// where the tasks of lazy values are not accepted
+		Task_handle &task = global_registry.getresumable(token);
+		if (profile != NULL) {
+			profile->apply(task);
+		}
+
+		solving = true;
+		if (msk_solve(ret_val, task, options)) {
+			ret_val.assign("resume", octave_value(static_cast<double>(token)));
+		} else {
+			global_registry.release(token);
+		}
+
+		// Print warning summary
+		if (mosek_interface_warnings > 0) {
+			printoutput("The Octave-to-MOSEK interface completed with " + tostring(mosek_interface_warnings) + " warning(s)\n\n", typeWARNING);
+		}
+
+	} catch (msk_exception const& e) {
+		if (solving)
+			global_registry.release(token);
+		terminate_unsuccessfully(ret_val, e);
+		return octave_value(ret_val);
+
+	} catch (exception const& e) {
+		if (solving)
+			global_registry.release(token);
+		terminate_unsuccessfully(ret_val, e.what());
+		return octave_value(ret_val);
+	}
+
+	// Clean allocations and exit (msk_solve adds response)
+	terminate_successfully(ret_val);
+	return octave_value(ret_val);
+}
+
+
+DEFUN_DLD (__mosek_paramprofile__, args, nargout, "\
+r = mosek_paramprofile(name, iparam, dparam, sparam)        \n\
+------------------------------------------------------------\n\
+The use of internal functions is not encouraged.            \n\
+INTERNAL FUNCTION: __mosek_paramprofile__                   \n\
+") {
+	const string ARGNAMES[] = {"name","iparam","dparam","sparam"};
+	const string ARGTYPES[] = {"string","struct","struct","struct"};
+
+	// Create structure for returned data
+	Octave_map ret_val;
+
+	try {
+		// Start the program
+		reset_global_variables();
+		printdebug("Function 'mosek_paramprofile' was called");
+
+		// Validate input arguments
+		string arg0;
+		if (!args.empty()) {
+			arg0 = args(0).string_value();
+			if (error_state || arg0.empty()) {
+				throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+			}
+		}
+		Octave_map argparam[3];
+		for (int i = 1; i <= 3 && i < args.length(); ++i) {
+			argparam[i-1] = args(i).map_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[i] + " should be a " + ARGTYPES[i] + ".");
+			}
+		}
+
+		// Without parameters the profile is removed
+		if (args.length() <= 1) {
+			global_profiles.remove(arg0);
+
+		} else {
+			// Parameter names are validated on a task
+			global_env.init();
+			Task_handle task;
+			task.init(global_env, 0, 0);
+
+			Parameter_profile profile;
+			compile_parameters(task, argparam[0], argparam[1], argparam[2], profile);
+			printdebug("Compiled " + tostring(profile.size()) + " parameter(s) into profile '" + arg0 + "'");
+
+			global_profiles.define(arg0, profile);
+		}
+
+		// Add the response code
+		msk_addresponse(ret_val, get_msk_response(MSK_RES_OK), false);
+
+	} catch (msk_exception const& e) {
+		terminate_unsuccessfully(ret_val, e);
+		return octave_value(ret_val);
+
+	} catch (exception const& e) {
+		terminate_unsuccessfully(ret_val, e.what());
+		return octave_value(ret_val);
+	}
+
+	// Clean allocations and exit
+	terminate_successfully(ret_val);
+	return octave_value(ret_val);
+}
+
+
+DEFUN_DLD (__mosek_tune__, args, nargout, "\
+r = mosek_tune(problem, space, opts)                        \n\
+------------------------------------------------------------\n\
+The use of internal functions is not encouraged.            \n\
+INTERNAL FUNCTION: __mosek_tune__                           \n\
+") {
+	const string ARGNAMES[] = {"problem","space","options"};
+	const string ARGTYPES[] = {"struct","struct","struct"};
+
+	// Create structure for returned data
+	Octave_map ret_val;
+
+	try {
+		// Start the program
+		reset_global_variables();
+		printdebug("Function 'mosek_tune' was called");
+
+		// Validate input arguments
+		Octave_map argmap[3];
+		for (int i = 0; i < 3 && i < args.length(); ++i) {
+			argmap[i] = args(i).map_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[i] + " should be a " + ARGTYPES[i] + ".");
+			}
+		}
+
+		// Read input arguments: tuning settings, problem and options
+		tuning_type tuning;
+		tuning.OCT_read(argmap[2]);
+
+		problem_type probin;
+		probin.options.OCT_read(argmap[2]);
+		probin.OCT_read(argmap[0]);
+
+		// Create task and load problem into MOSEK
+		Task_handle task;
+		probin.MOSEK_write(task);
+
+		// Solve the problem with each parameter set in the search space
+		msk_tune(ret_val, task, argmap[1], tuning);
+
+		// Add the response code
+		msk_addresponse(ret_val, get_msk_response(MSK_RES_OK), false);
+
+		// Print warning summary
+		if (mosek_interface_warnings > 0) {
+			printoutput("The Octave-to-MOSEK interface completed with " + tostring(mosek_interface_warnings) + " warning(s)\n\n", typeWARNING);
+		}
+
+	} catch (msk_exception const& e) {
+		terminate_unsuccessfully(ret_val, e);
+		return octave_value(ret_val);
+
+	} catch (exception const& e) {
+		terminate_unsuccessfully(ret_val, e.what());
+		return octave_value(ret_val);
+	}
+
+	// Clean allocations and exit
+	terminate_successfully(ret_val);
+	return octave_value(ret_val);
+}
+
+
 DEFUN_DLD (__mosek_clean__, args, nargout, "\
 mosek_clean()                                               \n\
 ------------------------------------------------------------\n\
@@ -122,8 +363,10 @@ INTERNAL FUNCTION: __mosek_clean__                          \n\
 	reset_global_variables();
 	mosek_interface_verbose = typeINFO;
 
-	// Clean global resources and release the MOSEK environment
+	// Clean global resources, release suspended tasks, parameter profiles and the MOSEK environment
 	reset_global_ressources();
+	global_registry.clear();
+	global_profiles.clear();
 	global_env.~Env_handle();
 
 	return empty_octave_value;
@@ -145,14 +388,50 @@ INTERNAL FUNCTION: __mosek_version__                        \n\
 }
 
 
+DEFUN_DLD (__mosek_skmap__, args, nargout, "\
+r = mosek_skmap()                                           \n\
+------------------------------------------------------------\n\
+The use of internal functions is not encouraged.            \n\
+INTERNAL FUNCTION: __mosek_skmap__                          \n\
+") {
+	// Create structure for returned data
+	Cell ret_val;
+
+	try {
+		// Start the program
+		reset_global_variables();
+		mosek_interface_verbose = typeINFO;
+		printdebug("Function 'mosek_skmap' was called");
+
+		// The names of status keys are provided by a task
+		global_env.init();
+		Task_handle task;
+		task.init(global_env, 0, 0);
+
+		get_stakeymap(ret_val, task);
+
+	} catch (msk_exception const& e) {
+		printerror( e.what() );
+		ret_val = Cell();
+
+	} catch (exception const& e) {
+		printerror( e.what() );
+		ret_val = Cell();
+	}
+
+	reset_global_ressources();
+	return octave_value(ret_val);
+}
+
+
 DEFUN_DLD (__mosek_read__, args, nargout, "\
-r = mosek_read(filepath, opts)                              \n\
+r = mosek_read(filepath(s), opts)                           \n\
 ------------------------------------------------------------\n\
 The use of internal functions is not encouraged.            \n\
 INTERNAL FUNCTION: __mosek_read__                           \n\
 ") {
 	const string ARGNAMES[] = {"filepath","options"};
-	const string ARGTYPES[] = {"string","struct"};
+	const string ARGTYPES[] = {"string, cell array of strings or uint8 array","struct"};
 
 	// Create structure for returned data
 	Octave_map ret_val;
@@ -164,7 +443,28 @@ INTERNAL FUNCTION: __mosek_read__                           \n\
 
 		// Validate input arguments
 		string arg0;
-		if (!args.empty()) {
+		vector<string> arg0list;
+		dim_vector arg0dims;
+		vector<char> arg0data;
+		bool multiple = (!args.empty() && args(0).is_cell());
+		bool inmemory = (!args.empty() && args(0).is_uint8_type());
+		if (inmemory) {
+			uint8NDArray bytes = args(0).uint8_array_value();
+			const octave_uint8 *pbytes = bytes.data();
+			arg0data.resize(bytes.nelem());
+			for (octave_idx_type i = 0; i < bytes.nelem(); ++i)
+				arg0data[i] = static_cast<char>(pbytes[i].value());
+
+		} else if (multiple) {
+			Cell paths = args(0).cell_value();
+			arg0dims = paths.dims();
+			for (octave_idx_type i = 0; i < paths.nelem(); ++i) {
+				arg0list.push_back(paths(i).string_value());
+				if (error_state) {
+					throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+				}
+			}
+		} else if (!args.empty()) {
 			arg0 = args(0).string_value();
 			if (error_state) {
 				throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
@@ -189,17 +489,66 @@ INTERNAL FUNCTION: __mosek_read__                           \n\
 		probin.options = default_opts;
 		probin.options.OCT_read(arg1);
 
-		// Create task and load filepath-model into MOSEK
-		Task_handle task;
-		msk_loadproblemfile(task, arg0, probin.options);
+		// With a format, the model itself is given as uint8 bytes instead of a filepath
+		if (!probin.options.format.empty() && !inmemory) {
+			throw msk_exception("Option '" + options_type::OCT_ARGS.format + "' requires the model as a uint8 array (e.g. uint8(str)), not a filepath or cell array");
+		}
+		if (inmemory && probin.options.format.empty()) {
+			throw msk_exception("Option '" + options_type::OCT_ARGS.format + "' is required when the model is given in memory");
+		}
+
+		if (probin.options.lazyprob && (multiple || (!inmemory && (is_snapshotfile(arg0) || probin.options.reader == "native")))) {
+			throw msk_exception("Option '" + options_type::OCT_ARGS.lazyprob + "' requires a single model read by MOSEK");
+		}
+
+		if (multiple) {
+			// Read the problems of all files (parsed in parallel)
+			msk_loadproblemfiles(ret_val, arg0list, arg0dims, probin.options);
+
+		} else if (probin.options.lazyprob) {
+			// Create task and load the model into MOSEK
+			Task_handle task;
+			if (inmemory)
+				msk_loadproblembuffer(task, arg0data, probin.options);
+			else
+				msk_loadproblemfile(task, arg0, probin.options);
+
+			// Hand the task over to a lazy problem (items are fetched when indexed)
+			Task_shared *shared = Task_shared::adopt(task);
+			octave_mosek_problem::register_once();
+			ret_val.assign("prob", octave_value(new octave_mosek_problem(shared, probin.options)));
+
+		} else {
+			if (inmemory) {
+				// Create task and load the in-memory model into MOSEK
+				Task_handle task;
+				msk_loadproblembuffer(task, arg0data, probin.options);
 
-		// Read the problem from MOSEK
-		probin.MOSEK_read(task);
+				// Read the problem from MOSEK
+				probin.MOSEK_read(task);
 
-		// Write the problem to Octave
-		Octave_map prob_val;
-		probin.OCT_write(prob_val);
-		ret_val.assign("prob", octave_value(prob_val));
+			} else if (is_snapshotfile(arg0)) {
+				// Read the problem from a snapshot (no task is needed)
+				probin.SNAPSHOT_read(arg0);
+
+			} else if (probin.options.reader == "native") {
+				// Read the problem with the native reader (no task is needed)
+				probin.NATIVE_read(arg0);
+
+			} else {
+				// Create task and load filepath-model into MOSEK
+				Task_handle task;
+				msk_loadproblemfile(task, arg0, probin.options);
+
+				// Read the problem from MOSEK
+				probin.MOSEK_read(task);
+			}
+
+			// Write the problem to Octave
+			Octave_map prob_val;
+			probin.OCT_write(prob_val);
+			ret_val.assign("prob", octave_value(prob_val));
+		}
 
 		// Add the response code
 		msk_addresponse(ret_val, get_msk_response(MSK_RES_OK), false);
@@ -224,6 +573,174 @@ INTERNAL FUNCTION: __mosek_read__                           \n\
 }
 
 
+DEFUN_DLD (__mosek_inspect__, args, nargout, "\
+r = mosek_inspect(filepath(s), opts)                        \n\
+------------------------------------------------------------\n\
+The use of internal functions is not encouraged.            \n\
+INTERNAL FUNCTION: __mosek_inspect__                        \n\
+") {
+	const string ARGNAMES[] = {"filepath","options"};
+	const string ARGTYPES[] = {"string or cell array of strings","struct"};
+
+	// Create structure for returned data
+	Octave_map ret_val;
+
+	try {
+		// Start the program
+		reset_global_variables();
+		printdebug("Function 'mosek_inspect' was called");
+
+		// Validate input arguments
+		vector<string> arg0list;
+		dim_vector arg0dims(1, 1);
+		bool multiple = (!args.empty() && args(0).is_cell());
+		if (multiple) {
+			Cell paths = args(0).cell_value();
+			arg0dims = paths.dims();
+			for (octave_idx_type i = 0; i < paths.nelem(); ++i) {
+				arg0list.push_back(paths(i).string_value());
+				if (error_state) {
+					throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+				}
+			}
+		} else if (!args.empty()) {
+			arg0list.push_back(args(0).string_value());
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+			}
+		}
+		Octave_map arg1;
+		if (args.length()-1 >= 1) {
+			arg1 = args(1).map_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[1] + " should be a " + ARGTYPES[1] + ".");
+			}
+		}
+
+		// Define new default values for options
+		options_type default_opts; {
+			default_opts.useparam = false;
+			default_opts.usesol = false;
+			default_opts.reader = "native";
+		}
+
+		// Read input arguments: options (with modified defaults)
+		options_type options = default_opts;
+		options.OCT_read(arg1);
+
+		// Summarize the model files (in parallel if several)
+		msk_inspectfiles(ret_val, arg0list, arg0dims, multiple, options);
+
+		// Add the response code
+		msk_addresponse(ret_val, get_msk_response(MSK_RES_OK), false);
+
+		// Print warning summary
+		if (mosek_interface_warnings > 0) {
+			printoutput("The Octave-to-MOSEK interface completed with " + tostring(mosek_interface_warnings) + " warning(s)\n", typeWARNING);
+		}
+
+	} catch (msk_exception const& e) {
+		terminate_unsuccessfully(ret_val, e);
+		return octave_value(ret_val);
+
+	} catch (exception const& e) {
+		terminate_unsuccessfully(ret_val, e.what());
+		return octave_value(ret_val);
+	}
+
+	// Clean allocations, add response and exit
+	terminate_successfully(ret_val);
+	return octave_value(ret_val);
+}
+
+
+DEFUN_DLD (__mosek_solvefile__, args, nargout, "\
+r = mosek_solvefile(filepath(s), opts)                      \n\
+------------------------------------------------------------\n\
+The use of internal functions is not encouraged.            \n\
+INTERNAL FUNCTION: __mosek_solvefile__                      \n\
+") {
+	const string ARGNAMES[] = {"filepath","options"};
+	const string ARGTYPES[] = {"string or cell array of strings","struct"};
+
+	// Create structure for returned data
+	Octave_map ret_val;
+
+	try {
+		// Start the program
+		reset_global_variables();
+		printdebug("Function 'mosek_solvefile' was called");
+
+		// Validate input arguments
+		vector<string> arg0list;
+		dim_vector arg0dims(1, 1);
+		bool multiple = (!args.empty() && args(0).is_cell());
+		if (multiple) {
+			Cell paths = args(0).cell_value();
+			arg0dims = paths.dims();
+			for (octave_idx_type i = 0; i < paths.nelem(); ++i) {
+				arg0list.push_back(paths(i).string_value());
+				if (error_state) {
+					throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+				}
+			}
+		} else if (!args.empty()) {
+			arg0list.push_back(args(0).string_value());
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+			}
+		}
+		Octave_map arg1;
+		if (args.length()-1 >= 1) {
+			arg1 = args(1).map_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[1] + " should be a " + ARGTYPES[1] + ".");
+			}
+		}
+
+		// Read input arguments: options
+		options_type options;
+		options.OCT_read(arg1);
+
+		if (multiple) {
+			// Solve the model files in parallel
+			msk_solvefiles(ret_val, arg0list, arg0dims, options);
+
+			// Add the response code
+			msk_addresponse(ret_val, get_msk_response(MSK_RES_OK), false);
+
+		} else {
+			// Load the model file straight into a task
+			Task_handle task;
+			msk_loadsolvefile(task, arg0list.at(0), options);
+
+			// Solve the problem (keeping the task if it can be resumed)
+			if (msk_solve(ret_val, task, options)) {
+				int token = global_registry.adopt(task, true);
+				ret_val.assign("resume", octave_value(static_cast<double>(token)));
+			}
+		}
+
+		// Print warning summary
+		if (mosek_interface_warnings > 0) {
+			printoutput("The Octave-to-MOSEK interface completed with " + tostring(mosek_interface_warnings) + " warning(s)\n\n", typeWARNING);
+		}
+
+	} catch (msk_exception const& e) {
+		terminate_unsuccessfully(ret_val, e);
+		return octave_value(ret_val);
+
+	} catch (exception const& e) {
+		terminate_unsuccessfully(ret_val, e.what());
+		return octave_value(ret_val);
+	}
+
+	// Clean allocations and exit (msk_solve adds response when solving a single file)
+	terminate_successfully(ret_val);
+	return octave_value(ret_val);
+}
+
+
 DEFUN_DLD (__mosek_write__, args, nargout, "\
 r = mosek_write(problem, filepath, opts)                    \n\
 ------------------------------------------------------------\n\
@@ -276,12 +793,45 @@ INTERNAL FUNCTION: __mosek_write__                          \n\
 		probin.options.OCT_read(arg2);
 		probin.OCT_read(arg0);
 
-		// Create task and load problem into MOSEK
-		Task_handle task;
-		probin.MOSEK_write(task);
+		if (!probin.options.format.empty()) {
+			if (!arg1.empty()) {
+				throw msk_exception("Input argument " + ARGNAMES[1] + " should be empty when option '" + options_type::OCT_ARGS.format + "' is given");
+			}
+			if (probin.options.writer == "native") {
+				throw msk_exception("Option '" + options_type::OCT_ARGS.writer + "' should be 'mosek' when option '" + options_type::OCT_ARGS.format + "' is given");
+			}
+
+			// Create task and load problem into MOSEK
+			Task_handle task;
+			probin.MOSEK_write(task);
+
+			// Write the loaded problem to memory, and return it as bytes
+			vector<char> data;
+			msk_saveproblembuffer(task, data, probin.options);
+
+			uint8NDArray bytes(dim_vector(1, static_cast<octave_idx_type>(data.size())));
+			octave_uint8 *pbytes = bytes.fortran_vec();
+			for (size_t i = 0; i < data.size(); ++i)
+				pbytes[i] = octave_uint8(static_cast<unsigned char>(data[i]));
+
+			ret_val.assign("data", octave_value(bytes));
+
+		} else if (is_snapshotfile(arg1)) {
+			// Write the problem to a snapshot (no task is needed)
+			probin.SNAPSHOT_write(arg1);
+
+		} else if (probin.options.writer == "native") {
+			// Write the problem with the native writer (no task is needed)
+			probin.NATIVE_write(arg1);
 
-		// Write the loaded problem to a file
-		msk_saveproblemfile(task, arg1, probin.options);
+		} else {
+			// Create task and load problem into MOSEK
+			Task_handle task;
+			probin.MOSEK_write(task);
+
+			// Write the loaded problem to a file
+			msk_saveproblemfile(task, arg1, probin.options);
+		}
 
 		// Add the response code
 		msk_addresponse(ret_val, get_msk_response(MSK_RES_OK), false);
@@ -304,3 +854,241 @@ INTERNAL FUNCTION: __mosek_write__                          \n\
 	terminate_successfully(ret_val);
 	return octave_value(ret_val);
 }
+
+
+DEFUN_DLD (__mosek_convert__, args, nargout, "\
+r = mosek_convert(inputs, outputs, opts)                    \n\
+------------------------------------------------------------\n\
+The use of internal functions is not encouraged.            \n\
+INTERNAL FUNCTION: __mosek_convert__                        \n\
+") {
+	const string ARGNAMES[] = {"inputs","outputs","options"};
+	const string ARGTYPES[] = {"string or cell array of strings","string or cell array of strings","struct"};
+
+	// Create structure for returned data
+	Octave_map ret_val;
+
+	try {
+		// Start the program
+		reset_global_variables();
+		printdebug("Function 'mosek_convert' was called");
+
+		// Validate input arguments
+		vector<string> arg0list;
+		dim_vector arg0dims(1, 1);
+		bool multiple = (!args.empty() && args(0).is_cell());
+		if (multiple) {
+			Cell paths = args(0).cell_value();
+			arg0dims = paths.dims();
+			for (octave_idx_type i = 0; i < paths.nelem(); ++i) {
+				arg0list.push_back(paths(i).string_value());
+				if (error_state) {
+					throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+				}
+			}
+		} else if (!args.empty()) {
+			arg0list.push_back(args(0).string_value());
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+			}
+		}
+		vector<string> arg1list;
+		if (args.length()-1 >= 1) {
+			if (args(1).is_cell() != multiple) {
+				throw msk_exception("Input arguments " + ARGNAMES[0] + " and " + ARGNAMES[1] + " should both be strings or both be cell arrays.");
+			}
+			if (multiple) {
+				Cell paths = args(1).cell_value();
+				for (octave_idx_type i = 0; i < paths.nelem(); ++i) {
+					arg1list.push_back(paths(i).string_value());
+					if (error_state) {
+						throw msk_exception("Input argument " + ARGNAMES[1] + " should be a " + ARGTYPES[1] + ".");
+					}
+				}
+			} else {
+				arg1list.push_back(args(1).string_value());
+				if (error_state) {
+					throw msk_exception("Input argument " + ARGNAMES[1] + " should be a " + ARGTYPES[1] + ".");
+				}
+			}
+		}
+		Octave_map arg2;
+		if (args.length()-1 >= 2) {
+			arg2 = args(2).map_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[2] + " should be a " + ARGTYPES[2] + ".");
+			}
+		}
+
+		// Define new default values for options
+		options_type default_opts; {
+			default_opts.useparam = false;
+			default_opts.usesol = false;
+		}
+
+		// Read input arguments: options (with modified defaults)
+		options_type options = default_opts;
+		options.OCT_read(arg2);
+
+		// Convert the model files (in parallel if several)
+		msk_convertfiles(ret_val, arg0list, arg1list, arg0dims, multiple, options);
+
+		// Add the response code
+		msk_addresponse(ret_val, get_msk_response(MSK_RES_OK), false);
+
+		// Print warning summary
+		if (mosek_interface_warnings > 0) {
+			printoutput("The Octave-to-MOSEK interface completed with " + tostring(mosek_interface_warnings) + " warning(s)\n", typeWARNING);
+		}
+
+	} catch (msk_exception const& e) {
+		terminate_unsuccessfully(ret_val, e);
+		return octave_value(ret_val);
+
+	} catch (exception const& e) {
+		terminate_unsuccessfully(ret_val, e.what());
+		return octave_value(ret_val);
+	}
+
+	// Clean allocations, add response and exit
+	terminate_successfully(ret_val);
+	return octave_value(ret_val);
+}
+
+
+DEFUN_DLD (__mosek_savesol__, args, nargout, "\
+r = mosek_savesol(filepath, sol)                            \n\
+------------------------------------------------------------\n\
+The use of internal functions is not encouraged.            \n\
+INTERNAL FUNCTION: __mosek_savesol__                        \n\
+") {
+	const string ARGNAMES[] = {"filepath","solution"};
+	const string ARGTYPES[] = {"string","struct"};
+
+	// Create structure for returned data
+	Octave_map ret_val;
+
+	try {
+		// Start the program
+		reset_global_variables();
+		printdebug("Function 'mosek_savesol' was called");
+
+		// Validate input arguments
+		string arg0;
+		if (!args.empty()) {
+			arg0 = args(0).string_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+			}
+		}
+		octave_value arg1;
+		if (args.length()-1 >= 1) {
+			arg1 = args(1);
+		}
+
+		// Make sure the environment is initialized
+		global_env.init();
+
+		const octave_mosek_solution *lazysol = dynamic_cast<const octave_mosek_solution*>(&arg1.get_rep());
+		if (lazysol != NULL && lazysol->getsoltype().empty()) {
+			// Write a lazy solution straight from its task
+			Task_shared *shared = lazysol->getshared();
+			options_type options;
+			options.soltypes = shared->soltypes;
+			options.solitems = shared->solitems;
+
+			Octave_map solvec;
+			msk_writesolfile(arg0, shared->get(), options, solvec);
+
+		} else {
+			Octave_map solvec = arg1.map_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[1] + " should be a " + ARGTYPES[1] + ".");
+			}
+
+			// The names of status keys are translated by a task
+			Task_handle task;
+			task.init(global_env, 0, 0);
+			msk_savesolfile(arg0, task, solvec);
+		}
+
+		// Add the response code
+		msk_addresponse(ret_val, get_msk_response(MSK_RES_OK), false);
+
+	} catch (msk_exception const& e) {
+		terminate_unsuccessfully(ret_val, e);
+		return octave_value(ret_val);
+
+	} catch (exception const& e) {
+		terminate_unsuccessfully(ret_val, e.what());
+		return octave_value(ret_val);
+	}
+
+	// Clean allocations, add response and exit
+	terminate_successfully(ret_val);
+	return octave_value(ret_val);
+}
+
+
+DEFUN_DLD (__mosek_loadsol__, args, nargout, "\
+r = mosek_loadsol(filepath, opts)                           \n\
+------------------------------------------------------------\n\
+The use of internal functions is not encouraged.            \n\
+INTERNAL FUNCTION: __mosek_loadsol__                        \n\
+") {
+	const string ARGNAMES[] = {"filepath","options"};
+	const string ARGTYPES[] = {"string","struct"};
+
+	// Create structure for returned data
+	Octave_map ret_val;
+
+	try {
+		// Start the program
+		reset_global_variables();
+		printdebug("Function 'mosek_loadsol' was called");
+
+		// Validate input arguments
+		string arg0;
+		if (!args.empty()) {
+			arg0 = args(0).string_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[0] + " should be a " + ARGTYPES[0] + ".");
+			}
+		}
+		Octave_map arg1;
+		if (args.length()-1 >= 1) {
+			arg1 = args(1).map_value();
+			if (error_state) {
+				throw msk_exception("Input argument " + ARGNAMES[1] + " should be a " + ARGTYPES[1] + ".");
+			}
+		}
+
+		// Read input arguments: options
+		options_type options;
+		options.OCT_read(arg1);
+
+		// The names of status keys are translated by a task
+		global_env.init();
+		Task_handle task;
+		task.init(global_env, 0, 0);
+
+		Octave_map sol_val;
+		msk_loadsolfile(arg0, task, options.skcodes, sol_val);
+		ret_val.assign("sol", octave_value(sol_val));
+
+		// Add the response code
+		msk_addresponse(ret_val, get_msk_response(MSK_RES_OK), false);
+
+	} catch (msk_exception const& e) {
+		terminate_unsuccessfully(ret_val, e);
+		return octave_value(ret_val);
+
+	} catch (exception const& e) {
+		terminate_unsuccessfully(ret_val, e.what());
+		return octave_value(ret_val);
+	}
+
+	// Clean allocations, add response and exit
+	terminate_successfully(ret_val);
+	return octave_value(ret_val);
+}
@@ -2,10 +2,24 @@
 
 #include "omsk_utils_octave.h"
 #include "omsk_utils_mosek.h"
+#include "omsk_utils_snapshot.h"
+#include "omsk_utils_solfile.h"
+#include "omsk_utils_mpsfile.h"
+#include "omsk_utils_compress.h"
+#include "omsk_utils_threads.h"
 
 #include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
 
 using std::string;
+using std::vector;
 
 // ------------------------------
 // Class options_type
@@ -21,7 +35,24 @@ options_type::options_type() :
 	usesol(true),
 	verbose(10),
 	writebefore(""),
-	writeafter("")
+	writeafter(""),
+	incumbent(incumbent_type()),
+	terminate(termination_type()),
+	timeslice(NAN),
+	skcodes(false),
+	soltypes(),
+	solitems(),
+	lazysol(false),
+	lazyprob(false),
+	outbuf(),
+	outcol(1),
+	solfile(""),
+	sparseitems(),
+	paramprofile(""),
+	nondefault(false),
+	reader("mosek"),
+	format(""),
+	writer("mosek")
 {}
 
 void options_type::OCT_read(Octave_map &arglist) {
@@ -37,6 +68,83 @@ void options_type::OCT_read(Octave_map &arglist) {
 	map_seek_Boolean(&usesol, arglist, OCT_ARGS.usesol, true);
 	map_seek_String(&writebefore, arglist, OCT_ARGS.writebefore, true);
 	map_seek_String(&writeafter, arglist, OCT_ARGS.writeafter, true);
+	map_seek_Scalar(&timeslice, arglist, OCT_ARGS.timeslice, true);
+	map_seek_Boolean(&skcodes, arglist, OCT_ARGS.skcodes, true);
+	map_seek_Boolean(&lazysol, arglist, OCT_ARGS.lazysol, true);
+	map_seek_Boolean(&lazyprob, arglist, OCT_ARGS.lazyprob, true);
+	map_seek_String(&paramprofile, arglist, OCT_ARGS.paramprofile, true);
+	map_seek_Boolean(&nondefault, arglist, OCT_ARGS.nondefault, true);
+
+	// Read the choice of model file reader
+	map_seek_String(&reader, arglist, OCT_ARGS.reader, true);
+	if (reader != "mosek" && reader != "native")
+		throw msk_exception("Argument '" + OCT_ARGS.reader + "' should be either 'mosek' or 'native'");
+
+	// Read the choice of model file writer
+	map_seek_String(&writer, arglist, OCT_ARGS.writer, true);
+	if (writer != "mosek" && writer != "native")
+		throw msk_exception("Argument '" + OCT_ARGS.writer + "' should be either 'mosek' or 'native'");
+
+	// Read the format of models held in memory
+	map_seek_String(&format, arglist, OCT_ARGS.format, true);
+	if (!format.empty())
+		get_mskdataformat_byname(format);
+
+	// Read requested solution types and items (all if not specified)
+	{
+		map_seek_StringList(&soltypes, arglist, OCT_ARGS.soltypes, true);
+		map_seek_StringList(&solitems, arglist, OCT_ARGS.solitems, true);
+		map_seek_StringList(&sparseitems, arglist, OCT_ARGS.sparseitems, true);
+
+		string soltypenames[] = {"bas", "itr", "int"};
+		string solitemnames[] = {"skc", "skx", "xc", "xx", "slc", "suc", "slx", "sux", "snx"};
+		validate_StringList(soltypes, OCT_ARGS.soltypes, vector<string>(soltypenames, soltypenames + 3), true);
+		validate_StringList(solitems, OCT_ARGS.solitems, vector<string>(solitemnames, solitemnames + 9), true);
+		validate_StringList(sparseitems, OCT_ARGS.sparseitems, vector<string>(solitemnames + 2, solitemnames + 9), true);
+	}
+
+	// Read solution file (the solution is streamed to it instead of returned)
+	map_seek_String(&solfile, arglist, OCT_ARGS.solfile, true);
+	if (!solfile.empty() && lazysol)
+		throw msk_exception("Argument '" + OCT_ARGS.solfile + "' can not be combined with '" + OCT_ARGS.lazysol + "'");
+
+	// Read preallocated output buffers (organized as outbuf.<soltype>.<item>)
+	map_seek_OctaveMap(&outbuf, arglist, OCT_ARGS.outbuf, true);
+	map_seek_Scalar(&outcol, arglist, OCT_ARGS.outcol, true);
+	if (!isEmpty(outbuf)) {
+		string soltypenames[] = {"bas", "itr", "int"};
+		string slicenames[] = {"xc", "xx", "slc", "suc", "slx", "sux", "snx"};
+		validate_OctaveMap(outbuf, OCT_ARGS.outbuf, vector<string>(soltypenames, soltypenames + 3));
+
+		for (Octave_map::const_iterator it = outbuf.begin(); it != outbuf.end(); ++it) {
+			Octave_map items;
+			map_seek_OctaveMap(&items, outbuf, outbuf.key(it), true);
+			validate_OctaveMap(items, OCT_ARGS.outbuf + "." + outbuf.key(it), vector<string>(slicenames, slicenames + 7));
+		}
+
+		if (outcol < 1 || outcol != scalar2int(outcol))
+			throw msk_exception("Argument '" + OCT_ARGS.outcol + "' should be a positive column index");
+
+		if (lazysol || !solfile.empty())
+			throw msk_exception("Argument '" + OCT_ARGS.outbuf + "' can not be combined with '" + OCT_ARGS.lazysol + "' or '" + OCT_ARGS.solfile + "'");
+	}
+
+	if (timeslice < 0)
+		throw msk_exception("Argument '" + OCT_ARGS.timeslice + "' should be a non-negative number of seconds");
+
+	// Read incumbent sinks
+	Octave_map incumbent_arglist;
+	map_seek_OctaveMap(&incumbent_arglist, arglist, OCT_ARGS.incumbent, true);
+	if (!isEmpty(incumbent_arglist)) {
+		incumbent.OCT_read(incumbent_arglist);
+	}
+
+	// Read termination rules
+	Octave_map terminate_arglist;
+	map_seek_OctaveMap(&terminate_arglist, arglist, OCT_ARGS.terminate, true);
+	if (!isEmpty(terminate_arglist)) {
+		terminate.OCT_read(terminate_arglist);
+	}
 
 	// Check for bad arguments
 	validate_OctaveMap(arglist, "", OCT_ARGS.arglist);
@@ -95,9 +203,15 @@ void problem_type::OCT_read(Octave_map &arglist) {
 
 	// Integers variables and initial solutions
 	map_seek_IntegerArray(&intsub, arglist, OCT_ARGS.intsub, true);
-	map_seek_OctaveMap(&initsol, arglist, OCT_ARGS.sol, true);
 	numintvar = intsub.nelem();
 
+	// The initial solution can also be the path of a solution file (see mosek_savesol)
+	octave_value solval;	map_seek_Value(&solval, arglist, OCT_ARGS.sol, true);
+	if (solval.is_string())
+		initsolfile = solval.string_value();
+	else
+		map_seek_OctaveMap(&initsol, arglist, OCT_ARGS.sol, true);
+
 	// Parameters
 	map_seek_OctaveMap(&iparam, arglist, OCT_ARGS.iparam, true);
 	map_seek_OctaveMap(&dparam, arglist, OCT_ARGS.dparam, true);
@@ -124,49 +238,77 @@ void problem_type::OCT_write(Octave_map &prob_val) {
 	printdebug("Started writing Octave problem output");
 
 	// Objective sense
-	prob_val.assign("sense", octave_value(get_objective(sense), '\"'));
+	prob_val.assign("sense", OCT_writeitem(OCT_ARGS.sense));
 
 	// Objective
-	prob_val.assign("c", octave_value(c));
-	prob_val.assign("c0", octave_value(c0));
+	prob_val.assign("c", OCT_writeitem(OCT_ARGS.c));
+	prob_val.assign("c0", OCT_writeitem(OCT_ARGS.c0));
 
 	// Constraint Matrix A
-	prob_val.assign("A", octave_value(A));
+	prob_val.assign("A", OCT_writeitem(OCT_ARGS.A));
 
 	// Constraint and variable bounds
-	prob_val.assign("blc", octave_value(blc));
-	prob_val.assign("buc", octave_value(buc));
-	prob_val.assign("blx", octave_value(blx));
-	prob_val.assign("bux", octave_value(bux));
+	prob_val.assign("blc", OCT_writeitem(OCT_ARGS.blc));
+	prob_val.assign("buc", OCT_writeitem(OCT_ARGS.buc));
+	prob_val.assign("blx", OCT_writeitem(OCT_ARGS.blx));
+	prob_val.assign("bux", OCT_writeitem(OCT_ARGS.bux));
 
 	// Cones
 	if (numcones > 0) {
-		Cell objcones;	cones.OCT_write(objcones);
-		prob_val.assign("cones", octave_value(objcones));
+		prob_val.assign("cones", OCT_writeitem(OCT_ARGS.cones));
 	}
 
 	// Integer subindexes
 	if (numintvar > 0) {
-		prob_val.assign("intsub", octave_value(intsub));
+		prob_val.assign("intsub", OCT_writeitem(OCT_ARGS.intsub));
 	}
 
 	// Parameters
 	if (options.useparam) {
 		if (!isEmpty(iparam))
-			prob_val.assign("iparam", octave_value(iparam));
+			prob_val.assign("iparam", OCT_writeitem(OCT_ARGS.iparam));
 
 		if (!isEmpty(dparam))
-			prob_val.assign("dparam", octave_value(dparam));
+			prob_val.assign("dparam", OCT_writeitem(OCT_ARGS.dparam));
 
 		if (!isEmpty(sparam))
-			prob_val.assign("sparam", octave_value(sparam));
+			prob_val.assign("sparam", OCT_writeitem(OCT_ARGS.sparam));
 	}
 
 	// Initial solution
 	if (options.usesol) {
-		if (!isEmpty(initsol))
-			prob_val.assign("sol", octave_value(initsol));
+		if (!initsolfile.empty() || !isEmpty(initsol))
+			prob_val.assign("sol", OCT_writeitem(OCT_ARGS.sol));
+	}
+}
+
+
+octave_value problem_type::OCT_writeitem(const string &name) {
+	if (name == OCT_ARGS.sense)		return octave_value(get_objective(sense), '\"');
+	if (name == OCT_ARGS.c)			return octave_value(c);
+	if (name == OCT_ARGS.c0)		return octave_value(c0);
+	if (name == OCT_ARGS.A)			return octave_value(A);
+	if (name == OCT_ARGS.blc)		return octave_value(blc);
+	if (name == OCT_ARGS.buc)		return octave_value(buc);
+	if (name == OCT_ARGS.blx)		return octave_value(blx);
+	if (name == OCT_ARGS.bux)		return octave_value(bux);
+	if (name == OCT_ARGS.intsub)	return octave_value(intsub);
+	if (name == OCT_ARGS.iparam)	return octave_value(iparam);
+	if (name == OCT_ARGS.dparam)	return octave_value(dparam);
+	if (name == OCT_ARGS.sparam)	return octave_value(sparam);
+
+	if (name == OCT_ARGS.cones) {
+		Cell objcones;	cones.OCT_write(objcones);
+		return octave_value(objcones);
+	}
+
+	if (name == OCT_ARGS.sol) {
+		if (!initsolfile.empty())
+			return octave_value(initsolfile, '\"');
+		return octave_value(initsol);
 	}
+
+	throw msk_exception("Internal error in problem_type::OCT_writeitem, unknown item '" + name + "'");
 }
 
 
@@ -176,24 +318,37 @@ void problem_type::MOSEK_read(Task_handle &task) {
 	}
 	printdebug("Started reading MOSEK problem output");
 
-	// Get problem dimensions
-	{
-		errcatch( MSK_getnumanz(task, &numnz) );
-		errcatch( MSK_getnumcon(task, &numcon) );
-		errcatch( MSK_getnumvar(task, &numvar) );
-		errcatch( MSK_getnumintvar(task, &numintvar) );
-		errcatch( MSK_getnumcone(task, &numcones) );
-	}
+	MOSEK_readsizes(task);
+
+	string items[] = {OCT_ARGS.sense, OCT_ARGS.c, OCT_ARGS.A, OCT_ARGS.blc, OCT_ARGS.blx, OCT_ARGS.cones, OCT_ARGS.intsub,
+					  OCT_ARGS.iparam, OCT_ARGS.dparam, OCT_ARGS.sparam, OCT_ARGS.sol};
+	for (size_t i = 0; i < sizeof(items)/sizeof(string); ++i)
+		MOSEK_readitem(task, items[i]);
+
+	initialized = true;
+}
+
+
+void problem_type::MOSEK_readsizes(Task_handle &task) {
+	errcatch( MSK_getnumanz(task, &numnz) );
+	errcatch( MSK_getnumcon(task, &numcon) );
+	errcatch( MSK_getnumvar(task, &numvar) );
+	errcatch( MSK_getnumintvar(task, &numintvar) );
+	errcatch( MSK_getnumcone(task, &numcones) );
+}
+
+
+void problem_type::MOSEK_readitem(Task_handle &task, const string &name) {
 
 	// Objective sense and constant
-	{
+	if (name == OCT_ARGS.sense || name == OCT_ARGS.c0) {
 		printdebug("problem_type::MOSEK_read - Objective sense and constant");
 		errcatch( MSK_getobjsense(task, &sense) );
 		errcatch( MSK_getcfix(task, &c0) );
 	}
 
 	// Objective coefficients
-	{
+	else if (name == OCT_ARGS.c) {
 		printdebug("problem_type::MOSEK_read - Objective coefficients");
 
 		c = RowVector(numvar);
@@ -202,7 +357,7 @@ void problem_type::MOSEK_read(Task_handle &task) {
 	}
 
 	// Constraint Matrix A
-	{
+	else if (name == OCT_ARGS.A) {
 		printdebug("problem_type::MOSEK_read - Constraint matrix");
 
 		A = SparseMatrix(numcon, numvar, numnz);
@@ -216,7 +371,7 @@ void problem_type::MOSEK_read(Task_handle &task) {
 	}
 
 	// Constraint bounds
-	{
+	else if (name == OCT_ARGS.blc || name == OCT_ARGS.buc) {
 		printdebug("problem_type::MOSEK_read - Constraint bounds");
 
 		blc = RowVector(numcon);
@@ -229,7 +384,7 @@ void problem_type::MOSEK_read(Task_handle &task) {
 	}
 
 	// Variable bounds
-	{
+	else if (name == OCT_ARGS.blx || name == OCT_ARGS.bux) {
 		printdebug("problem_type::MOSEK_read - Variable bounds");
 
 		blx = RowVector(numvar);
@@ -242,66 +397,80 @@ void problem_type::MOSEK_read(Task_handle &task) {
 	}
 
 	// Cones
-	if (numcones > 0) {
-		printdebug("problem_type::MOSEK_read - Cones");
-		cones.MOSEK_read(task);
+	else if (name == OCT_ARGS.cones) {
+		if (numcones > 0) {
+			printdebug("problem_type::MOSEK_read - Cones");
+			cones.MOSEK_read(task);
+		}
 	}
 
 	// Integer subindexes
-	if (numintvar > 0) {
-		printdebug("problem_type::MOSEK_read - Integer subindexes");
+	else if (name == OCT_ARGS.intsub) {
+		if (numintvar > 0) {
+			printdebug("problem_type::MOSEK_read - Integer subindexes");
 
-		intsub = int32NDArray(dim_vector(1,numintvar));
-		octave_int32 *pintsub = intsub.fortran_vec();
+			intsub = int32NDArray(dim_vector(1,numintvar));
+			octave_int32 *pintsub = intsub.fortran_vec();
 
-		int idx = 0;
-		MSKvariabletypee type;
-		for (int i=0; i<numvar; i++) {
-			errcatch( MSK_getvartype(task,i,&type) );
+			int idx = 0;
+			MSKvariabletypee type;
+			for (int i=0; i<numvar; i++) {
+				errcatch( MSK_getvartype(task,i,&type) );
 
-			// Octave indexes count from 1, not from 0 as MOSEK
-			if (type == MSK_VAR_TYPE_INT) {
-				pintsub[idx++] = octave_int32(i+1);
+				// Octave indexes count from 1, not from 0 as MOSEK
+				if (type == MSK_VAR_TYPE_INT) {
+					pintsub[idx++] = octave_int32(i+1);
 
-				if (idx >= numintvar)
-					break;
+					if (idx >= numintvar)
+						break;
+				}
 			}
 		}
 	}
 
 	// Integer Parameters
-	if (options.useparam) {
-		printdebug("problem_type::MOSEK_read - Integer Parameters");
+	else if (name == OCT_ARGS.iparam) {
+		if (options.useparam) {
+			printdebug("problem_type::MOSEK_read - Integer Parameters");
 
-		iparam = Octave_map();
-		get_int_parameters(iparam, task);
+			iparam = Octave_map();
+			get_int_parameters(iparam, task, options.nondefault);
+		}
 	}
 
 	// Double Parameters
-	if (options.useparam) {
-		printdebug("problem_type::MOSEK_read - Double Parameters");
+	else if (name == OCT_ARGS.dparam) {
+		if (options.useparam) {
+			printdebug("problem_type::MOSEK_read - Double Parameters");
 
-		dparam = Octave_map();
-		get_dou_parameters(dparam, task);
+			dparam = Octave_map();
+			get_dou_parameters(dparam, task, options.nondefault);
+		}
 	}
 
 	// String Parameters
-	if (options.useparam) {
-		printdebug("problem_type::MOSEK_read - String Parameters");
+	else if (name == OCT_ARGS.sparam) {
+		if (options.useparam) {
+			printdebug("problem_type::MOSEK_read - String Parameters");
 
-		sparam = Octave_map();
-		get_str_parameters(sparam, task);
+			sparam = Octave_map();
+			get_str_parameters(sparam, task, options.nondefault);
+		}
 	}
 
 	// Initial solution
-	if (options.usesol) {
-		printdebug("problem_type::MOSEK_read - Initial solution");
+	else if (name == OCT_ARGS.sol) {
+		if (options.usesol) {
+			printdebug("problem_type::MOSEK_read - Initial solution");
 
-		initsol = Octave_map();
-		msk_getsolution(initsol, task);
+			initsol = Octave_map();
+			msk_getsolution(initsol, task, options);
+		}
 	}
 
-	initialized = true;
+	else {
+		throw msk_exception("Internal error in problem_type::MOSEK_readitem, unknown item '" + name + "'");
+	}
 }
 
 
@@ -318,13 +487,524 @@ void problem_type::MOSEK_write(Task_handle &task) {
 
 	/* Set initial solution */
 	if (options.usesol) {
-		append_initsol(task, initsol, numcon, numvar);
+		if (!initsolfile.empty())
+			msk_putsolfile(task, initsolfile);
+		else
+			append_initsol(task, initsol, numcon, numvar);
 	}
 
-	/* Set parameters */
-	if (options.useparam) {
+	/* Set parameter profile (skipped if already applied to the task) */
+	if (!options.paramprofile.empty()) {
+		global_profiles.get(options.paramprofile).apply(task);
+	}
+
+	/* Set parameters (taking precedence over the profile) */
+	if (options.useparam && (!isEmpty(iparam) || !isEmpty(dparam) || !isEmpty(sparam))) {
 		append_parameters(task, iparam, dparam, sparam);
+		task.paramstamp.clear();
 	}
 
 	printdebug("MOSEK_write finished");
 }
+
+
+/* This function stores the parameters of one type as lists of names and values, tagging
+ * numeric values with 1 and strings with 0 in a separate item. */
+static void snapshot_writeparams(Binfile_writer &file, const string &type, Octave_map &params)
+{
+	vector<string> names, values;
+	vector<uint8_t> isnumber;
+	for (Octave_map::const_iterator it = params.begin(); it != params.end(); ++it) {
+		octave_value value = params.contents(it)(0);
+
+		names.push_back(params.key(it));
+		if (value.is_string()) {
+			values.push_back(value.string_value());
+			isnumber.push_back(0);
+
+		} else if (value.is_real_scalar()) {
+			// Numbers are kept exactly with 17 significant digits
+			std::ostringstream ss;
+			ss.precision(17);
+			ss << value.scalar_value();
+			values.push_back(ss.str());
+			isnumber.push_back(1);
+
+		} else {
+			throw msk_exception("Parameter '" + names.back() + "' from " + type + " should be a string or a scalar");
+		}
+	}
+
+	file.add_text(type + ".names", names);
+	file.add_text(type + ".values", values);
+	file.add_uint8(type + ".isnumber", isnumber.empty() ? NULL : &isnumber[0], isnumber.size());
+}
+
+/* This function restores the parameters of one type, turning the tagged values back into numbers. */
+static void snapshot_readparams(const Binfile_reader &file, const string &type, Octave_map &params)
+{
+	vector<string> names, values;
+	file.text(type + ".names", names);
+	file.text(type + ".values", values);
+
+	if (names.size() != values.size())
+		throw msk_exception("The snapshot has " + tostring(names.size()) + " names but " + tostring(values.size()) + " values in " + type);
+
+	const uint8_t *isnumber = file.uint8(type + ".isnumber", names.size());
+
+	for (size_t i = 0; i < names.size(); ++i) {
+		if (isnumber[i]) {
+			char *end;
+			double number = strtod(values[i].c_str(), &end);
+			if (values[i].empty() || *end != '\0')
+				throw msk_exception("The value of parameter '" + names[i] + "' in " + type + " of the snapshot is not a number");
+
+			params.assign(names[i], octave_value(number));
+		} else {
+			params.assign(names[i], octave_value(values[i], '\"'));
+		}
+	}
+}
+
+
+void problem_type::SNAPSHOT_read(const string &filepath) {
+	if (initialized) {
+		throw msk_exception("Internal error in problem_type::SNAPSHOT_read, a problem was already loaded");
+	}
+	printdebug("Started reading problem snapshot");
+
+	Binfile_reader file;
+	file.open(filepath, OMSK_SNAPSHOT_MAGIC, OMSK_SNAPSHOT_VERSION);
+
+	// Get problem dimensions
+	for (int i = 0; i < 4; ++i)
+		if (file.dim(i) > static_cast<uint64_t>(INT_MAX))
+			throw msk_exception("The problem in snapshot '" + filepath + "' is too large");
+
+	numvar = static_cast<MSKintt>(file.dim(0));
+	numcon = static_cast<MSKintt>(file.dim(1));
+	numnz = static_cast<MSKintt>(file.dim(2));
+	numcones = static_cast<MSKintt>(file.dim(3));
+
+	// Objective sense and constant
+	sense = static_cast<MSKobjsensee>(file.int32("sense", 1)[0]);
+	c0 = file.float64("c0", 1)[0];
+
+	// Objective coefficients and bounds (copied straight from the mapped file)
+	c = RowVector(numvar);		memcpy(c.fortran_vec(), file.float64("c", numvar), numvar * sizeof(double));
+	blc = RowVector(numcon);	memcpy(blc.fortran_vec(), file.float64("blc", numcon), numcon * sizeof(double));
+	buc = RowVector(numcon);	memcpy(buc.fortran_vec(), file.float64("buc", numcon), numcon * sizeof(double));
+	blx = RowVector(numvar);	memcpy(blx.fortran_vec(), file.float64("blx", numvar), numvar * sizeof(double));
+	bux = RowVector(numvar);	memcpy(bux.fortran_vec(), file.float64("bux", numvar), numvar * sizeof(double));
+
+	// Constraint Matrix A
+	{
+		const int32_t *colptr = file.int32("A.colptr", numvar + 1);
+		const int32_t *rowidx = file.int32("A.rowidx", numnz);
+		const double *values = file.float64("A.values", numnz);
+
+		if (colptr[0] != 0 || colptr[numvar] != numnz)
+			throw msk_exception("The constraint matrix in snapshot '" + filepath + "' is corrupted");
+
+		A = SparseMatrix(numcon, numvar, numnz);
+		octave_idx_type *pcidx = A.cidx();
+		octave_idx_type *pridx = A.ridx();
+
+		for (MSKintt j = 0; j <= numvar; ++j) {
+			if (j > 0 && colptr[j] < colptr[j-1])
+				throw msk_exception("The constraint matrix in snapshot '" + filepath + "' is corrupted");
+			pcidx[j] = colptr[j];
+		}
+		for (MSKintt k = 0; k < numnz; ++k) {
+			if (rowidx[k] < 0 || rowidx[k] >= numcon)
+				throw msk_exception("The constraint matrix in snapshot '" + filepath + "' is corrupted");
+			pridx[k] = rowidx[k];
+		}
+		memcpy(A.data(), values, numnz * sizeof(double));
+	}
+
+	// Cones
+	{
+		vector<string> types;
+		file.text("cones.type", types);
+		const int32_t *ptr = file.int32("cones.ptr", numcones + 1);
+
+		if (types.size() != static_cast<size_t>(numcones) || ptr[0] != 0)
+			throw msk_exception("The cones in snapshot '" + filepath + "' are corrupted");
+
+		const int32_t *sub = file.int32("cones.sub", ptr[numcones]);
+
+		Cell objcones(dim_vector(1, numcones));
+		for (MSKintt i = 0; i < numcones; ++i) {
+			if (ptr[i+1] < ptr[i])
+				throw msk_exception("The cones in snapshot '" + filepath + "' are corrupted");
+
+			int32NDArray subvec(dim_vector(1, ptr[i+1] - ptr[i]));
+			octave_int32 *psub = subvec.fortran_vec();
+			for (int32_t k = ptr[i]; k < ptr[i+1]; ++k)
+				psub[k - ptr[i]] = octave_int32(sub[k]);
+
+			Octave_map cone;
+			cone.assign(conicSOC_type::ITEMS_type::OCT_ARGS.type, octave_value(types[i], '\"'));
+			cone.assign(conicSOC_type::ITEMS_type::OCT_ARGS.sub, octave_value(subvec));
+			objcones(i) = octave_value(cone);
+		}
+		cones.OCT_read(objcones);
+	}
+
+	// Integer subindexes
+	{
+		const int32_t *pint = file.int32("intsub", -1);
+		numintvar = static_cast<MSKintt>(file.find("intsub", OMSK_SOLFILE_INT32).count);
+
+		intsub = int32NDArray(dim_vector(1, numintvar));
+		octave_int32 *pintsub = intsub.fortran_vec();
+		for (MSKintt i = 0; i < numintvar; ++i)
+			pintsub[i] = octave_int32(pint[i]);
+	}
+
+	// Parameters
+	if (options.useparam && file.has("iparam.names")) {
+		printdebug("problem_type::SNAPSHOT_read - Parameters");
+
+		iparam = Octave_map();	snapshot_readparams(file, "iparam", iparam);
+		dparam = Octave_map();	snapshot_readparams(file, "dparam", dparam);
+		sparam = Octave_map();	snapshot_readparams(file, "sparam", sparam);
+	}
+
+	// Initial solution (items named by solution type, e.g. "itr.xx")
+	if (options.usesol) {
+		printdebug("problem_type::SNAPSHOT_read - Initial solution");
+
+		std::map<string, Octave_map> solutions;
+		const std::map<string, solfile_item> &items = file.itemlist();
+		for (std::map<string, solfile_item>::const_iterator it = items.begin(); it != items.end(); ++it) {
+			string sname = it->first.substr(0, it->first.find('.'));
+			if (sname != "bas" && sname != "itr" && sname != "int")
+				continue;
+
+			string vname = it->first.substr(sname.length() + 1);
+			Octave_map &sol = solutions[sname];
+
+			switch (it->second.type) {
+				case OMSK_SOLFILE_FLOAT64: {
+					RowVector vec(static_cast<octave_idx_type>(it->second.count));
+					memcpy(vec.fortran_vec(), file.float64(it->first, -1), it->second.count * sizeof(double));
+					sol.assign(vname, octave_value(vec));
+					break;
+				}
+				case OMSK_SOLFILE_UINT8: {
+					const uint8_t *codes = file.uint8(it->first, -1);
+					uint8NDArray vec(dim_vector(1, static_cast<octave_idx_type>(it->second.count)));
+					octave_uint8 *pvec = vec.fortran_vec();
+					for (uint64_t i = 0; i < it->second.count; ++i)
+						pvec[i] = octave_uint8(codes[i]);
+					sol.assign(vname, octave_value(vec));
+					break;
+				}
+				case OMSK_SOLFILE_TEXT: {
+					vector<string> strings;
+					file.text(it->first, strings);
+
+					// Status keys are cell arrays of strings, all other text items are strings
+					if (vname.compare(0, 2, "sk") == 0) {
+						Cell vec(dim_vector(1, strings.size()));
+						for (size_t i = 0; i < strings.size(); ++i)
+							vec(i) = octave_value(strings[i], '\"');
+						sol.assign(vname, octave_value(vec));
+					} else {
+						sol.assign(vname, octave_value(strings.empty() ? string() : strings[0], '\"'));
+					}
+					break;
+				}
+				default:
+					throw msk_exception("The solution item '" + it->first + "' in snapshot '" + filepath + "' has an unexpected element type");
+			}
+		}
+
+		initsol = Octave_map();
+		for (std::map<string, Octave_map>::iterator it = solutions.begin(); it != solutions.end(); ++it)
+			initsol.assign(it->first, octave_value(it->second));
+	}
+
+	initialized = true;
+}
+
+
+void problem_type::SNAPSHOT_write(const string &filepath) {
+	if (!initialized) {
+		throw msk_exception("Internal error in problem_type::SNAPSHOT_write, no problem was loaded");
+	}
+	printdebug("Started writing problem snapshot");
+
+	Binfile_writer file;
+
+	// Objective sense and constant
+	file.add_int32("sense", vector<int32_t>(1, static_cast<int32_t>(sense)));
+	file.add_float64("c0", &c0, 1);
+
+	// Objective coefficients and bounds (referenced, not copied)
+	file.add_float64("c", c.data(), numvar);
+	file.add_float64("blc", blc.data(), numcon);
+	file.add_float64("buc", buc.data(), numcon);
+	file.add_float64("blx", blx.data(), numvar);
+	file.add_float64("bux", bux.data(), numvar);
+
+	// Constraint Matrix A in compressed sparse column format
+	const octave_idx_type *pcidx = A.cidx();
+	const octave_idx_type *pridx = A.ridx();
+	MSKintt nnz = pcidx[numvar];
+
+	file.add_int32("A.colptr", vector<int32_t>(pcidx, pcidx + numvar + 1));
+	file.add_int32("A.rowidx", vector<int32_t>(pridx, pridx + nnz));
+	file.add_float64("A.values", A.data(), nnz);
+
+	// Cones, with the members of cone i in sub[ptr[i]] to sub[ptr[i+1]-1]
+	{
+		vector<string> types;
+		vector<int32_t> ptr(1, 0), sub;
+		for (MSKintt idx = 0; idx < numcones; ++idx) {
+			Octave_map cone = cones.cones.elem(idx).map_value();
+			if (error_state)
+				throw msk_exception("The cone at index " + tostring(idx+1) + " should be a 'struct'");
+
+			string type;		map_seek_String(&type, cone, conicSOC_type::ITEMS_type::OCT_ARGS.type);
+			int32NDArray csub;	map_seek_IntegerArray(&csub, cone, conicSOC_type::ITEMS_type::OCT_ARGS.sub);
+			validate_OctaveMap(cone, "cones{" + tostring(idx+1) + "}", conicSOC_type::ITEMS_type::OCT_ARGS.arglist);
+
+			types.push_back(type);
+			const octave_int32 *psub = csub.data();
+			for (octave_idx_type k = 0; k < csub.nelem(); ++k)
+				sub.push_back(psub[k].value());
+			ptr.push_back(static_cast<int32_t>(sub.size()));
+		}
+		file.add_text("cones.type", types);
+		file.add_int32("cones.ptr", ptr);
+		file.add_int32("cones.sub", sub);
+	}
+
+	// Integer subindexes
+	{
+		vector<int32_t> sub(numintvar);
+		const octave_int32 *pintsub = intsub.data();
+		for (MSKintt i = 0; i < numintvar; ++i)
+			sub[i] = pintsub[i].value();
+		file.add_int32("intsub", sub);
+	}
+
+	// Parameters
+	if (options.useparam) {
+		snapshot_writeparams(file, "iparam", iparam);
+		snapshot_writeparams(file, "dparam", dparam);
+		snapshot_writeparams(file, "sparam", sparam);
+	}
+
+	// Initial solution (the vectors must stay alive until the file is written)
+	std::list<RowVector> solvectors;
+	if (options.usesol && !initsolfile.empty())
+		printwarning("The initial solution file '" + initsolfile + "' is not stored in the snapshot.");
+
+	if (options.usesol) {
+		for (Octave_map::const_iterator it = initsol.begin(); it != initsol.end(); ++it) {
+			string sname = initsol.key(it);
+			get_msksoltype(sname);
+
+			Octave_map sol = initsol.contents(it)(0).map_value();
+			if (error_state)
+				throw msk_exception("The initial solution '" + sname + "' should be a 'struct'");
+
+			for (Octave_map::const_iterator p = sol.begin(); p != sol.end(); ++p) {
+				string name = sname + "." + sol.key(p);
+				octave_value value = sol.contents(p)(0);
+
+				if (name.length() >= OMSK_SOLFILE_NAME_SIZE)
+					throw msk_exception("The initial solution item '" + name + "' has too long a name to be stored in a snapshot");
+
+				if (value.is_string()) {
+					file.add_text(name, vector<string>(1, value.string_value()));
+
+				} else if (value.is_cell()) {
+					Cell cell = value.cell_value();
+					vector<string> strings(cell.nelem());
+					for (octave_idx_type i = 0; i < cell.nelem(); ++i) {
+						strings[i] = cell(i).string_value();
+						if (error_state)
+							throw msk_exception("The initial solution item '" + name + "' should be a cell array of strings");
+					}
+					file.add_text(name, strings);
+
+				} else if (value.is_uint8_type()) {
+					uint8NDArray codes = value.uint8_array_value();
+					vector<uint8_t> buffer(codes.nelem());
+					for (octave_idx_type i = 0; i < codes.nelem(); ++i)
+						buffer[i] = codes(i).value();
+					file.add_uint8(name, buffer.empty() ? NULL : &buffer[0], buffer.size());
+
+				} else {
+					solvectors.push_back(value.row_vector_value());
+					if (error_state)
+						throw msk_exception("The initial solution item '" + name + "' should be a vector");
+					file.add_float64(name, solvectors.back().data(), solvectors.back().nelem());
+				}
+			}
+		}
+	}
+
+	std::vector<uint64_t> dims(4);
+	dims[0] = numvar;
+	dims[1] = numcon;
+	dims[2] = nnz;
+	dims[3] = numcones;
+	file.write(filepath, OMSK_SNAPSHOT_MAGIC, OMSK_SNAPSHOT_VERSION, dims);
+}
+
+
+void problem_type::NATIVE_read(const string &filepath) {
+	if (initialized) {
+		throw msk_exception("Internal error in problem_type::NATIVE_read, a problem was already loaded");
+	}
+	printdebug("Started reading MPS file with the native reader");
+
+	if (!is_mpsfile(filepath))
+		throw msk_exception("The native reader only supports MPS files, not '" + filepath + "'");
+
+	Mpsfile_reader file;
+	file.open(filepath, get_numprocessors());
+
+	// Get problem dimensions
+	numvar = file.numvar;
+	numcon = file.numcon;
+	numnz = file.numnz;
+	numintvar = static_cast<MSKintt>(file.intsub.size());
+	numcones = static_cast<MSKintt>(file.conetypes.size());
+
+	// Objective sense and constant
+	sense = file.sense;
+	c0 = file.c0;
+
+	// Objective coefficients and bounds
+	c = RowVector(numvar);		std::copy(file.c.begin(), file.c.end(), c.fortran_vec());
+	blc = RowVector(numcon);	std::copy(file.blc.begin(), file.blc.end(), blc.fortran_vec());
+	buc = RowVector(numcon);	std::copy(file.buc.begin(), file.buc.end(), buc.fortran_vec());
+	blx = RowVector(numvar);	std::copy(file.blx.begin(), file.blx.end(), blx.fortran_vec());
+	bux = RowVector(numvar);	std::copy(file.bux.begin(), file.bux.end(), bux.fortran_vec());
+
+	// Constraint Matrix A (filled in place by the worker threads)
+	{
+		printdebug("problem_type::NATIVE_read - Constraint matrix");
+
+		A = SparseMatrix(numcon, numvar, numnz);
+		file.fill_matrix(A.cidx(), A.ridx(), A.data());
+	}
+
+	// Cones (Octave indexes count from 1)
+	{
+		Cell objcones(dim_vector(1, numcones));
+		for (MSKintt i = 0; i < numcones; ++i) {
+			int32NDArray subvec(dim_vector(1, file.coneptr[i+1] - file.coneptr[i]));
+			octave_int32 *psub = subvec.fortran_vec();
+			for (MSKidxt k = file.coneptr[i]; k < file.coneptr[i+1]; ++k)
+				psub[k - file.coneptr[i]] = octave_int32(file.conesub[k] + 1);
+
+			Octave_map cone;
+			cone.assign(conicSOC_type::ITEMS_type::OCT_ARGS.type, octave_value(file.conetypes[i], '\"'));
+			cone.assign(conicSOC_type::ITEMS_type::OCT_ARGS.sub, octave_value(subvec));
+			objcones(i) = octave_value(cone);
+		}
+		cones.OCT_read(objcones);
+	}
+
+	// Integer subindexes (Octave indexes count from 1)
+	{
+		intsub = int32NDArray(dim_vector(1, numintvar));
+		octave_int32 *pintsub = intsub.fortran_vec();
+		for (MSKintt i = 0; i < numintvar; ++i)
+			pintsub[i] = octave_int32(file.intsub[i] + 1);
+	}
+
+	initialized = true;
+}
+
+void problem_type::NATIVE_write(const string &filepath) {
+	if (!initialized) {
+		throw msk_exception("Internal error in problem_type::NATIVE_write, no problem was loaded");
+	}
+	printdebug("Started writing model file with the native writer");
+
+	Modelfile_writer::format_type format;
+	if (is_mpsfile(filepath))
+		format = Modelfile_writer::MPS;
+	else if (is_lpfile(filepath))
+		format = Modelfile_writer::LP;
+	else if (is_opffile(filepath))
+		format = Modelfile_writer::OPF;
+	else
+		throw msk_exception("The native writer only supports MPS, LP and OPF files, not '" + filepath + "'");
+
+	// Parameters and initial solutions are not written by the native writer
+	if (options.useparam && (!isEmpty(iparam) || !isEmpty(dparam) || !isEmpty(sparam)))
+		printwarning("The parameters are not written by the native writer.");
+	if (options.usesol && (!isEmpty(initsol) || !initsolfile.empty()))
+		printwarning("The initial solution is not written by the native writer.");
+
+	Modelfile_writer file(format);
+
+	// Objective sense and constant
+	file.sense = sense;
+	file.c0 = c0;
+
+	// Objective coefficients and bounds (referenced, not copied)
+	file.numvar = numvar;
+	file.numcon = numcon;
+	file.c = c.data();
+	file.blc = blc.data();
+	file.buc = buc.data();
+	file.blx = blx.data();
+	file.bux = bux.data();
+
+	// Constraint Matrix A in compressed sparse column format (referenced, not copied)
+	file.ptrb = A.cidx();
+	file.sub = A.ridx();
+	file.val = A.data();
+
+	// Cones (MOSEK indexes count from 0, not from 1 as Octave)
+	for (MSKintt idx = 0; idx < numcones; ++idx) {
+		Octave_map cone = cones.cones.elem(idx).map_value();
+		if (error_state)
+			throw msk_exception("The cone at index " + tostring(idx+1) + " should be a 'struct'");
+
+		string type;		map_seek_String(&type, cone, conicSOC_type::ITEMS_type::OCT_ARGS.type);
+		int32NDArray csub;	map_seek_IntegerArray(&csub, cone, conicSOC_type::ITEMS_type::OCT_ARGS.sub);
+		validate_OctaveMap(cone, "cones{" + tostring(idx+1) + "}", conicSOC_type::ITEMS_type::OCT_ARGS.arglist);
+
+		strtoupper(type);
+		remove_mskprefix(type, "MSK_CT_");
+		if (type != "QUAD" && type != "RQUAD")
+			throw msk_exception("The type of cone at index " + tostring(idx+1) + " was not recognized");
+
+		file.conetypes.push_back(type);
+		const octave_int32 *psub = csub.data();
+		for (octave_idx_type k = 0; k < csub.nelem(); ++k) {
+			MSKidxt j = psub[k].value() - 1;
+			if (j < 0 || j >= numvar)
+				throw msk_exception("The cone at index " + tostring(idx+1) + " has a variable index out of range");
+			file.conesub.push_back(j);
+		}
+		file.coneptr.push_back(static_cast<MSKidxt>(file.conesub.size()));
+	}
+
+	// Integer subindexes (marked per column)
+	{
+		file.isint.assign(numvar, 0);
+		const octave_int32 *pintsub = intsub.data();
+		for (MSKintt i = 0; i < numintvar; ++i) {
+			MSKidxt j = pintsub[i].value() - 1;
+			if (j < 0 || j >= numvar)
+				throw msk_exception("The integer subindex at position " + tostring(i+1) + " is out of range");
+			file.isint[j] = 1;
+		}
+	}
+
+	// The constraint matrix is formatted on all processors
+	file.write(filepath, get_numprocessors());
+}
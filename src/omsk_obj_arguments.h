@@ -5,6 +5,7 @@
 #include "omsk_obj_mosek.h"
 
 #include "omsk_obj_constraints.h"
+#include "omsk_obj_callback.h"
 
 #include <octave/oct.h>
 #include <octave/ov-struct.h>
@@ -27,15 +28,49 @@ public:
 		const std::string verbose;
 		const std::string writebefore;
 		const std::string writeafter;
+		const std::string incumbent;
+		const std::string terminate;
+		const std::string timeslice;
+		const std::string skcodes;
+		const std::string soltypes;
+		const std::string solitems;
+		const std::string lazysol;
+		const std::string lazyprob;
+		const std::string outbuf;
+		const std::string outcol;
+		const std::string solfile;
+		const std::string sparseitems;
+		const std::string paramprofile;
+		const std::string nondefault;
+		const std::string reader;
+		const std::string format;
+		const std::string writer;
 
 		OCT_ARGS_type() :
 			useparam("useparam"),
 			usesol("usesol"),
 			verbose("verbose"),
 			writebefore("writebefore"),
-			writeafter("writeafter")
+			writeafter("writeafter"),
+			incumbent("incumbent"),
+			terminate("terminate"),
+			timeslice("timeslice"),
+			skcodes("skcodes"),
+			soltypes("soltypes"),
+			solitems("solitems"),
+			lazysol("lazysol"),
+			lazyprob("lazyprob"),
+			outbuf("outbuf"),
+			outcol("outcol"),
+			solfile("solfile"),
+			sparseitems("sparseitems"),
+			paramprofile("paramprofile"),
+			nondefault("nondefault"),
+			reader("reader"),
+			format("format"),
+			writer("writer")
 		{
-			std::string temp[] = {useparam, usesol, verbose, writebefore, writeafter};
+			std::string temp[] = {useparam, usesol, verbose, writebefore, writeafter, incumbent, terminate, timeslice, skcodes, soltypes, solitems, lazysol, lazyprob, outbuf, outcol, solfile, sparseitems, paramprofile, nondefault, reader, format, writer};
 			arglist = std::vector<std::string>(temp, temp + sizeof(temp)/sizeof(std::string));
 		}
 	} OCT_ARGS;
@@ -47,6 +82,23 @@ public:
 	double 	verbose;
 	std::string	writebefore;
 	std::string	writeafter;
+	incumbent_type incumbent;
+	termination_type terminate;
+	double	timeslice;
+	bool	skcodes;
+	std::vector<std::string> soltypes;
+	std::vector<std::string> solitems;
+	bool	lazysol;
+	bool	lazyprob;
+	Octave_map outbuf;
+	double	outcol;
+	std::string	solfile;
+	std::vector<std::string> sparseitems;
+	std::string	paramprofile;
+	bool	nondefault;
+	std::string	reader;
+	std::string	format;
+	std::string	writer;
 
 	// Default values of optional arguments
 	options_type();
@@ -129,6 +181,7 @@ public:
 	conicSOC_type 	cones;
 	int32NDArray 	intsub;
 	Octave_map 		initsol;
+	std::string		initsolfile;
 	Octave_map 		iparam;
 	Octave_map 		dparam;
 	Octave_map	 	sparam;
@@ -141,9 +194,26 @@ public:
 	void OCT_read(Octave_map &arglist);
 	void OCT_write(Octave_map &prob_val);
 
+	// Write a single item of the problem description to Octave (e.g. "A")
+	octave_value OCT_writeitem(const std::string &name);
+
 	// Read and write problem description from and to MOSEK
 	void MOSEK_read(Task_handle &task);
 	void MOSEK_write(Task_handle &task);
+
+	// Read the dimensions, and then single items, of the problem description
+	// from MOSEK (used by lazy problems to fetch items when indexed)
+	void MOSEK_readsizes(Task_handle &task);
+	void MOSEK_readitem(Task_handle &task, const std::string &name);
+
+	// Read and write problem description from and to a binary snapshot (no task is created)
+	void SNAPSHOT_read(const std::string &filepath);
+	void SNAPSHOT_write(const std::string &filepath);
+
+	// Read and write problem description from and to an MPS file with the native reader
+	// and writer (no task is created)
+	void NATIVE_read(const std::string &filepath);
+	void NATIVE_write(const std::string &filepath);
 };
 
 #endif /* OMSK_OBJ_ARGUMENTS_H_ */
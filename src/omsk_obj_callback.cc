@@ -0,0 +1,438 @@
+#include "omsk_obj_callback.h"
+
+#include "omsk_utils_octave.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <stdint.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+using std::string;
+using std::vector;
+
+
+// ------------------------------
+// Class incumbent_type
+// ------------------------------
+
+const incumbent_type::OCT_ARGS_type incumbent_type::OCT_ARGS;
+
+// Default values of optional arguments
+incumbent_type::incumbent_type() :
+	initialized(false),
+
+	file(""),
+	ringbuffer(""),
+	ringsize(16),
+	callback(),
+	interval(0)
+{}
+
+bool incumbent_type::isactive() const {
+	return (!file.empty() || !ringbuffer.empty() || callback.is_defined());
+}
+
+void incumbent_type::OCT_read(Octave_map &arglist) {
+	printdebug("Reading incumbent sinks");
+
+	map_seek_String(&file, arglist, OCT_ARGS.file, true);
+	map_seek_String(&ringbuffer, arglist, OCT_ARGS.ringbuffer, true);
+	map_seek_Scalar(&ringsize, arglist, OCT_ARGS.ringsize, true);
+	map_seek_Value(&callback, arglist, OCT_ARGS.callback, true);
+	map_seek_Scalar(&interval, arglist, OCT_ARGS.interval, true);
+
+	if (callback.is_defined() && !callback.is_function_handle() && !callback.is_string())
+		throw msk_exception("Variable \"" + OCT_ARGS.callback + "\" should be a function handle or a function name");
+
+	if (xisnan(ringsize) || ringsize < 1 || ringsize != floor(ringsize) || ringsize > std::numeric_limits<uint32_t>::max())
+		throw msk_exception("Variable \"" + OCT_ARGS.ringsize + "\" should be a positive integer");
+
+	if (xisnan(interval) || interval < 0)
+		throw msk_exception("Variable \"" + OCT_ARGS.interval + "\" should be a non-negative number of milliseconds");
+
+	// Check for bad arguments
+	validate_OctaveMap(arglist, "incumbent", OCT_ARGS.arglist);
+
+	initialized = true;
+}
+
+
+// ------------------------------
+// Class incumbent_sink
+// ------------------------------
+
+incumbent_sink::incumbent_sink(const incumbent_type &sinks, MSKintt numvar) :
+	sinks(sinks),
+	numvar(numvar),
+	count(0),
+	xx(numvar > 0 ? numvar : 1),
+	obj(NAN),
+	time(NAN),
+	pending(false),
+	lastcall(-INFINITY),
+	filestream(NULL),
+	ringmap(NULL),
+	ringbytes(0),
+	ringfd(-1)
+{
+	if (!this->sinks.file.empty())
+		open_file();
+
+	try {
+		if (!this->sinks.ringbuffer.empty())
+			open_ringbuffer();
+
+	} catch (msk_exception const& e) {
+		if (filestream != NULL)
+			fclose(filestream);
+		throw;
+	}
+}
+
+incumbent_sink::~incumbent_sink() {
+	if (filestream != NULL) {
+		fclose(filestream);
+		filestream = NULL;
+	}
+
+#ifndef _WIN32
+	if (ringmap != NULL) {
+		munmap(ringmap, ringbytes);
+		ringmap = NULL;
+	}
+	if (ringfd >= 0) {
+		close(ringfd);
+		ringfd = -1;
+	}
+#endif
+}
+
+void incumbent_sink::open_file() {
+	printdebug("Opening incumbent file '" + sinks.file + "'");
+
+	filestream = fopen(sinks.file.c_str(), "wb");
+	if (filestream == NULL)
+		throw msk_exception("The incumbent file '" + sinks.file + "' could not be opened for writing");
+
+	char header[OMSK_INCUMBENT_HEADER_SIZE];
+	memset(header, 0, sizeof(header));
+	memcpy(header, OMSK_INCUMBENT_FILE_MAGIC, 8);
+
+	uint32_t version = 1;
+	uint64_t nvar = numvar;
+	memcpy(header + 8, &version, sizeof(version));
+	memcpy(header + 16, &nvar, sizeof(nvar));
+
+	if (fwrite(header, 1, sizeof(header), filestream) != sizeof(header)) {
+		fclose(filestream);
+		filestream = NULL;
+		throw msk_exception("The incumbent file '" + sinks.file + "' could not be written");
+	}
+	fflush(filestream);
+}
+
+void incumbent_sink::open_ringbuffer() {
+#ifdef _WIN32
+	throw msk_exception("Incumbent ring buffers are not supported on this platform");
+#else
+	printdebug("Mapping incumbent ring buffer '" + sinks.ringbuffer + "'");
+
+	uint32_t numslots = static_cast<uint32_t>(sinks.ringsize);
+	uint64_t slotbytes = 3*sizeof(double) + numvar*sizeof(double);
+	ringbytes = OMSK_INCUMBENT_HEADER_SIZE + numslots*slotbytes;
+
+	ringfd = open(sinks.ringbuffer.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (ringfd < 0)
+		throw msk_exception("The incumbent ring buffer '" + sinks.ringbuffer + "' could not be opened");
+
+	if (ftruncate(ringfd, ringbytes) != 0) {
+		close(ringfd);
+		ringfd = -1;
+		throw msk_exception("The incumbent ring buffer '" + sinks.ringbuffer + "' could not be resized");
+	}
+
+	void *map = mmap(NULL, ringbytes, PROT_READ | PROT_WRITE, MAP_SHARED, ringfd, 0);
+	if (map == MAP_FAILED) {
+		close(ringfd);
+		ringfd = -1;
+		throw msk_exception("The incumbent ring buffer '" + sinks.ringbuffer + "' could not be memory-mapped");
+	}
+	ringmap = static_cast<char*>(map);
+
+	// Header: magic, version, number of slots, number of variables, slot size, incumbent count
+	uint32_t version = 1;
+	uint64_t nvar = numvar;
+	uint64_t ncount = 0;
+	memcpy(ringmap, OMSK_INCUMBENT_RING_MAGIC, 8);
+	memcpy(ringmap + 8, &version, sizeof(version));
+	memcpy(ringmap + 12, &numslots, sizeof(numslots));
+	memcpy(ringmap + 16, &nvar, sizeof(nvar));
+	memcpy(ringmap + 24, &slotbytes, sizeof(slotbytes));
+	memcpy(ringmap + 32, &ncount, sizeof(ncount));
+#endif
+}
+
+void incumbent_sink::write_file() {
+	if (fwrite(&time, sizeof(double), 1, filestream) != 1 ||
+		fwrite(&obj, sizeof(double), 1, filestream) != 1 ||
+		fwrite(&xx[0], sizeof(double), numvar, filestream) != static_cast<size_t>(numvar)) {
+
+		fclose(filestream);
+		filestream = NULL;
+		printwarning("The incumbent file '" + sinks.file + "' could not be written and was closed.");
+		return;
+	}
+	fflush(filestream);
+}
+
+void incumbent_sink::write_ringbuffer() {
+	uint32_t numslots;
+	uint64_t slotbytes;
+	memcpy(&numslots, ringmap + 12, sizeof(numslots));
+	memcpy(&slotbytes, ringmap + 24, sizeof(slotbytes));
+
+	// Slot: sequence number (0 while being written), time, obj, xx
+	char *slot = ringmap + OMSK_INCUMBENT_HEADER_SIZE + ((count-1) % numslots)*slotbytes;
+	uint64_t seq = 0;
+	memcpy(slot, &seq, sizeof(seq));
+	memcpy(slot + 8, &time, sizeof(double));
+	memcpy(slot + 16, &obj, sizeof(double));
+	memcpy(slot + 24, &xx[0], numvar*sizeof(double));
+
+	// Publish the slot, then the header count, so readers never see a torn slot as complete
+	seq = count;
+	__sync_synchronize();
+	memcpy(slot, &seq, sizeof(seq));
+	__sync_synchronize();
+	memcpy(ringmap + 32, &seq, sizeof(seq));
+}
+
+void incumbent_sink::call_function() {
+	Octave_map incumbent;
+	RowVector xxvec(numvar);
+	std::copy(xx.begin(), xx.end(), xxvec.fortran_vec());
+
+	incumbent.assign("xx", octave_value(xxvec));
+	incumbent.assign("obj", octave_value(obj));
+	incumbent.assign("time", octave_value(time));
+	incumbent.assign("count", octave_value(static_cast<double>(count)));
+
+	octave_value_list args;
+	args(0) = octave_value(incumbent);
+
+	if (sinks.callback.is_string())
+		feval(sinks.callback.string_value(), args, 0);
+	else
+		feval(sinks.callback.function_value(), args, 0);
+
+	if (error_state) {
+		error_state = 0;
+		sinks.callback = octave_value();
+		printwarning("The incumbent callback failed and was removed.");
+	}
+}
+
+void incumbent_sink::push(MSKtask_t task, double elapsed) {
+	errcatch( MSK_getdouinf(task, MSK_DINF_MIO_OBJ_INT, &obj) );
+	errcatch( MSK_getsolutionslice(task, MSK_SOL_ITG, MSK_SOL_ITEM_XX, 0, numvar, &xx[0]) );
+
+	time = elapsed;
+	++count;
+
+	if (filestream != NULL)
+		write_file();
+
+	if (ringmap != NULL)
+		write_ringbuffer();
+
+	if (sinks.callback.is_defined()) {
+		pending = true;
+		poll(elapsed);
+	}
+}
+
+void incumbent_sink::poll(double elapsed) {
+	if (pending && 1000*(elapsed - lastcall) >= sinks.interval) {
+		pending = false;
+		lastcall = elapsed;
+		call_function();
+	}
+}
+
+void incumbent_sink::finish(double elapsed) {
+	if (pending) {
+		pending = false;
+		lastcall = elapsed;
+		call_function();
+	}
+}
+
+
+// ------------------------------
+// Class termination_type
+// ------------------------------
+
+const termination_type::OCT_ARGS_type termination_type::OCT_ARGS;
+
+// Default values of optional arguments
+termination_type::termination_type() :
+	initialized(false),
+
+	deadline(NAN),
+	objtarget(NAN),
+	stalltime(NAN),
+	relgap(NAN)
+{}
+
+bool termination_type::isactive() const {
+	return (!xisnan(deadline) || !xisnan(objtarget) || !xisnan(stalltime) || !xisnan(relgap));
+}
+
+void termination_type::OCT_read(Octave_map &arglist) {
+	printdebug("Reading termination rules");
+
+	map_seek_Scalar(&deadline, arglist, OCT_ARGS.deadline, true);
+	map_seek_Scalar(&objtarget, arglist, OCT_ARGS.objtarget, true);
+	map_seek_Scalar(&stalltime, arglist, OCT_ARGS.stalltime, true);
+	map_seek_Scalar(&relgap, arglist, OCT_ARGS.relgap, true);
+
+	if (deadline < 0)
+		throw msk_exception("Variable \"" + OCT_ARGS.deadline + "\" should be a non-negative number of seconds");
+
+	if (stalltime < 0)
+		throw msk_exception("Variable \"" + OCT_ARGS.stalltime + "\" should be a non-negative number of seconds");
+
+	if (relgap < 0)
+		throw msk_exception("Variable \"" + OCT_ARGS.relgap + "\" should be non-negative");
+
+	// Check for bad arguments
+	validate_OctaveMap(arglist, "terminate", OCT_ARGS.arglist);
+
+	initialized = true;
+}
+
+
+// ------------------------------
+// Class termination_monitor
+// ------------------------------
+
+termination_monitor::termination_monitor(const termination_type &rules, MSKtask_t task) :
+	rules(rules),
+	isminimize(true),
+	hasintegers(false),
+	pfeastol(0),
+	hasprogress(false),
+	bestprogress(NAN),
+	lastimprovement(0),
+	rule("")
+{
+	MSKobjsensee sense;
+	errcatch( MSK_getobjsense(task, &sense) );
+	isminimize = (sense != MSK_OBJECTIVE_SENSE_MAXIMIZE);
+
+	MSKintt numintvar;
+	errcatch( MSK_getnumintvar(task, &numintvar) );
+	hasintegers = (numintvar > 0);
+
+	if (hasintegers || (xisnan(rules.objtarget) && xisnan(rules.stalltime) && xisnan(rules.relgap)))
+		return;
+
+	// Continuous problems are followed through the interior-point iterates
+	MSKintt numcone;
+	errcatch( MSK_getnumcone(task, &numcone) );
+	errcatch( MSK_getdouparam(task, (numcone > 0) ? MSK_DPAR_INTPNT_CO_TOL_PFEAS : MSK_DPAR_INTPNT_TOL_PFEAS, &pfeastol) );
+
+	MSKintt optimizer;
+	errcatch( MSK_getintparam(task, MSK_IPAR_OPTIMIZER, &optimizer) );
+	if (optimizer == MSK_OPTIMIZER_PRIMAL_SIMPLEX || optimizer == MSK_OPTIMIZER_DUAL_SIMPLEX ||
+		optimizer == MSK_OPTIMIZER_FREE_SIMPLEX || optimizer == MSK_OPTIMIZER_NETWORK_PRIMAL_SIMPLEX) {
+		printwarning("The termination rules '" + termination_type::OCT_ARGS.objtarget + "', '" + termination_type::OCT_ARGS.stalltime +
+				"' and '" + termination_type::OCT_ARGS.relgap + "' follow the interior-point optimizer, and are not checked by the simplex optimizers");
+	}
+}
+
+bool termination_monitor::get_mioprogress(MSKtask_t task, double &obj, double &bound) {
+	MSKintt numintsol;
+	errcatch( MSK_getintinf(task, MSK_IINF_MIO_NUM_INT_SOLUTIONS, &numintsol) );
+	if (numintsol <= 0)
+		return false;
+
+	errcatch( MSK_getdouinf(task, MSK_DINF_MIO_OBJ_INT, &obj) );
+	errcatch( MSK_getdouinf(task, MSK_DINF_MIO_OBJ_BOUND, &bound) );
+	return true;
+}
+
+bool termination_monitor::get_intpntprogress(MSKtask_t task, double &obj, double &bound) {
+	MSKintt numiter;
+	errcatch( MSK_getintinf(task, MSK_IINF_INTPNT_ITER, &numiter) );
+	if (numiter <= 0)
+		return false;
+
+	errcatch( MSK_getdouinf(task, MSK_DINF_INTPNT_PRIMAL_OBJ, &obj) );
+	errcatch( MSK_getdouinf(task, MSK_DINF_INTPNT_DUAL_OBJ, &bound) );
+	return true;
+}
+
+bool termination_monitor::check(MSKtask_t task, double elapsed) {
+
+	if (elapsed >= rules.deadline) {
+		rule = termination_type::OCT_ARGS.deadline;
+		return true;
+	}
+
+	if (xisnan(rules.objtarget) && xisnan(rules.stalltime) && xisnan(rules.relgap))
+		return false;
+
+	// The remaining rules follow the objective and its bound (see the class description)
+	double obj = NAN, bound = NAN;
+	bool hasobj = hasintegers ? get_mioprogress(task, obj, bound) : get_intpntprogress(task, obj, bound);
+	double gap = fabs(obj - bound) / std::max(1.0, fabs(obj));
+
+	if (hasobj) {
+		// Only a strictly better incumbent, or a strictly smaller gap, counts as progress
+		double progress = hasintegers ? obj : gap;
+		bool better = hasintegers ? (isminimize ? (progress < bestprogress) : (progress > bestprogress)) : (progress < bestprogress);
+		if (!hasprogress || better) {
+			hasprogress = true;
+			bestprogress = progress;
+			lastimprovement = elapsed;
+		}
+	}
+
+	if (elapsed - lastimprovement >= rules.stalltime) {
+		rule = termination_type::OCT_ARGS.stalltime;
+		return true;
+	}
+
+	if (!hasobj)
+		return false;
+
+	if (!xisnan(rules.objtarget) && (isminimize ? (obj <= rules.objtarget) : (obj >= rules.objtarget))) {
+		// Interior-point iterates only count once they are primal feasible
+		double pfeas = 0;
+		if (!hasintegers)
+			errcatch( MSK_getdouinf(task, MSK_DINF_INTPNT_PRIMAL_FEAS, &pfeas) );
+
+		if (pfeas <= pfeastol) {
+			rule = termination_type::OCT_ARGS.objtarget;
+			return true;
+		}
+	}
+
+	if (gap <= rules.relgap) {
+		rule = termination_type::OCT_ARGS.relgap;
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,220 @@
+#ifndef OMSK_OBJ_CALLBACK_H_
+#define OMSK_OBJ_CALLBACK_H_
+
+#include "omsk_msg_mosek.h"
+
+#include <octave/oct.h>
+#include <octave/ov-struct.h>
+
+#include <string>
+#include <vector>
+#include <cstdio>
+
+// ------------------------------
+// Class incumbent_type
+// ------------------------------
+class incumbent_type {
+private:
+	bool initialized;
+
+public:
+	// Recognised incumbent sink arguments in Octave
+	// TODO: Upgrade to new C++11 initialisers
+	static const struct OCT_ARGS_type {
+
+		std::vector<std::string> arglist;
+		const std::string file;
+		const std::string ringbuffer;
+		const std::string ringsize;
+		const std::string callback;
+		const std::string interval;
+
+		OCT_ARGS_type() :
+			file("file"),
+			ringbuffer("ringbuffer"),
+			ringsize("ringsize"),
+			callback("callback"),
+			interval("interval")
+		{
+			std::string temp[] = {file, ringbuffer, ringsize, callback, interval};
+			arglist = std::vector<std::string>(temp, temp + sizeof(temp)/sizeof(std::string));
+		}
+	} OCT_ARGS;
+
+
+	// Data definition
+	std::string		file;
+	std::string		ringbuffer;
+	double			ringsize;
+	octave_value	callback;
+	double			interval;
+
+	// Default values of optional arguments
+	incumbent_type();
+
+	// Whether any sink has been registered
+	bool isactive() const;
+
+	// Read incumbent sinks from Octave (write not implemented)
+	void OCT_read(Octave_map &arglist);
+};
+
+
+// ------------------------------
+// Class incumbent_sink
+// ------------------------------
+//
+// Receives the integer-feasible solutions found by the mixed-integer optimizer
+// during the solve and pushes them to the sinks registered in 'incumbent_type':
+//
+//   file:        Appended records of {time, obj, xx} after a small header.
+//   ringbuffer:  A memory-mapped file of 'ringsize' slots overwritten cyclically.
+//   callback:    An Octave function called at most once every 'interval' ms.
+//
+// Binary layouts use the native byte order and doubles of the machine; see
+// OMSK_INCUMBENT_* below.
+//
+#define OMSK_INCUMBENT_FILE_MAGIC	"OMSKINC1"
+#define OMSK_INCUMBENT_RING_MAGIC	"OMSKRNG1"
+#define OMSK_INCUMBENT_HEADER_SIZE	64
+
+class incumbent_sink {
+private:
+	incumbent_type sinks;
+	MSKintt numvar;
+	long count;
+
+	// Most recent incumbent (kept for throttled delivery)
+	std::vector<double> xx;
+	double obj;
+	double time;
+
+	// Throttling of the Octave function handle
+	bool pending;
+	double lastcall;
+
+	// File sink
+	FILE *filestream;
+
+	// Ring buffer sink
+	char *ringmap;
+	size_t ringbytes;
+	int ringfd;
+
+	void open_file();
+	void open_ringbuffer();
+	void write_file();
+	void write_ringbuffer();
+	void call_function();
+
+	// Overwrite copy constructor and provide no implementation
+	incumbent_sink(const incumbent_sink& that);
+
+public:
+	incumbent_sink(const incumbent_type &sinks, MSKintt numvar);
+	~incumbent_sink();
+
+	// Number of incumbents received so far
+	long getcount() const { return count; }
+
+	// Called when MOSEK reports a new integer-feasible solution
+	void push(MSKtask_t task, double elapsed);
+
+	// Called on every callback to deliver throttled incumbents
+	void poll(double elapsed);
+
+	// Called after the optimizer returns to deliver the last incumbent
+	void finish(double elapsed);
+};
+
+
+// ------------------------------
+// Class termination_type
+// ------------------------------
+class termination_type {
+private:
+	bool initialized;
+
+public:
+	// Recognised termination rule arguments in Octave
+	// TODO: Upgrade to new C++11 initialisers
+	static const struct OCT_ARGS_type {
+
+		std::vector<std::string> arglist;
+		const std::string deadline;
+		const std::string objtarget;
+		const std::string stalltime;
+		const std::string relgap;
+
+		OCT_ARGS_type() :
+			deadline("deadline"),
+			objtarget("objtarget"),
+			stalltime("stalltime"),
+			relgap("relgap")
+		{
+			std::string temp[] = {deadline, objtarget, stalltime, relgap};
+			arglist = std::vector<std::string>(temp, temp + sizeof(temp)/sizeof(std::string));
+		}
+	} OCT_ARGS;
+
+
+	// Data definition (NaN means the rule is not used)
+	double deadline;
+	double objtarget;
+	double stalltime;
+	double relgap;
+
+	// Default values of optional arguments
+	termination_type();
+
+	// Whether any rule has been specified
+	bool isactive() const;
+
+	// Read termination rules from Octave (write not implemented)
+	void OCT_read(Octave_map &arglist);
+};
+
+
+// ------------------------------
+// Class termination_monitor
+// ------------------------------
+//
+// Evaluates the termination rules of 'termination_type' in the callback. The
+// deadline is checked on every call, while the objective-based rules follow an
+// objective and a bound taken from the information items: the incumbent and
+// the objective bound of the mixed-integer optimizer for problems with integer
+// variables, and otherwise the primal and dual objectives of the interior-point
+// iterates. An objective target is only met by iterates that are primal
+// feasible within the tolerance of the interior-point optimizer, and progress
+// (for the stall time) is a better incumbent or a smaller gap of the iterates.
+// The simplex optimizers update none of these items, which is warned about.
+// Times count from the start of each solve (i.e. per time slice).
+//
+class termination_monitor {
+private:
+	termination_type rules;
+	bool isminimize;
+	bool hasintegers;
+	double pfeastol;
+
+	// Best progress so far (incumbent objective, or relative gap of the
+	// interior-point iterates), and the time it last improved
+	bool hasprogress;
+	double bestprogress;
+	double lastimprovement;
+
+	// Reads the objective and bound, and returns false if not yet available
+	bool get_mioprogress(MSKtask_t task, double &obj, double &bound);
+	bool get_intpntprogress(MSKtask_t task, double &obj, double &bound);
+
+public:
+	// Name of the rule that terminated the solve (empty if none)
+	std::string rule;
+
+	termination_monitor(const termination_type &rules, MSKtask_t task);
+
+	// Returns true if the solve should be terminated
+	bool check(MSKtask_t task, double elapsed);
+};
+
+#endif /* OMSK_OBJ_CALLBACK_H_ */
@@ -0,0 +1,430 @@
+#include "omsk_obj_lazy.h"
+
+#include "omsk_utils_mosek.h"
+
+#include <octave/ov-typeinfo.h>
+
+#include <string>
+#include <vector>
+#include <exception>
+#include <algorithm>
+
+using std::string;
+using std::vector;
+using std::list;
+using std::map;
+using std::exception;
+
+
+// ------------------------------
+// Class Task_shared
+// ------------------------------
+
+Task_shared::Task_shared(int token) : count(0), token(token), skcodes(false) {
+}
+
+Task_shared::~Task_shared() {
+	global_registry.release(token);
+}
+
+Task_shared* Task_shared::adopt(Task_handle &task) {
+	return new Task_shared(global_registry.adopt(task, false));
+}
+
+void Task_shared::incref() {
+	++count;
+}
+
+void Task_shared::decref() {
+	if (--count == 0)
+		delete this;
+}
+
+MSKtask_t Task_shared::get() {
+	return gethandle();
+}
+
+Task_handle& Task_shared::gethandle() {
+	try {
+		return global_registry.get(token);
+	} catch (msk_exception const& e) {
+		throw msk_exception("The task of this lazy value has been released (e.g. by mosek_clean)");
+	}
+}
+
+void Task_shared::copy(Task_handle &task) {
+	Task_handle &source = gethandle();
+	task.clone(source);
+	task.paramstamp = source.paramstamp;
+
+	// Initial solutions read with the model are not part of the clone
+	msk_copysolutions(source, task);
+}
+
+
+// ------------------------------
+// Class octave_mosek_solution
+// ------------------------------
+
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA(octave_mosek_solution, "mosek_solution", "mosek_solution");
+
+void octave_mosek_solution::register_once() {
+	static bool registered = false;
+	if (!registered) {
+		octave_mosek_solution::register_type();
+
+		// Values of this type run code of this library, which must therefore
+		// stay loaded (e.g. through 'clear -f' in PKG_DEL) until Octave exits
+		mlock();
+		registered = true;
+	}
+}
+
+octave_mosek_solution::octave_mosek_solution() :
+	octave_base_value(), shared(NULL), soltype() {
+}
+
+octave_mosek_solution::octave_mosek_solution(Task_shared *shared, const string &soltype) :
+	octave_base_value(), shared(shared), soltype(soltype) {
+	if (shared)
+		shared->incref();
+}
+
+octave_mosek_solution::octave_mosek_solution(const octave_mosek_solution &that) :
+	octave_base_value(), shared(that.shared), soltype(that.soltype) {
+	if (shared)
+		shared->incref();
+}
+
+octave_mosek_solution::~octave_mosek_solution() {
+	if (shared)
+		shared->decref();
+}
+
+/* The solution types of the root, or the items of a solution type, still available from the task */
+list<string> octave_mosek_solution::fieldnames() const {
+	list<string> names;
+	if (!shared)
+		return names;
+
+	vector<string> fields;
+	if (soltype.empty()) {
+		get_soltypenames(shared->get(), fields);
+
+		for (size_t i=0; i<fields.size(); ++i)
+			if (isrequested(shared->soltypes, fields[i]))
+				names.push_back(fields[i]);
+
+	} else {
+		get_solitemnames(get_msksoltype(soltype), fields);
+
+		for (size_t i=0; i<fields.size(); ++i)
+			if (fields[i] == "solsta" || fields[i] == "prosta" || isrequested(shared->solitems, fields[i]))
+				names.push_back(fields[i]);
+	}
+	return names;
+}
+
+octave_value octave_mosek_solution::fetch(const string &name) const {
+	list<string> names = fieldnames();
+	if (std::find(names.begin(), names.end(), name) == names.end())
+		throw msk_exception("The solution does not contain a field named '" + name + "'");
+
+	// The root returns the solution types, which share the task
+	if (soltype.empty())
+		return octave_value(new octave_mosek_solution(shared, name));
+
+	// The solution types return the items, fetched on first access
+	string key = soltype + "." + name;
+	map<string, octave_value>::iterator it = shared->cache.find(key);
+	if (it != shared->cache.end())
+		return it->second;
+
+	printdebug("Fetching solution item " + key + " from task");
+	bool sparse = !shared->sparseitems.empty() && isrequested(shared->sparseitems, name);
+	octave_value item = msk_getsolitem(shared->get(), get_msksoltype(soltype), name, shared->skcodes, sparse);
+	shared->cache[key] = item;
+	return item;
+}
+
+octave_value octave_mosek_solution::subsref(const string &type, const list<octave_value_list> &idx) {
+	octave_value retval;
+
+	try {
+		switch (type[0]) {
+		case '.':
+			retval = fetch(idx.front()(0).string_value());
+			break;
+
+		default:
+			throw msk_exception("A " + type_name() + " can only be indexed by field names");
+		}
+
+	} catch (exception const& e) {
+		error("%s", e.what());
+		return octave_value();
+	}
+
+	return retval.next_subsref(type, idx);
+}
+
+octave_value_list octave_mosek_solution::subsref(const string &type, const list<octave_value_list> &idx, int nargout) {
+	return octave_value_list(subsref(type, idx));
+}
+
+Octave_map octave_mosek_solution::map_value() const {
+	Octave_map retval;
+
+	try {
+		list<string> names = fieldnames();
+		for (list<string>::iterator it = names.begin(); it != names.end(); ++it) {
+			if (soltype.empty())
+				retval.assign(*it, octave_value(octave_mosek_solution(shared, *it).map_value()));
+			else
+				retval.assign(*it, fetch(*it));
+		}
+
+	} catch (exception const& e) {
+		error("%s", e.what());
+	}
+
+	return retval;
+}
+
+string_vector octave_mosek_solution::map_keys() const {
+	try {
+		return string_vector(fieldnames());
+
+	} catch (exception const& e) {
+		error("%s", e.what());
+		return string_vector();
+	}
+}
+
+void octave_mosek_solution::print(std::ostream &os, bool pr_as_read_syntax) const {
+	print_raw(os, pr_as_read_syntax);
+	newline(os);
+}
+
+void octave_mosek_solution::print_raw(std::ostream &os, bool pr_as_read_syntax) const {
+	try {
+		list<string> names = fieldnames();
+
+		increment_indent_level();
+		for (list<string>::iterator it = names.begin(); it != names.end(); ++it) {
+			indent(os);
+			os << *it;
+
+			// Show only what has been fetched, to keep printing cheap
+			map<string, octave_value>::iterator item = shared->cache.find(soltype + "." + *it);
+			if (soltype.empty())
+				os << ": <solution>";
+			else if (item == shared->cache.end())
+				os << ": <not fetched>";
+			else
+				os << ": " << item->second.class_name() << " " << item->second.rows() << "x" << item->second.columns();
+
+			newline(os);
+		}
+		decrement_indent_level();
+
+	} catch (exception const& e) {
+		indent(os);
+		os << "<" << e.what() << ">";
+		newline(os);
+	}
+}
+
+bool octave_mosek_solution::print_name_tag(std::ostream &os, const string &name) const {
+	indent(os);
+	os << name << " =";
+	newline(os);
+	return false;
+}
+
+
+// ------------------------------
+// Class octave_mosek_problem
+// ------------------------------
+
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA(octave_mosek_problem, "mosek_problem", "mosek_problem");
+
+void octave_mosek_problem::register_once() {
+	static bool registered = false;
+	if (!registered) {
+		octave_mosek_problem::register_type();
+
+		// As for solutions, the library must stay loaded while such values exist
+		mlock();
+		registered = true;
+	}
+}
+
+octave_mosek_problem::octave_mosek_problem() :
+	octave_base_value(), shared(NULL), options() {
+}
+
+octave_mosek_problem::octave_mosek_problem(Task_shared *shared, const options_type &options) :
+	octave_base_value(), shared(shared), options(options) {
+	if (shared)
+		shared->incref();
+}
+
+octave_mosek_problem::octave_mosek_problem(const octave_mosek_problem &that) :
+	octave_base_value(), shared(that.shared), options(that.options) {
+	if (shared)
+		shared->incref();
+}
+
+octave_mosek_problem::~octave_mosek_problem() {
+	if (shared)
+		shared->decref();
+}
+
+/* The items of the problem, in the order of problem_type::OCT_write */
+list<string> octave_mosek_problem::fieldnames() const {
+	list<string> names;
+	if (!shared)
+		return names;
+
+	const problem_type::OCT_ARGS_type &ARGS = problem_type::OCT_ARGS;
+	string items[] = {ARGS.sense, ARGS.c, ARGS.c0, ARGS.A, ARGS.blc, ARGS.buc, ARGS.blx, ARGS.bux};
+	names.insert(names.end(), items, items + sizeof(items)/sizeof(string));
+
+	// The optional items are listed if they exist in the task
+	MSKtask_t task = shared->get();
+	MSKintt numcones, numintvar;
+	errcatch( MSK_getnumcone(task, &numcones) );
+	errcatch( MSK_getnumintvar(task, &numintvar) );
+
+	if (numcones > 0)
+		names.push_back(ARGS.cones);
+	if (numintvar > 0)
+		names.push_back(ARGS.intsub);
+
+	if (options.useparam) {
+		names.push_back(ARGS.iparam);
+		names.push_back(ARGS.dparam);
+		names.push_back(ARGS.sparam);
+	}
+
+	if (options.usesol) {
+		vector<string> soltypes;
+		get_soltypenames(task, soltypes);
+		if (!soltypes.empty())
+			names.push_back(ARGS.sol);
+	}
+
+	return names;
+}
+
+octave_value octave_mosek_problem::fetch(const string &name) const {
+	list<string> names = fieldnames();
+	if (std::find(names.begin(), names.end(), name) == names.end())
+		throw msk_exception("The problem does not contain a field named '" + name + "'");
+
+	// Items are fetched on first access
+	string key = "prob." + name;
+	map<string, octave_value>::iterator it = shared->cache.find(key);
+	if (it != shared->cache.end())
+		return it->second;
+
+	printdebug("Fetching problem item " + name + " from task");
+	problem_type probin;
+	probin.options = options;
+	probin.MOSEK_readsizes(shared->gethandle());
+	probin.MOSEK_readitem(shared->gethandle(), name);
+
+	octave_value item = probin.OCT_writeitem(name);
+	shared->cache[key] = item;
+	return item;
+}
+
+octave_value octave_mosek_problem::subsref(const string &type, const list<octave_value_list> &idx) {
+	octave_value retval;
+
+	try {
+		switch (type[0]) {
+		case '.':
+			retval = fetch(idx.front()(0).string_value());
+			break;
+
+		default:
+			throw msk_exception("A " + type_name() + " can only be indexed by field names");
+		}
+
+	} catch (exception const& e) {
+		error("%s", e.what());
+		return octave_value();
+	}
+
+	return retval.next_subsref(type, idx);
+}
+
+octave_value_list octave_mosek_problem::subsref(const string &type, const list<octave_value_list> &idx, int nargout) {
+	return octave_value_list(subsref(type, idx));
+}
+
+Octave_map octave_mosek_problem::map_value() const {
+	Octave_map retval;
+
+	try {
+		list<string> names = fieldnames();
+		for (list<string>::iterator it = names.begin(); it != names.end(); ++it)
+			retval.assign(*it, fetch(*it));
+
+	} catch (exception const& e) {
+		error("%s", e.what());
+	}
+
+	return retval;
+}
+
+string_vector octave_mosek_problem::map_keys() const {
+	try {
+		return string_vector(fieldnames());
+
+	} catch (exception const& e) {
+		error("%s", e.what());
+		return string_vector();
+	}
+}
+
+void octave_mosek_problem::print(std::ostream &os, bool pr_as_read_syntax) const {
+	print_raw(os, pr_as_read_syntax);
+	newline(os);
+}
+
+void octave_mosek_problem::print_raw(std::ostream &os, bool pr_as_read_syntax) const {
+	try {
+		list<string> names = fieldnames();
+
+		increment_indent_level();
+		for (list<string>::iterator it = names.begin(); it != names.end(); ++it) {
+			indent(os);
+			os << *it;
+
+			// Show only what has been fetched, to keep printing cheap
+			map<string, octave_value>::iterator item = shared->cache.find("prob." + *it);
+			if (item == shared->cache.end())
+				os << ": <not fetched>";
+			else
+				os << ": " << item->second.class_name() << " " << item->second.rows() << "x" << item->second.columns();
+
+			newline(os);
+		}
+		decrement_indent_level();
+
+	} catch (exception const& e) {
+		indent(os);
+		os << "<" << e.what() << ">";
+		newline(os);
+	}
+}
+
+bool octave_mosek_problem::print_name_tag(std::ostream &os, const string &name) const {
+	indent(os);
+	os << name << " =";
+	newline(os);
+	return false;
+}
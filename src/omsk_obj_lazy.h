@@ -0,0 +1,165 @@
+#ifndef OMSK_OBJ_LAZY_H_
+#define OMSK_OBJ_LAZY_H_
+
+#include "omsk_msg_mosek.h"
+#include "omsk_obj_mosek.h"
+#include "omsk_obj_arguments.h"
+
+#include <octave/oct.h>
+#include <octave/ov-base.h>
+#include <octave/ov-struct.h>
+
+#include <string>
+#include <list>
+#include <map>
+#include <vector>
+
+// ------------------------------
+// Class Task_shared
+// ------------------------------
+//
+// A task shared by the lazy Octave values referring to it. The task itself is
+// kept in 'global_registry' and released when the last reference goes away, or
+// early by mosek_clean in which case later accesses fail with an error.
+//
+class Task_shared {
+private:
+	int count;
+	int token;
+
+	Task_shared(int token);
+	~Task_shared();
+
+	// Overwrite copy constructor and provide no implementation
+	Task_shared(const Task_shared& that);
+
+public:
+	// Items already fetched from the task, e.g. "itr.xx"
+	std::map<std::string, octave_value> cache;
+
+	// Whether status keys are fetched as codes, which types and items are shown,
+	// and which items are fetched as sparse vectors
+	bool skcodes;
+	std::vector<std::string> soltypes;
+	std::vector<std::string> solitems;
+	std::vector<std::string> sparseitems;
+
+	// Takes over the task (the first lazy value holds the reference)
+	static Task_shared* adopt(Task_handle &task);
+
+	void incref();
+	void decref();
+
+	// Retrieves the task (throws if it has been released)
+	MSKtask_t get();
+	Task_handle& gethandle();
+
+	// Creates 'task' as a copy of the task with its solutions, leaving the lazy
+	// values untouched (Octave may share them between any number of variables)
+	void copy(Task_handle &task);
+};
+
+
+// ------------------------------
+// Class octave_mosek_solution
+// ------------------------------
+//
+// The 'sol' structure of a solve, with each item fetched from the shared task
+// when it is indexed (e.g. r.sol.itr.xx) and cached after the first access.
+// The root lists the solution types, and each solution type its items.
+//
+class octave_mosek_solution : public octave_base_value {
+private:
+	Task_shared *shared;
+	std::string soltype;
+
+	octave_value fetch(const std::string &name) const;
+	std::list<std::string> fieldnames() const;
+
+public:
+	octave_mosek_solution();
+	octave_mosek_solution(Task_shared *shared, const std::string &soltype);
+	octave_mosek_solution(const octave_mosek_solution &that);
+	~octave_mosek_solution();
+
+	octave_base_value* clone() const { return new octave_mosek_solution(*this); }
+	octave_base_value* empty_clone() const { return new octave_mosek_solution(); }
+
+	octave_value subsref(const std::string &type, const std::list<octave_value_list> &idx);
+	octave_value_list subsref(const std::string &type, const std::list<octave_value_list> &idx, int nargout);
+
+	dim_vector dims() const { return dim_vector(1, 1); }
+	bool is_defined() const { return true; }
+	bool is_constant() const { return true; }
+
+	// The shared task, and the solution type shown ("" for all of them)
+	Task_shared* getshared() const { return shared; }
+	const std::string& getsoltype() const { return soltype; }
+
+	// Materializes all fields (e.g. when used as an initial solution)
+	Octave_map map_value() const;
+	string_vector map_keys() const;
+
+	void print(std::ostream &os, bool pr_as_read_syntax = false) const;
+	void print_raw(std::ostream &os, bool pr_as_read_syntax = false) const;
+	bool print_name_tag(std::ostream &os, const std::string &name) const;
+
+	// Registers the type with Octave, and locks the calling function (and thus
+	// the library) in memory, as values of this type may outlive a clear
+	static void register_once();
+
+private:
+	DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
+};
+
+
+// ------------------------------
+// Class octave_mosek_problem
+// ------------------------------
+//
+// The 'prob' structure of mosek_read, with each item fetched from the shared
+// task when it is indexed (e.g. r.prob.A) and cached after the first access.
+// Passed to mosek, a copy of the task is optimized as it is.
+//
+class octave_mosek_problem : public octave_base_value {
+private:
+	Task_shared *shared;
+	options_type options;
+
+	octave_value fetch(const std::string &name) const;
+	std::list<std::string> fieldnames() const;
+
+public:
+	octave_mosek_problem();
+	octave_mosek_problem(Task_shared *shared, const options_type &options);
+	octave_mosek_problem(const octave_mosek_problem &that);
+	~octave_mosek_problem();
+
+	octave_base_value* clone() const { return new octave_mosek_problem(*this); }
+	octave_base_value* empty_clone() const { return new octave_mosek_problem(); }
+
+	octave_value subsref(const std::string &type, const std::list<octave_value_list> &idx);
+	octave_value_list subsref(const std::string &type, const std::list<octave_value_list> &idx, int nargout);
+
+	dim_vector dims() const { return dim_vector(1, 1); }
+	bool is_defined() const { return true; }
+	bool is_constant() const { return true; }
+
+	Task_shared* getshared() const { return shared; }
+
+	// Materializes all fields (e.g. when written by mosek_write)
+	Octave_map map_value() const;
+	string_vector map_keys() const;
+
+	void print(std::ostream &os, bool pr_as_read_syntax = false) const;
+	void print_raw(std::ostream &os, bool pr_as_read_syntax = false) const;
+	bool print_name_tag(std::ostream &os, const std::string &name) const;
+
+	// Registers the type with Octave (once per library load)
+	static void register_once();
+
+private:
+	DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
+};
+
+#endif /* OMSK_OBJ_LAZY_H_ */
@@ -1,8 +1,11 @@
 #include "omsk_obj_mosek.h"
 
 #include <stdexcept>
+#include <map>
+#include <string>
 
 using std::exception;
+using std::map;
 
 
 // ------------------------------
@@ -11,6 +14,12 @@ using std::exception;
 Env_handle global_env;
 
 
+// ------------------------------
+// Global task registry (declared after 'global_env' to be destroyed before it)
+// ------------------------------
+Task_registry global_registry;
+
+
 // ------------------------------
 // MOSEK message output function
 // ------------------------------
@@ -18,6 +27,10 @@ static void MSKAPI msk_printoutput(void *handle, char str[]) {
 	printoutput(str, typeMOSEK);
 }
 
+static void MSKAPI msk_bufferoutput(void *handle, char str[]) {
+	static_cast<std::string*>(handle)->append(str);
+}
+
 
 // ------------------------------
 // Class Env_handle
@@ -90,6 +103,27 @@ void Task_handle::init(MSKenv_t env, MSKintt maxnumcon, MSKintt maxnumvar) {
 	initialized = true;
 }
 
+void Task_handle::clone(MSKtask_t source) {
+	if (initialized)
+		throw msk_exception("No support for multiple tasks yet!");
+
+	printdebug("Copying an optimization task");
+
+	/* Copy the problem data and parameters of the source task. */
+	errcatch( MSK_clonetask(source, &task) );
+
+	try {
+		/* Directs the log task stream to the 'msk_printoutput' function. */
+		errcatch( MSK_linkfunctotaskstream(task, MSK_STREAM_LOG, NULL, msk_printoutput) );
+
+	} catch (exception const& e) {
+		MSK_deletetask(&task);
+		throw;
+	}
+
+	initialized = true;
+}
+
 Task_handle::~Task_handle() {
 	if (initialized) {
 		printdebug("Removing an optimization task");
@@ -98,3 +132,77 @@ Task_handle::~Task_handle() {
 		initialized = false;
 	}
 }
+
+void Task_handle::bufferlog(std::string *buffer) {
+	if (!initialized)
+		throw msk_exception("Internal error in Task_handle::bufferlog, no task was created");
+
+	MSK_unlinkfuncfromtaskstream(task, MSK_STREAM_LOG);
+	errcatch( MSK_linkfunctotaskstream(task, MSK_STREAM_LOG, static_cast<void*>(buffer), msk_bufferoutput) );
+}
+
+void Task_handle::swap(Task_handle &that) {
+	MSKtask_t temptask = task;
+	bool tempinitialized = initialized;
+
+	task = that.task;
+	initialized = that.initialized;
+
+	that.task = temptask;
+	that.initialized = tempinitialized;
+
+	paramstamp.swap(that.paramstamp);
+}
+
+
+// ------------------------------
+// Class Task_registry
+// ------------------------------
+
+int Task_registry::adopt(Task_handle &task, bool resumable) {
+	entry_type entry;
+	entry.task = new Task_handle();
+	entry.task->swap(task);
+	entry.resumable = resumable;
+
+	tasks[++lasttoken] = entry;
+	printdebug("Registered an optimization task with token " + tostring(lasttoken));
+
+	return lasttoken;
+}
+
+Task_handle& Task_registry::get(int token) {
+	map<int, entry_type>::iterator it = tasks.find(token);
+	if (it == tasks.end())
+		throw msk_exception("No task is registered with token " + tostring(token));
+
+	return *(it->second.task);
+}
+
+Task_handle& Task_registry::getresumable(int token) {
+	map<int, entry_type>::iterator it = tasks.find(token);
+	if (it == tasks.end() || !it->second.resumable)
+		throw msk_exception("No suspended solve is registered with token " + tostring(token));
+
+	return *(it->second.task);
+}
+
+void Task_registry::release(int token) {
+	map<int, entry_type>::iterator it = tasks.find(token);
+	if (it != tasks.end()) {
+		printdebug("Releasing the optimization task with token " + tostring(token));
+		delete it->second.task;
+		tasks.erase(it);
+	}
+}
+
+void Task_registry::clear() {
+	for (map<int, entry_type>::iterator it = tasks.begin(); it != tasks.end(); ++it)
+		delete it->second.task;
+
+	tasks.clear();
+}
+
+Task_registry::~Task_registry() {
+	clear();
+}
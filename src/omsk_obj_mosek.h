@@ -3,6 +3,9 @@
 
 #include "omsk_msg_mosek.h"
 
+#include <map>
+#include <string>
+
 // ------------------------------
 // Global variable: MOSEK environment
 // ------------------------------
@@ -36,11 +39,58 @@ private:
 	Task_handle(const Task_handle& that);
 
 public:
+	// Stamp of the parameter profile last applied (cleared by other parameter changes)
+	std::string paramstamp;
+
 	Task_handle() 		 { initialized = false; }
 	operator MSKtask_t() { return task; }
 
 	void init(MSKenv_t env, MSKintt maxnumcon, MSKintt maxnumvar);
+	void clone(MSKtask_t source);
+	void swap(Task_handle &that);
+
+	// Directs the log stream into 'buffer' instead of printing it, such that the
+	// task can be used by a worker thread (the caller prints the buffer later)
+	void bufferlog(std::string *buffer);
 	~Task_handle();
 };
 
+
+// ------------------------------
+// Global variable: Registry of tasks kept alive between calls
+// ------------------------------
+extern class Task_registry {
+private:
+	// Tasks of suspended solves are resumable, while the tasks behind lazy
+	// values (sharing the tokens) are not
+	struct entry_type {
+		Task_handle	*task;
+		bool		resumable;
+	};
+	std::map<int, entry_type> tasks;
+	int lasttoken;
+
+	// Overwrite copy constructor and provide no implementation
+	Task_registry(const Task_registry& that);
+
+public:
+	Task_registry() 	{ lasttoken = 0; }
+
+	// Takes over the task and returns the token identifying it
+	int adopt(Task_handle &task, bool resumable);
+
+	// Retrieves a registered task (throws if the token is unknown)
+	Task_handle& get(int token);
+
+	// Retrieves a task registered as resumable (throws for other tokens)
+	Task_handle& getresumable(int token);
+
+	// Removes and deletes a registered task (ignores unknown tokens)
+	void release(int token);
+
+	void clear();
+	~Task_registry();
+
+} global_registry;
+
 #endif /* OMSK_OBJ_MOSEK_H_ */
@@ -0,0 +1,366 @@
+#include "omsk_obj_parameters.h"
+
+#include "omsk_obj_mosek.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+
+using std::string;
+using std::vector;
+using std::map;
+using std::pair;
+
+
+// ------------------------------
+// Global table of MOSEK parameters
+// ------------------------------
+Parameter_table global_params;
+
+
+// ------------------------------
+// Global registry of parameter profiles
+// ------------------------------
+Profile_registry global_profiles;
+
+
+// ------------------------------
+// Name normalization
+// ------------------------------
+
+/* Removes the longest ending of 'prefix' that starts 'str', e.g. "IPAR_" of "MSK_IPAR_" from "IPAR_LOG" */
+static void strip_mskprefix(string &str, const string &prefix)
+{
+	for (size_t i = 0; i < prefix.length(); ++i) {
+		size_t len = prefix.length() - i;
+		if (str.length() > len && str.compare(0, len, prefix, i, len) == 0) {
+			str.erase(0, len);
+			return;
+		}
+	}
+}
+
+static const char* get_paramprefix(MSKparametertypee type)
+{
+	switch (type) {
+		case MSK_PAR_INT_TYPE: return "MSK_IPAR_";
+		case MSK_PAR_DOU_TYPE: return "MSK_DPAR_";
+		case MSK_PAR_STR_TYPE: return "MSK_SPAR_";
+		default:
+			throw msk_exception("A parameter type was not recognized");
+	}
+}
+
+static MSKparametertypee get_paramtype(const string &type)
+{
+	if (type == "iparam") return MSK_PAR_INT_TYPE;
+	if (type == "dparam") return MSK_PAR_DOU_TYPE;
+	if (type == "sparam") return MSK_PAR_STR_TYPE;
+	throw msk_exception("A parameter type was not recognized");
+}
+
+
+// ------------------------------
+// Class Parameter_table
+// ------------------------------
+
+/* FNV-1a hash of the key, with the seed mixed into the offset basis */
+uint32_t Parameter_table::hash(const string &key, uint32_t seed)
+{
+	uint32_t h = 2166136261u ^ (seed * 16777619u);
+	for (size_t i = 0; i < key.length(); ++i) {
+		h ^= static_cast<unsigned char>(key[i]);
+		h *= 16777619u;
+	}
+	return h;
+}
+
+string Parameter_table::hashkey(MSKparametertypee type, const string &name)
+{
+	switch (type) {
+		case MSK_PAR_INT_TYPE: return "I" + name;
+		case MSK_PAR_DOU_TYPE: return "D" + name;
+		case MSK_PAR_STR_TYPE: return "S" + name;
+		default:
+			throw msk_exception("A parameter type was not recognized");
+	}
+}
+
+void Parameter_table::buildhash()
+{
+	size_t numkeys = params.size();
+	size_t numbuckets = std::max<size_t>(1, numkeys / 4);
+	size_t numslots = numkeys + numkeys / 4 + 1;
+
+	// Distribute keys in buckets, and place the largest buckets first
+	vector< vector<int> > buckets(numbuckets);
+	for (size_t k = 0; k < numkeys; ++k)
+		buckets[hash(hashkey(params[k].type, params[k].name), 0) % numbuckets].push_back(k);
+
+	vector< pair<size_t, size_t> > order;
+	for (size_t b = 0; b < numbuckets; ++b)
+		if (!buckets[b].empty())
+			order.push_back(pair<size_t, size_t>(buckets[b].size(), b));
+	std::sort(order.rbegin(), order.rend());
+
+	displace.assign(numbuckets, 0);
+	slots.assign(numslots, -1);
+
+	// Find the seed of each bucket that leads all its keys to free slots
+	vector<size_t> trial;
+	for (size_t o = 0; o < order.size(); ++o) {
+		const vector<int> &bucket = buckets[order[o].second];
+
+		uint32_t seed;
+		for (seed = 1; seed != 0; ++seed) {
+			trial.clear();
+			for (size_t k = 0; k < bucket.size(); ++k) {
+				size_t slot = hash(hashkey(params[bucket[k]].type, params[bucket[k]].name), seed) % numslots;
+				if (slots[slot] >= 0 || std::find(trial.begin(), trial.end(), slot) != trial.end())
+					break;
+				trial.push_back(slot);
+			}
+			if (trial.size() == bucket.size())
+				break;
+		}
+		if (seed == 0)
+			throw msk_exception("Internal error in Parameter_table::buildhash, no perfect hash was found");
+
+		displace[order[o].second] = seed;
+		for (size_t k = 0; k < bucket.size(); ++k)
+			slots[trial[k]] = bucket[k];
+	}
+}
+
+void Parameter_table::init(MSKtask_t task)
+{
+	if (initialized)
+		return;
+
+	printdebug("Building the table of MOSEK parameters");
+
+	const MSKparametertypee types[] = {MSK_PAR_INT_TYPE, MSK_PAR_DOU_TYPE, MSK_PAR_STR_TYPE};
+	const int begin[] = {MSK_IPAR_BEGIN, MSK_DPAR_BEGIN, MSK_SPAR_BEGIN};
+	const int end[] = {MSK_IPAR_END, MSK_DPAR_END, MSK_SPAR_END};
+
+	params.clear();
+	char paramname[MSK_MAX_STR_LEN];
+	for (int t = 0; t < 3; ++t) {
+		for (int v = begin[t]; v < end[t]; ++v) {
+			errcatch( MSK_getparamname(task, types[t], v, paramname) );
+
+			entry e;
+			e.name = paramname;
+			e.type = types[t];
+			e.index = v;
+			strip_mskprefix(e.name, get_paramprefix(types[t]));
+			params.push_back(e);
+		}
+	}
+	numint = MSK_IPAR_END - MSK_IPAR_BEGIN;
+	numdou = MSK_DPAR_END - MSK_DPAR_BEGIN;
+	numstr = MSK_SPAR_END - MSK_SPAR_BEGIN;
+
+	buildhash();
+	initialized = true;
+}
+
+const Parameter_table::entry& Parameter_table::find(const string &type, const string &name)
+{
+	if (!initialized)
+		throw msk_exception("Internal error in Parameter_table::find, the table was not built");
+
+	MSKparametertypee ptype = get_paramtype(type);
+
+	string key = name;
+	strtoupper(key);
+	strip_mskprefix(key, get_paramprefix(ptype));
+	key = hashkey(ptype, key);
+
+	uint32_t seed = displace[hash(key, 0) % displace.size()];
+	if (seed != 0) {
+		int k = slots[hash(key, seed) % slots.size()];
+		if (k >= 0 && hashkey(params[k].type, params[k].name) == key)
+			return params[k];
+	}
+
+	throw msk_exception("Parameter '" + name + "' from " + type + " was not recognized.");
+}
+
+MSKintt Parameter_table::size(MSKparametertypee type) const
+{
+	switch (type) {
+		case MSK_PAR_INT_TYPE: return numint;
+		case MSK_PAR_DOU_TYPE: return numdou;
+		case MSK_PAR_STR_TYPE: return numstr;
+		default:
+			throw msk_exception("A parameter type was not recognized");
+	}
+}
+
+const Parameter_table::entry& Parameter_table::get(MSKparametertypee type, MSKintt index) const
+{
+	switch (type) {
+		case MSK_PAR_INT_TYPE: return params[index];
+		case MSK_PAR_DOU_TYPE: return params[numint + index];
+		case MSK_PAR_STR_TYPE: return params[numint + numdou + index];
+		default:
+			throw msk_exception("A parameter type was not recognized");
+	}
+}
+
+void Parameter_table::initdefaults()
+{
+	if (hasdefaults)
+		return;
+
+	if (!initialized)
+		throw msk_exception("Internal error in Parameter_table::initdefaults, the table was not built");
+
+	printdebug("Taking a snapshot of the default MOSEK parameters");
+
+	global_env.init();
+	Task_handle task;
+	task.init(global_env, 0, 0);
+
+	intdefaults.resize(numint);
+	for (MSKintt v = 0; v < numint; ++v)
+		errcatch( MSK_getintparam(task, static_cast<MSKiparame>(get(MSK_PAR_INT_TYPE, v).index), &intdefaults[v]) );
+
+	doudefaults.resize(numdou);
+	for (MSKintt v = 0; v < numdou; ++v)
+		errcatch( MSK_getdouparam(task, static_cast<MSKdparame>(get(MSK_PAR_DOU_TYPE, v).index), &doudefaults[v]) );
+
+	strdefaults.resize(numstr);
+	for (MSKintt v = 0; v < numstr; ++v) {
+		MSKsparame param = static_cast<MSKsparame>(get(MSK_PAR_STR_TYPE, v).index);
+
+		size_t strlength;
+		errcatch( MSK_getstrparam(task, param, 0, &strlength, NULL) );
+
+		vector<char> value(strlength + 1);
+		errcatch( MSK_getstrparam(task, param, strlength + 1, NULL, &value[0]) );
+		strdefaults[v] = &value[0];
+	}
+
+	hasdefaults = true;
+}
+
+MSKintt Parameter_table::intdefault(MSKintt index)
+{
+	initdefaults();
+	return intdefaults[index - MSK_IPAR_BEGIN];
+}
+
+MSKrealt Parameter_table::doudefault(MSKintt index)
+{
+	initdefaults();
+	return doudefaults[index - MSK_DPAR_BEGIN];
+}
+
+const string& Parameter_table::strdefault(MSKintt index)
+{
+	initdefaults();
+	return strdefaults[index - MSK_SPAR_BEGIN];
+}
+
+bool Parameter_table::symvalue(const string &valuename, MSKintt *value)
+{
+	string key = valuename;
+	strtoupper(key);
+	strip_mskprefix(key, "MSK_");
+
+	map<string, MSKintt>::iterator it = symvalues.find(key);
+	if (it == symvalues.end()) {
+		char mskvaluestr[MSK_MAX_STR_LEN];
+		string mskname = "MSK_" + key;
+		if (!MSK_symnamtovalue(const_cast<MSKCONST char*>(mskname.c_str()), mskvaluestr))
+			return false;
+
+		it = symvalues.insert(pair<string, MSKintt>(key, atoi(mskvaluestr))).first;
+	}
+
+	*value = it->second;
+	return true;
+}
+
+const string& Parameter_table::symname(MSKiparame param, MSKintt value)
+{
+	pair<MSKintt, MSKintt> key(param, value);
+
+	map<pair<MSKintt, MSKintt>, string>::iterator it = symnames.find(key);
+	if (it == symnames.end()) {
+		char valuename[MSK_MAX_STR_LEN];
+		errcatch( MSK_iparvaltosymnam(global_env, param, value, valuename) );
+
+		string valuestr = valuename;
+		strip_mskprefix(valuestr, "MSK_");
+		it = symnames.insert(pair<pair<MSKintt, MSKintt>, string>(key, valuestr)).first;
+	}
+
+	return it->second;
+}
+
+
+// ------------------------------
+// Class Parameter_profile
+// ------------------------------
+
+void Parameter_profile::apply(MSKtask_t task) const
+{
+	for (size_t i = 0; i < iparam.size(); ++i)
+		errcatch( MSK_putintparam(task, iparam[i].first, iparam[i].second) );
+
+	for (size_t i = 0; i < dparam.size(); ++i)
+		errcatch( MSK_putdouparam(task, dparam[i].first, dparam[i].second) );
+
+	for (size_t i = 0; i < sparam.size(); ++i)
+		errcatch( MSK_putstrparam(task, sparam[i].first, const_cast<MSKCONST char*>(sparam[i].second.c_str())) );
+}
+
+void Parameter_profile::apply(Task_handle &task) const
+{
+	if (!stamp.empty() && task.paramstamp == stamp) {
+		printdebug("Parameter profile " + stamp + " is already applied to the task");
+		return;
+	}
+
+	task.paramstamp.clear();
+	apply(static_cast<MSKtask_t>(task));
+	task.paramstamp = stamp;
+}
+
+
+// ------------------------------
+// Class Profile_registry
+// ------------------------------
+
+void Profile_registry::define(const string &name, Parameter_profile &profile)
+{
+	Parameter_profile &entry = profiles[name];
+	entry.iparam.swap(profile.iparam);
+	entry.dparam.swap(profile.dparam);
+	entry.sparam.swap(profile.sparam);
+	entry.stamp = name + "#" + tostring(++generation);
+}
+
+const Parameter_profile& Profile_registry::get(const string &name) const
+{
+	map<string, Parameter_profile>::const_iterator it = profiles.find(name);
+	if (it == profiles.end())
+		throw msk_exception("No parameter profile is named '" + name + "'");
+
+	return it->second;
+}
+
+void Profile_registry::remove(const string &name)
+{
+	profiles.erase(name);
+}
+
+void Profile_registry::clear()
+{
+	profiles.clear();
+}
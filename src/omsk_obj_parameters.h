@@ -0,0 +1,139 @@
+#ifndef OMSK_OBJ_PARAMETERS_H_
+#define OMSK_OBJ_PARAMETERS_H_
+
+#include "omsk_msg_mosek.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <stdint.h>
+
+// ------------------------------
+// Global variable: Table of MOSEK parameters
+// ------------------------------
+//
+// Maps parameter names (without the MSK_IPAR_, MSK_DPAR_ and MSK_SPAR_ prefix)
+// to their type and index through a perfect hash built on first use, and
+// memoizes the symbolic names of integer parameter values in both directions.
+// The table needs a task to be built, and is kept until the library is unloaded
+// as parameter names do not change with the MOSEK environment.
+//
+extern class Parameter_table {
+public:
+	struct entry {
+		std::string			name;
+		MSKparametertypee	type;
+		MSKintt				index;
+	};
+
+private:
+	bool initialized;
+
+	// Parameters in the order of their type and index
+	std::vector<entry> params;
+	MSKintt numint, numdou, numstr;
+
+	// Hash-and-displace: 'displace[h(key,0) % numbuckets]' is the seed leading
+	// the key to its own slot in 'slots' (holding an index into 'params')
+	std::vector<uint32_t> displace;
+	std::vector<int> slots;
+
+	// Default values of all parameters (snapshot of a fresh task taken on demand)
+	bool hasdefaults;
+	std::vector<MSKintt> intdefaults;
+	std::vector<MSKrealt> doudefaults;
+	std::vector<std::string> strdefaults;
+
+	// Memoized symbolic values, e.g. "ON" <-> MSK_ON
+	std::map<std::string, MSKintt> symvalues;
+	std::map<std::pair<MSKintt, MSKintt>, std::string> symnames;
+
+	static uint32_t hash(const std::string &key, uint32_t seed);
+	static std::string hashkey(MSKparametertypee type, const std::string &name);
+	void buildhash();
+
+	// Overwrite copy constructor and provide no implementation
+	Parameter_table(const Parameter_table& that);
+
+public:
+	Parameter_table()	{ initialized = false; hasdefaults = false; }
+
+	// Builds the table (only the first call has an effect)
+	void init(MSKtask_t task);
+
+	// Finds a parameter by type ("iparam", "dparam" or "sparam") and name, where
+	// the name is case-insensitive and may include the MOSEK prefix (throws if unknown)
+	const entry& find(const std::string &type, const std::string &name);
+
+	// Parameters of one type in the order of their index
+	MSKintt size(MSKparametertypee type) const;
+	const entry& get(MSKparametertypee type, MSKintt index) const;
+
+	// Default values by parameter index (the table must be built)
+	void initdefaults();
+	MSKintt intdefault(MSKintt index);
+	MSKrealt doudefault(MSKintt index);
+	const std::string& strdefault(MSKintt index);
+
+	// Converts symbolic integer values, e.g. "MSK_ON" or "on" (returns false if unknown)
+	bool symvalue(const std::string &valuename, MSKintt *value);
+
+	// Converts integer values to symbolic names without prefix (empty if none)
+	const std::string& symname(MSKiparame param, MSKintt value);
+
+} global_params;
+
+
+// ------------------------------
+// Class Parameter_profile
+// ------------------------------
+//
+// A validated set of parameters compiled to (index, value) pairs, such that
+// applying it involves no string handling. The stamp identifies the profile
+// definition, and lets 'apply' skip tasks on which it has already been applied.
+//
+class Task_handle;
+
+class Parameter_profile {
+public:
+	std::vector< std::pair<MSKiparame, MSKintt> > iparam;
+	std::vector< std::pair<MSKdparame, MSKrealt> > dparam;
+	std::vector< std::pair<MSKsparame, std::string> > sparam;
+
+	// Unique for each definition of a profile (empty for anonymous sets)
+	std::string stamp;
+
+	size_t size() const	{ return iparam.size() + dparam.size() + sparam.size(); }
+
+	// Puts all parameters on the task
+	void apply(MSKtask_t task) const;
+
+	// Puts all parameters on the task, unless this profile was the last one applied
+	void apply(Task_handle &task) const;
+};
+
+
+// ------------------------------
+// Global variable: Registry of named parameter profiles
+// ------------------------------
+extern class Profile_registry {
+private:
+	std::map<std::string, Parameter_profile> profiles;
+	long generation;
+
+	// Overwrite copy constructor and provide no implementation
+	Profile_registry(const Profile_registry& that);
+
+public:
+	Profile_registry()	{ generation = 0; }
+
+	// Defines (or redefines) a named profile, taking over its parameters
+	void define(const std::string &name, Parameter_profile &profile);
+	const Parameter_profile& get(const std::string &name) const;
+	void remove(const std::string &name);
+	void clear();
+
+} global_profiles;
+
+#endif /* OMSK_OBJ_PARAMETERS_H_ */
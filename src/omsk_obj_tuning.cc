@@ -0,0 +1,441 @@
+#include "omsk_obj_tuning.h"
+
+#include "omsk_utils_octave.h"
+#include "omsk_utils_mosek.h"
+#include "omsk_utils_threads.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using std::string;
+using std::vector;
+
+
+// ------------------------------
+// Class tuning_type
+// ------------------------------
+
+const tuning_type::OCT_ARGS_type tuning_type::OCT_ARGS;
+
+// Default values of optional arguments
+tuning_type::tuning_type() :
+	initialized(false),
+
+	threads(2),
+	budget(NAN),
+	trialtime(NAN),
+	killratio(2),
+	maxtrials(256),
+	profile("")
+{}
+
+void tuning_type::OCT_read(Octave_map &arglist) {
+	printdebug("Reading tuning arguments");
+
+	map_seek_Scalar(&threads, arglist, OCT_ARGS.threads, true);
+	map_seek_Scalar(&budget, arglist, OCT_ARGS.budget, true);
+	map_seek_Scalar(&trialtime, arglist, OCT_ARGS.trialtime, true);
+	map_seek_Scalar(&killratio, arglist, OCT_ARGS.killratio, true);
+	map_seek_Scalar(&maxtrials, arglist, OCT_ARGS.maxtrials, true);
+	map_seek_String(&profile, arglist, OCT_ARGS.profile, true);
+
+	if (xisnan(threads) || threads < 1)
+		throw msk_exception("Variable \"" + OCT_ARGS.threads + "\" should be a positive integer");
+
+	if (budget <= 0 || trialtime <= 0)
+		throw msk_exception("Variables \"" + OCT_ARGS.budget + "\" and \"" + OCT_ARGS.trialtime + "\" should be positive numbers of seconds");
+
+	if (killratio < 1)
+		throw msk_exception("Variable \"" + OCT_ARGS.killratio + "\" should be at least 1");
+
+	if (xisnan(maxtrials) || maxtrials < 1)
+		throw msk_exception("Variable \"" + OCT_ARGS.maxtrials + "\" should be a positive integer");
+
+	// Leave the remaining options to 'options_type'
+	for (size_t i = 0; i < OCT_ARGS.arglist.size(); ++i)
+		if (arglist.contains(OCT_ARGS.arglist[i]))
+			arglist.del(OCT_ARGS.arglist[i]);
+
+	initialized = true;
+}
+
+
+// ------------------------------
+// Class tuning_trial
+// ------------------------------
+
+tuning_trial::tuning_trial() :
+	status(SKIPPED),
+	reason(""),
+	response(MSK_RES_OK),
+	trmcode(MSK_RES_OK),
+	time(NAN),
+	hassol(false),
+	soltype(MSK_SOL_ITR),
+	solsta(MSK_SOL_STA_UNKNOWN),
+	solstastr(""),
+	quality(3),
+	primalobj(NAN)
+{}
+
+
+// ------------------------------
+// Search space
+// ------------------------------
+
+struct tuning_dimension {
+	string type;
+	string name;
+	vector<octave_value> values;
+};
+
+/* This function reads the candidate values of each parameter in the search space. */
+static void read_searchspace(vector<tuning_dimension> &dims, Octave_map &space)
+{
+	const string types[] = {"iparam", "dparam", "sparam"};
+	validate_OctaveMap(space, "space", vector<string>(types, types + 3));
+
+	for (int t = 0; t < 3; ++t) {
+		Octave_map params;
+		map_seek_OctaveMap(&params, space, types[t], true);
+
+		for (Octave_map::const_iterator it = params.begin(); it != params.end(); ++it) {
+			tuning_dimension dim;
+			dim.type = types[t];
+			dim.name = params.key(it);
+
+			octave_value candidates = params.contents(it)(0);
+			if (candidates.is_cell()) {
+				Cell cell = candidates.cell_value();
+				for (octave_idx_type i = 0; i < cell.numel(); ++i)
+					dim.values.push_back(cell(i));
+
+			} else if (candidates.is_string()) {
+				dim.values.push_back(candidates);
+
+			} else if (candidates.is_numeric_type() || candidates.is_bool_type()) {
+				NDArray array = candidates.array_value();
+				for (octave_idx_type i = 0; i < array.numel(); ++i)
+					dim.values.push_back(octave_value(array(i)));
+
+			} else {
+				throw msk_exception("The candidates of parameter '" + dim.name + "' in the search space should be a vector, a string or a cell array");
+			}
+
+			if (dim.values.empty())
+				throw msk_exception("The parameter '" + dim.name + "' in the search space has no candidates");
+
+			dims.push_back(dim);
+		}
+	}
+}
+
+
+// ------------------------------
+// Running trials
+// ------------------------------
+
+struct tuning_state {
+	const tuning_type *settings;
+	vector<tuning_trial> *trials;
+	MSKtask_t source;
+	MSKintt numthreads;
+
+	msk_mutex mutex;
+	msk_mutex clonemutex;		// Serializes the reads of 'source' by MSK_clonetask
+	double start;
+	double besttime;
+};
+
+struct tuning_cbdata {
+	tuning_state *state;
+	tuning_trial *trial;
+	double start;
+};
+
+/* The callback kills trials that can no longer win (runs on worker threads). */
+static int MSKAPI tuning_callback(MSKtask_t task, MSKuserhandle_t handle, MSKcallbackcodee caller) {
+	tuning_cbdata *cbdata = static_cast<tuning_cbdata*>(handle);
+	const tuning_type &settings = *cbdata->state->settings;
+
+	double now = get_walltime();
+	double elapsed = now - cbdata->start;
+
+	double besttime;
+	{
+		msk_lock lock(cbdata->state->mutex);
+		besttime = cbdata->state->besttime;
+	}
+
+	string reason;
+	if (octave_signal_caught)
+		reason = "interrupt";
+	else if (!xisnan(settings.trialtime) && elapsed > settings.trialtime)
+		reason = "trialtime";
+	else if (!xisnan(settings.budget) && now - cbdata->state->start > settings.budget)
+		reason = "budget";
+	else if (!xisnan(settings.killratio) && !xisinf(besttime) && elapsed > settings.killratio * besttime)
+		reason = "killratio";
+
+	if (reason.empty())
+		return 0;
+
+	cbdata->trial->status = tuning_trial::KILLED;
+	cbdata->trial->reason = reason;
+	return 1;
+}
+
+/* Ranks a solution status: 0 for optimal (or certificates), 1 for near optimal, 2 otherwise. */
+static int tuning_quality(MSKsolstae solsta)
+{
+	switch (solsta) {
+		case MSK_SOL_STA_OPTIMAL:
+		case MSK_SOL_STA_INTEGER_OPTIMAL:
+		case MSK_SOL_STA_PRIM_INFEAS_CER:
+		case MSK_SOL_STA_DUAL_INFEAS_CER:
+			return 0;
+		case MSK_SOL_STA_NEAR_OPTIMAL:
+		case MSK_SOL_STA_NEAR_INTEGER_OPTIMAL:
+		case MSK_SOL_STA_NEAR_PRIM_INFEAS_CER:
+		case MSK_SOL_STA_NEAR_DUAL_INFEAS_CER:
+			return 1;
+		default:
+			return 2;
+	}
+}
+
+// Owns the cloned task of one trial (the clone has no log stream)
+class Trial_task {
+public:
+	MSKtask_t task;
+
+	Trial_task() : task(NULL) {}
+	~Trial_task() {
+		if (task != NULL)
+			MSK_deletetask(&task);
+	}
+};
+
+/* This function solves one trial on a clone of the task, deleted when the trial ends (runs on worker threads). */
+static void tuning_job(int i, void *data)
+{
+	tuning_state *state = static_cast<tuning_state*>(data);
+	tuning_trial &trial = (*state->trials)[i];
+
+	if (octave_signal_caught) {
+		trial.status = tuning_trial::SKIPPED;
+		trial.reason = "interrupt";
+		return;
+	}
+
+	if (!xisnan(state->settings->budget) && get_walltime() - state->start > state->settings->budget) {
+		trial.status = tuning_trial::SKIPPED;
+		trial.reason = "budget";
+		return;
+	}
+
+	Trial_task clone;
+	{
+		msk_lock lock(state->clonemutex);
+		errcatch( MSK_clonetask(state->source, &clone.task) );
+	}
+	MSKtask_t task = clone.task;
+
+	// Share the processors among the trials (before the search space may overwrite it)
+	MSKintt numthreads;
+	errcatch( MSK_getintparam(task, MSK_IPAR_NUM_THREADS, &numthreads) );
+	if (numthreads == 0)
+		errcatch( MSK_putintparam(task, MSK_IPAR_NUM_THREADS, state->numthreads) );
+
+	trial.profile.apply(task);
+
+	tuning_cbdata cbdata;
+	cbdata.state = state;
+	cbdata.trial = &trial;
+	cbdata.start = get_walltime();
+
+	trial.status = tuning_trial::FINISHED;
+	errcatch( MSK_putcallbackfunc(task, tuning_callback, &cbdata) );
+	trial.response = MSK_optimizetrm(task, &trial.trmcode);
+	trial.time = get_walltime() - cbdata.start;
+	MSK_putcallbackfunc(task, NULL, NULL);
+
+	if (trial.response != MSK_RES_OK) {
+		trial.status = tuning_trial::FAILED;
+		trial.reason = "response";
+		return;
+	}
+
+	if (trial.status == tuning_trial::FINISHED) {
+		msk_lock lock(state->mutex);
+		state->besttime = std::min(state->besttime, trial.time);
+	}
+
+	// The objective of the most specific solution (integer, basic, interior-point)
+	const MSKsoltypee soltypes[] = {MSK_SOL_ITG, MSK_SOL_BAS, MSK_SOL_ITR};
+	for (int s = 0; s < 3 && !trial.hassol; ++s) {
+		MSKintt isdef;
+		errcatch( MSK_solutiondef(task, soltypes[s], &isdef) );
+
+		if (isdef) {
+			MSKprostae prosta;
+			errcatch( MSK_getsolutionstatus(task, soltypes[s], &prosta, &trial.solsta) );
+			errcatch( MSK_getprimalobj(task, soltypes[s], &trial.primalobj) );
+
+			char sta_str[MSK_MAX_STR_LEN];
+			errcatch( MSK_solstatostr(task, trial.solsta, sta_str) );
+			trial.solstastr = sta_str;
+			trial.soltype = soltypes[s];
+			trial.quality = tuning_quality(trial.solsta);
+			trial.hassol = true;
+		}
+	}
+}
+
+/* Finished trials first, then by quality of the solution status, and then by time for
+ * optimal solutions and by objective for the others (ties and remaining groups by time). */
+struct tuning_less {
+	bool isminimize;
+
+	explicit tuning_less(bool isminimize) : isminimize(isminimize) {}
+
+	bool operator()(const tuning_trial *a, const tuning_trial *b) const;
+};
+
+bool tuning_less::operator()(const tuning_trial *a, const tuning_trial *b) const
+{
+	bool afinished = (a->status == tuning_trial::FINISHED);
+	bool bfinished = (b->status == tuning_trial::FINISHED);
+	if (afinished != bfinished)
+		return afinished;
+
+	if (a->quality != b->quality)
+		return a->quality < b->quality;
+
+	if (a->quality > 0 && a->hassol && a->primalobj != b->primalobj) {
+		if (xisnan(a->primalobj) || xisnan(b->primalobj))
+			return !xisnan(a->primalobj);
+		return isminimize ? (a->primalobj < b->primalobj) : (a->primalobj > b->primalobj);
+	}
+
+	if (xisnan(a->time) || xisnan(b->time))
+		return !xisnan(a->time) && xisnan(b->time);
+
+	return a->time < b->time;
+}
+
+static string tuning_status(const tuning_trial &trial)
+{
+	switch (trial.status) {
+		case tuning_trial::SKIPPED:		return "skipped";
+		case tuning_trial::FINISHED:	return "finished";
+		case tuning_trial::KILLED:		return "killed";
+		case tuning_trial::FAILED:		return "failed";
+		default:
+			throw msk_exception("Internal error in tuning_status, unknown status");
+	}
+}
+
+void msk_tune(Octave_map &ret_val, Task_handle &task, Octave_map &space, const tuning_type &settings)
+{
+	printdebug("msk_tune called");
+
+	// Expand the search space into parameter sets
+	vector<tuning_dimension> dims;
+	read_searchspace(dims, space);
+
+	double numtrials = 1;
+	for (size_t d = 0; d < dims.size(); ++d)
+		numtrials *= dims[d].values.size();
+
+	if (numtrials > settings.maxtrials)
+		throw msk_exception("The search space has " + tostring(numtrials) + " parameter sets, more than 'maxtrials' (" + tostring(settings.maxtrials) + ")");
+
+	int n = static_cast<int>(numtrials);
+	vector<tuning_trial> trials(n);
+	vector<Octave_map> trialparams(n * 3);
+
+	for (int i = 0; i < n; ++i) {
+		int index = i;
+		for (size_t d = 0; d < dims.size(); ++d) {
+			const tuning_dimension &dim = dims[d];
+			const octave_value &value = dim.values[index % dim.values.size()];
+			index /= dim.values.size();
+
+			compile_parameter(task, dim.type, dim.name, value, trials[i].profile);
+
+			int t = (dim.type == "iparam") ? 0 : (dim.type == "dparam") ? 1 : 2;
+			trialparams[3*i + t].assign(dim.name, value);
+		}
+	}
+
+	// Run the trials in parallel, each on a clone of the task
+	int numworkers = std::max(1, std::min(n, scalar2int(settings.threads)));
+	printinfo("Running " + tostring(n) + " tuning trial(s) on " + tostring(numworkers) + " thread(s)");
+
+	tuning_state state;
+	state.settings = &settings;
+	state.trials = &trials;
+	state.source = task;
+	state.numthreads = std::max(1, get_numprocessors() / numworkers);
+	state.start = get_walltime();
+	state.besttime = INFINITY;
+
+	run_parallel(tuning_job, &state, n, numworkers);
+
+	if (octave_signal_caught)
+		throw msk_exception("Tuning was interrupted");
+
+	// Rank the trials and convert them to Octave
+	MSKobjsensee sense;
+	errcatch( MSK_getobjsense(task, &sense) );
+
+	vector<const tuning_trial*> ranked(n);
+	for (int i = 0; i < n; ++i)
+		ranked[i] = &trials[i];
+	std::stable_sort(ranked.begin(), ranked.end(), tuning_less(sense != MSK_OBJECTIVE_SENSE_MAXIMIZE));
+
+	Cell iparam(dim_vector(n, 1)), dparam(dim_vector(n, 1)), sparam(dim_vector(n, 1));
+	Cell status(dim_vector(n, 1)), reason(dim_vector(n, 1)), time(dim_vector(n, 1));
+	Cell response(dim_vector(n, 1)), solsta(dim_vector(n, 1)), pobj(dim_vector(n, 1));
+
+	for (int k = 0; k < n; ++k) {
+		const tuning_trial &trial = *ranked[k];
+		int i = static_cast<int>(ranked[k] - &trials[0]);
+
+		iparam(k) = octave_value(trialparams[3*i + 0]);
+		dparam(k) = octave_value(trialparams[3*i + 1]);
+		sparam(k) = octave_value(trialparams[3*i + 2]);
+		status(k) = octave_value(tuning_status(trial), '\"');
+		reason(k) = octave_value(trial.reason, '\"');
+		time(k) = octave_value(trial.time);
+		response(k) = octave_value(static_cast<double>(trial.response));
+
+		solsta(k) = octave_value(trial.solstastr, '\"');
+		pobj(k) = octave_value(trial.primalobj);
+	}
+
+	Octave_map table(dim_vector(n, 1));
+	table.assign("iparam", iparam);
+	table.assign("dparam", dparam);
+	table.assign("sparam", sparam);
+	table.assign("status", status);
+	table.assign("reason", reason);
+	table.assign("time", time);
+	table.assign("response", response);
+	table.assign("solsta", solsta);
+	table.assign("pobj", pobj);
+	ret_val.assign("trials", octave_value(table));
+
+	// Export the best parameter set
+	if (!settings.profile.empty()) {
+		if (n == 0 || ranked[0]->status != tuning_trial::FINISHED)
+			throw msk_exception("No tuning trial finished, so no parameter profile was exported");
+
+		Parameter_profile best = ranked[0]->profile;
+		global_profiles.define(settings.profile, best);
+		ret_val.assign("profile", octave_value(settings.profile, '\"'));
+	}
+}
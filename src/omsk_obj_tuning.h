@@ -0,0 +1,111 @@
+#ifndef OMSK_OBJ_TUNING_H_
+#define OMSK_OBJ_TUNING_H_
+
+#include "omsk_msg_mosek.h"
+#include "omsk_obj_mosek.h"
+#include "omsk_obj_parameters.h"
+
+#include <octave/oct.h>
+#include <octave/ov-struct.h>
+
+#include <string>
+#include <vector>
+
+// ------------------------------
+// Class tuning_type
+// ------------------------------
+class tuning_type {
+private:
+	bool initialized;
+
+public:
+	// Recognised tuning arguments in Octave (given among the options of mosek_tune)
+	// TODO: Upgrade to new C++11 initialisers
+	static const struct OCT_ARGS_type {
+
+		std::vector<std::string> arglist;
+		const std::string threads;
+		const std::string budget;
+		const std::string trialtime;
+		const std::string killratio;
+		const std::string maxtrials;
+		const std::string profile;
+
+		OCT_ARGS_type() :
+			threads("threads"),
+			budget("budget"),
+			trialtime("trialtime"),
+			killratio("killratio"),
+			maxtrials("maxtrials"),
+			profile("profile")
+		{
+			std::string temp[] = {threads, budget, trialtime, killratio, maxtrials, profile};
+			arglist = std::vector<std::string>(temp, temp + sizeof(temp)/sizeof(std::string));
+		}
+	} OCT_ARGS;
+
+
+	// Data definition (NaN means no limit)
+	double		threads;
+	double		budget;
+	double		trialtime;
+	double		killratio;
+	double		maxtrials;
+	std::string	profile;
+
+	// Default values of optional arguments
+	tuning_type();
+
+	// Read tuning arguments from Octave, removing them from 'arglist' such that
+	// the remaining options can be read by 'options_type' (write not implemented)
+	void OCT_read(Octave_map &arglist);
+};
+
+
+// ------------------------------
+// Class tuning_trial
+// ------------------------------
+//
+// The outcome of solving the problem with one parameter set. Filled in by the
+// worker threads, and therefore free of Octave values.
+//
+struct tuning_trial {
+	Parameter_profile profile;
+
+	enum { SKIPPED, FINISHED, KILLED, FAILED } status;
+	std::string	reason;
+	MSKrescodee	response;
+	MSKrescodee	trmcode;
+	double		time;
+
+	bool		hassol;
+	MSKsoltypee	soltype;
+	MSKsolstae	solsta;
+	std::string	solstastr;
+	int			quality;
+	double		primalobj;
+
+	tuning_trial();
+};
+
+
+// ------------------------------
+// Tuning
+// ------------------------------
+//
+// Expands the search space (structures 'iparam', 'dparam' and 'sparam' of
+// candidate values per parameter) into parameter sets, and solves a clone of
+// 'task' with each set on a pool of worker threads, sharing the processors
+// among the trials unless the number of threads of MOSEK is given. Each clone
+// is made when its trial starts and deleted when it ends, such that at most one
+// clone per worker thread is held at any time. Trials are
+// killed through the callback when they exceed 'trialtime', the total
+// 'budget', or 'killratio' times the fastest finished trial, or when CTRL+C is
+// pressed. The trials are returned ranked with finished trials first, then by
+// the quality of the solution status, and then by time (optimal solutions) or
+// objective (other solutions). The best one is exported as a parameter
+// profile if requested.
+//
+void msk_tune(Octave_map &ret_val, Task_handle &task, Octave_map &space, const tuning_type &settings);
+
+#endif /* OMSK_OBJ_TUNING_H_ */
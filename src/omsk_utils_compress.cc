@@ -0,0 +1,689 @@
+#include "omsk_utils_compress.h"
+
+#include "omsk_utils_threads.h"
+#include "omsk_utils_mosek.h"
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cctype>
+#include <cerrno>
+#include <exception>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <signal.h>
+#define OMSK_PIPE
+#endif
+
+#if defined(OMSK_HAVE_ZSTD) && defined(OMSK_PIPE)
+#include <zstd.h>
+#define OMSK_ZSTD_PIPE
+#endif
+
+using std::string;
+using std::vector;
+
+
+// ------------------------------
+// File extensions
+// ------------------------------
+
+/* This function returns the lowercase extension of a path (without the dot). */
+static string get_extension(const string &filepath)
+{
+	size_t dot = filepath.find_last_of('.');
+	size_t sep = filepath.find_last_of("/\\");
+	if (dot == string::npos || (sep != string::npos && dot < sep))
+		return "";
+
+	string ext = filepath.substr(dot + 1);
+	for (size_t i = 0; i < ext.length(); ++i)
+		ext[i] = tolower(ext[i]);
+
+	return ext;
+}
+
+msk_compresstype get_compresstype(const string &filepath, string &innerpath)
+{
+	string ext = get_extension(filepath);
+
+	msk_compresstype type = OMSK_COMPRESS_NONE;
+	if (ext == "gz")
+		type = OMSK_COMPRESS_GZIP;
+	else if (ext == "zst")
+		type = OMSK_COMPRESS_ZSTD;
+
+	innerpath = (type == OMSK_COMPRESS_NONE) ? filepath : filepath.substr(0, filepath.length() - ext.length() - 1);
+	return type;
+}
+
+/* This function looks up the data format of a lowercase extension, and returns false if unknown. */
+static bool find_mskdataformat(const string &ext, MSKdataformate &format)
+{
+	if (ext == "mps")		format = MSK_DATA_FORMAT_MPS;
+	else if (ext == "lp")	format = MSK_DATA_FORMAT_LP;
+	else if (ext == "opf")	format = MSK_DATA_FORMAT_OP;
+	else if (ext == "mbt")	format = MSK_DATA_FORMAT_MBT;
+	else if (ext == "xml")	format = MSK_DATA_FORMAT_XML;
+	else return false;
+
+	return true;
+}
+
+MSKdataformate get_mskdataformat(const string &filepath)
+{
+	MSKdataformate format;
+	if (!find_mskdataformat(get_extension(filepath), format))
+		throw msk_exception("The format of model file '" + filepath + "' could not be determined from its extension");
+
+	return format;
+}
+
+bool has_solutionformat(const string &filepath)
+{
+	string innerpath;
+	get_compresstype(filepath, innerpath);
+
+	MSKdataformate format;
+	if (!find_mskdataformat(get_extension(innerpath), format))
+		return false;
+
+	return (format == MSK_DATA_FORMAT_OP || format == MSK_DATA_FORMAT_MBT);
+}
+
+MSKdataformate get_mskdataformat_byname(const string &name)
+{
+	string ext = name;
+	for (size_t i = 0; i < ext.length(); ++i)
+		ext[i] = tolower(ext[i]);
+
+	MSKdataformate format;
+	if (!find_mskdataformat(ext, format))
+		throw msk_exception("The model format '" + name + "' is unknown (should be 'mps', 'lp', 'opf', 'mbt' or 'xml')");
+
+	return format;
+}
+
+
+// ------------------------------
+// Temporary parameter settings
+// ------------------------------
+
+// Sets an integer parameter, and restores the former value on destruction
+class Intparam_guard {
+private:
+	MSKtask_t	task;
+	MSKiparame	param;
+	MSKintt		value;
+
+	// Overwrite copy constructor and provide no implementation
+	Intparam_guard(const Intparam_guard& that);
+
+public:
+	Intparam_guard(MSKtask_t task, MSKiparame param, MSKintt newvalue) : task(task), param(param) {
+		errcatch( MSK_getintparam(task, param, &value) );
+		errcatch( MSK_putintparam(task, param, newvalue) );
+	}
+	~Intparam_guard() {
+		MSK_putintparam(task, param, value);
+	}
+};
+
+
+// ------------------------------
+// Pipes to MOSEK
+// ------------------------------
+//
+// MOSEK only reads and writes named files, so streamed data is passed through
+// a pipe with a thread on one end, and MOSEK on the other by its "/dev/fd/<n>"
+// path. The format must be set by parameters, as the path has no extension.
+//
+#ifdef OMSK_PIPE
+
+/* This function writes all bytes to a pipe, and returns false if the reader has stopped. */
+static bool write_pipe(int fd, const char *data, size_t bytes)
+{
+	while (bytes > 0) {
+		ssize_t n = write(fd, data, bytes);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EPIPE)
+				return false;
+			throw msk_exception("The pipe to MOSEK could not be written");
+		}
+		data += n;
+		bytes -= n;
+	}
+	return true;
+}
+
+/* This function makes a reader stopping early give EPIPE in this thread rather than a signal. */
+static void block_sigpipe()
+{
+	sigset_t set;
+	sigemptyset(&set);
+	sigaddset(&set, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &set, NULL);
+}
+
+/* This function returns the path by which MOSEK can open a file descriptor. */
+static string fd_devpath(int fd)
+{
+	return "/dev/fd/" + tostring(fd);
+}
+
+struct buffer_job {
+	const char		*data;		/* The buffer to feed (when reading) */
+	size_t			bytes;
+	vector<char>	*output;	/* The buffer to fill (when writing) */
+	int				fd;			/* The end of the pipe owned by the buffer thread */
+	string			error;
+};
+
+static void buffer_threadmain(void *data)
+{
+	buffer_job &job = *static_cast<buffer_job*>(data);
+	block_sigpipe();
+
+	try {
+		if (job.output == NULL) {
+			// A reader stopping early is reported by MOSEK, not here
+			write_pipe(job.fd, job.data, job.bytes);
+
+		} else {
+			char chunk[65536];
+			ssize_t n;
+			while ((n = read(job.fd, chunk, sizeof(chunk))) > 0 || (n < 0 && errno == EINTR)) {
+				if (n > 0)
+					job.output->insert(job.output->end(), chunk, chunk + n);
+			}
+			if (n < 0)
+				throw msk_exception("The pipe from MOSEK could not be read");
+		}
+
+	} catch (std::exception const& e) {
+		job.error = e.what();
+	}
+
+	close(job.fd);
+}
+
+// A pipe with a thread feeding or draining an in-memory buffer on one end
+class Buffer_pipe {
+private:
+	buffer_job	job;
+	int			localfd;
+	msk_thread	thread;
+
+	// Overwrite copy constructor and provide no implementation
+	Buffer_pipe(const Buffer_pipe& that);
+
+public:
+	Buffer_pipe(const char *data, size_t bytes, vector<char> *output) {
+		int fds[2];
+		if (pipe(fds) != 0)
+			throw msk_exception("A pipe to MOSEK could not be created");
+
+		job.data = data;
+		job.bytes = bytes;
+		job.output = output;
+		job.fd = (output == NULL) ? fds[1] : fds[0];
+		localfd = (output == NULL) ? fds[0] : fds[1];
+
+		try {
+			thread.start(buffer_threadmain, &job);
+		} catch (msk_exception const&) {
+			close(fds[0]);
+			close(fds[1]);
+			throw;
+		}
+	}
+
+	string devpath() const {
+		return fd_devpath(localfd);
+	}
+
+	// Closes this end of the pipe, waits for the thread and reports its errors
+	void finish() {
+		if (localfd >= 0)
+			close(localfd);
+		localfd = -1;
+
+		thread.join();
+		if (!job.error.empty())
+			throw msk_exception(job.error);
+	}
+
+	~Buffer_pipe() {
+		if (localfd >= 0)
+			close(localfd);
+		thread.join();
+	}
+};
+
+#endif /* OMSK_PIPE */
+
+
+// ------------------------------
+// Zstd codec threads
+// ------------------------------
+#ifdef OMSK_ZSTD_PIPE
+
+struct zstd_job {
+	string	filepath;
+	int		fd;				/* The end of the pipe owned by the codec thread */
+	bool	decompress;
+	string	error;
+};
+
+/* This function streams the decompressed file into the pipe (runs on the codec thread). */
+static void zstd_decompress(zstd_job &job)
+{
+	FILE *in = fopen(job.filepath.c_str(), "rb");
+	if (in == NULL)
+		throw msk_exception("The model file '" + job.filepath + "' could not be opened for reading");
+
+	ZSTD_DStream *stream = ZSTD_createDStream();
+	ZSTD_initDStream(stream);
+
+	vector<char> inbuf(ZSTD_DStreamInSize());
+	vector<char> outbuf(ZSTD_DStreamOutSize());
+
+	string error;
+	size_t n;
+	size_t ret = 0;		/* Zero when the last frame was completed */
+	bool reading = true;
+	while (reading && error.empty() && (n = fread(&inbuf[0], 1, inbuf.size(), in)) > 0) {
+		ZSTD_inBuffer input = { &inbuf[0], n, 0 };
+		while (input.pos < input.size) {
+			ZSTD_outBuffer output = { &outbuf[0], outbuf.size(), 0 };
+
+			ret = ZSTD_decompressStream(stream, &output, &input);
+			if (ZSTD_isError(ret)) {
+				error = "The model file '" + job.filepath + "' could not be decompressed (" + ZSTD_getErrorName(ret) + ")";
+				break;
+			}
+
+			// A reader stopping early is reported by MOSEK, not here
+			if (!write_pipe(job.fd, &outbuf[0], output.pos)) {
+				reading = false;
+				break;
+			}
+		}
+	}
+	if (error.empty() && ferror(in))
+		error = "The model file '" + job.filepath + "' could not be read";
+	else if (error.empty() && reading && ret != 0)
+		error = "The model file '" + job.filepath + "' could not be decompressed (the file ends inside a frame)";
+
+	ZSTD_freeDStream(stream);
+	fclose(in);
+
+	if (!error.empty())
+		throw msk_exception(error);
+}
+
+/* This function compresses the data of the pipe into the file (runs on the codec thread). */
+static void zstd_compress(zstd_job &job)
+{
+	FILE *out = fopen(job.filepath.c_str(), "wb");
+	if (out == NULL)
+		throw msk_exception("The model file '" + job.filepath + "' could not be opened for writing");
+
+	ZSTD_CStream *stream = ZSTD_createCStream();
+	ZSTD_initCStream(stream, 3);
+
+	vector<char> inbuf(ZSTD_CStreamInSize());
+	vector<char> outbuf(ZSTD_CStreamOutSize());
+
+	string error;
+	ssize_t n;
+	while (error.empty() && ((n = read(job.fd, &inbuf[0], inbuf.size())) > 0 || (n < 0 && errno == EINTR))) {
+		ZSTD_inBuffer input = { &inbuf[0], static_cast<size_t>(n > 0 ? n : 0), 0 };
+		while (input.pos < input.size) {
+			ZSTD_outBuffer output = { &outbuf[0], outbuf.size(), 0 };
+
+			size_t ret = ZSTD_compressStream(stream, &output, &input);
+			if (ZSTD_isError(ret)) {
+				error = string("The model could not be compressed (") + ZSTD_getErrorName(ret) + ")";
+				break;
+			}
+			if (fwrite(&outbuf[0], 1, output.pos, out) != output.pos) {
+				error = "The model file '" + job.filepath + "' could not be written";
+				break;
+			}
+		}
+	}
+
+	size_t remaining = error.empty() ? 1 : 0;
+	while (remaining > 0) {
+		ZSTD_outBuffer output = { &outbuf[0], outbuf.size(), 0 };
+
+		remaining = ZSTD_endStream(stream, &output);
+		if (ZSTD_isError(remaining)) {
+			error = string("The model could not be compressed (") + ZSTD_getErrorName(remaining) + ")";
+			break;
+		}
+		if (fwrite(&outbuf[0], 1, output.pos, out) != output.pos) {
+			error = "The model file '" + job.filepath + "' could not be written";
+			break;
+		}
+	}
+
+	ZSTD_freeCStream(stream);
+	if (fclose(out) != 0 && error.empty())
+		error = "The model file '" + job.filepath + "' could not be written";
+
+	if (!error.empty()) {
+		remove(job.filepath.c_str());
+
+		// Keep draining the pipe, such that MOSEK is never blocked
+		while ((n = read(job.fd, &inbuf[0], inbuf.size())) > 0 || (n < 0 && errno == EINTR)) {}
+
+		throw msk_exception(error);
+	}
+}
+
+static void zstd_threadmain(void *data)
+{
+	zstd_job &job = *static_cast<zstd_job*>(data);
+
+	block_sigpipe();
+
+	try {
+		if (job.decompress)
+			zstd_decompress(job);
+		else
+			zstd_compress(job);
+
+	} catch (std::exception const& e) {
+		job.error = e.what();
+	}
+
+	close(job.fd);
+}
+
+// A pipe with a codec thread on one end, and a path to the other end for MOSEK
+class Zstd_pipe {
+private:
+	zstd_job	job;
+	int			localfd;
+	msk_thread	thread;
+
+	// Overwrite copy constructor and provide no implementation
+	Zstd_pipe(const Zstd_pipe& that);
+
+public:
+	Zstd_pipe(const string &filepath, bool decompress) {
+		int fds[2];
+		if (pipe(fds) != 0)
+			throw msk_exception("A pipe to MOSEK could not be created");
+
+		job.filepath = filepath;
+		job.decompress = decompress;
+		job.fd = decompress ? fds[1] : fds[0];
+		localfd = decompress ? fds[0] : fds[1];
+
+		try {
+			thread.start(zstd_threadmain, &job);
+		} catch (msk_exception const&) {
+			close(fds[0]);
+			close(fds[1]);
+			throw;
+		}
+	}
+
+	string devpath() const {
+		return fd_devpath(localfd);
+	}
+
+	// Closes this end of the pipe, waits for the codec and reports its errors
+	void finish() {
+		if (localfd >= 0)
+			close(localfd);
+		localfd = -1;
+
+		thread.join();
+		if (!job.error.empty())
+			throw msk_exception(job.error);
+	}
+
+	~Zstd_pipe() {
+		if (localfd >= 0)
+			close(localfd);
+		thread.join();
+	}
+};
+
+#endif /* OMSK_ZSTD_PIPE */
+
+
+// ------------------------------
+// Reading and writing model files
+// ------------------------------
+
+void msk_readdata(MSKtask_t task, const string &filepath)
+{
+	string innerpath;
+	switch (get_compresstype(filepath, innerpath)) {
+
+		case OMSK_COMPRESS_NONE: {
+			errcatch( MSK_readdata(task, const_cast<MSKCONST char*>(filepath.c_str())) );
+			break;
+		}
+
+		// The format is given by the inner extension, e.g. ".mps" of "model.mps.gz"
+		case OMSK_COMPRESS_GZIP: {
+			Intparam_guard format(task, MSK_IPAR_READ_DATA_FORMAT, get_mskdataformat(innerpath));
+			Intparam_guard compress(task, MSK_IPAR_READ_DATA_COMPRESSED, MSK_COMPRESS_GZIP);
+			errcatch( MSK_readdata(task, const_cast<MSKCONST char*>(filepath.c_str())) );
+			break;
+		}
+
+		case OMSK_COMPRESS_ZSTD: {
+#ifdef OMSK_ZSTD_PIPE
+			Intparam_guard format(task, MSK_IPAR_READ_DATA_FORMAT, get_mskdataformat(innerpath));
+			Intparam_guard compress(task, MSK_IPAR_READ_DATA_COMPRESSED, MSK_COMPRESS_NONE);
+
+			Zstd_pipe pipe(filepath, true);
+			string devpath = pipe.devpath();
+			MSKrescodee r = MSK_readdata(task, const_cast<MSKCONST char*>(devpath.c_str()));
+
+			// Errors of the codec explain a truncated model, so they are reported first
+			pipe.finish();
+			errcatch( r );
+#else
+			throw msk_exception("The model file '" + filepath + "' is compressed by zstd, which this build of OctMOSEK does not support");
+#endif
+			break;
+		}
+	}
+}
+
+void msk_writedata(MSKtask_t task, const string &filepath)
+{
+	string innerpath;
+	switch (get_compresstype(filepath, innerpath)) {
+
+		case OMSK_COMPRESS_NONE: {
+			errcatch( MSK_writedata(task, const_cast<MSKCONST char*>(filepath.c_str())) );
+			break;
+		}
+
+		// The format is given by the inner extension, e.g. ".mps" of "model.mps.gz"
+		case OMSK_COMPRESS_GZIP: {
+			Intparam_guard format(task, MSK_IPAR_WRITE_DATA_FORMAT, get_mskdataformat(innerpath));
+			Intparam_guard compress(task, MSK_IPAR_WRITE_DATA_COMPRESSED, MSK_COMPRESS_GZIP);
+			errcatch( MSK_writedata(task, const_cast<MSKCONST char*>(filepath.c_str())) );
+			break;
+		}
+
+		case OMSK_COMPRESS_ZSTD: {
+#ifdef OMSK_ZSTD_PIPE
+			Intparam_guard format(task, MSK_IPAR_WRITE_DATA_FORMAT, get_mskdataformat(innerpath));
+			Intparam_guard compress(task, MSK_IPAR_WRITE_DATA_COMPRESSED, MSK_COMPRESS_NONE);
+
+			Zstd_pipe pipe(filepath, false);
+			string devpath = pipe.devpath();
+			MSKrescodee r = MSK_writedata(task, const_cast<MSKCONST char*>(devpath.c_str()));
+
+			// The codec finishes the file when this end of the pipe is closed
+			pipe.finish();
+			if (r != MSK_RES_OK)
+				remove(filepath.c_str());
+			errcatch( r );
+#else
+			throw msk_exception("The model file '" + filepath + "' should be compressed by zstd, which this build of OctMOSEK does not support");
+#endif
+			break;
+		}
+	}
+}
+
+
+// ------------------------------
+// Reading and writing in-memory models
+// ------------------------------
+
+void msk_readbuffer(MSKtask_t task, const char *data, size_t bytes, MSKdataformate format)
+{
+#ifdef OMSK_PIPE
+	Intparam_guard formatguard(task, MSK_IPAR_READ_DATA_FORMAT, format);
+	Intparam_guard compress(task, MSK_IPAR_READ_DATA_COMPRESSED, MSK_COMPRESS_NONE);
+
+	Buffer_pipe pipe(data, bytes, NULL);
+	string devpath = pipe.devpath();
+	MSKrescodee r = MSK_readdata(task, const_cast<MSKCONST char*>(devpath.c_str()));
+
+	pipe.finish();
+	errcatch( r );
+#else
+	throw msk_exception("Models can not be read from memory on this platform");
+#endif
+}
+
+void msk_writebuffer(MSKtask_t task, MSKdataformate format, vector<char> &data)
+{
+#ifdef OMSK_PIPE
+	Intparam_guard formatguard(task, MSK_IPAR_WRITE_DATA_FORMAT, format);
+	Intparam_guard compress(task, MSK_IPAR_WRITE_DATA_COMPRESSED, MSK_COMPRESS_NONE);
+
+	data.clear();
+	Buffer_pipe pipe(NULL, 0, &data);
+	string devpath = pipe.devpath();
+	MSKrescodee r = MSK_writedata(task, const_cast<MSKCONST char*>(devpath.c_str()));
+
+	// The buffer is complete once this end of the pipe is closed
+	pipe.finish();
+	errcatch( r );
+#else
+	throw msk_exception("Models can not be written to memory on this platform");
+#endif
+}
+
+
+// ------------------------------
+// Class Background_write
+// ------------------------------
+
+Background_write::~Background_write()
+{
+	join();
+}
+
+void Background_write::start(MSKtask_t task, const string &path, bool withsolutions)
+{
+	if (isactive())
+		throw msk_exception("Internal error in Background_write::start, a write was already started");
+
+	filepath = path;
+	used = true;
+	failed = false;
+	code = MSK_RES_OK;
+	msg = "";
+
+	// The clone is made on this thread, and has no log stream
+	errcatch( MSK_clonetask(task, &clone) );
+
+	try {
+		if (withsolutions)
+			msk_copysolutions(task, clone);
+
+		started = get_walltime();
+		thread.start(run, this);
+
+	} catch (...) {
+		MSK_deletetask(&clone);
+		clone = NULL;
+		throw;
+	}
+}
+
+void Background_write::write(MSKtask_t task, const string &path)
+{
+	if (isactive())
+		throw msk_exception("Internal error in Background_write::write, a write was already started");
+
+	filepath = path;
+	used = true;
+	failed = false;
+	code = MSK_RES_OK;
+	msg = "";
+
+	started = get_walltime();
+	try {
+		msk_writedata(task, filepath);
+
+	} catch (msk_exception const& e) {
+		failed = true;
+		code = e.code;
+		msg = e.what();
+
+	} catch (std::exception const& e) {
+		failed = true;
+		code = NAN;
+		msg = e.what();
+	}
+	finished = get_walltime();
+}
+
+void Background_write::run(void *data)
+{
+	Background_write &write = *static_cast<Background_write*>(data);
+
+	try {
+		msk_writedata(write.clone, write.filepath);
+
+	} catch (msk_exception const& e) {
+		write.failed = true;
+		write.code = e.code;
+		write.msg = e.what();
+
+	} catch (std::exception const& e) {
+		write.failed = true;
+		write.code = NAN;
+		write.msg = e.what();
+	}
+
+	write.finished = get_walltime();
+}
+
+void Background_write::join()
+{
+	if (!isactive())
+		return;
+
+	thread.join();
+	MSK_deletetask(&clone);
+	clone = NULL;
+}
+
+msk_response Background_write::getresponse() const
+{
+	if (failed)
+		return msk_response(code, msg);
+
+	return get_msk_response(MSK_RES_OK);
+}
@@ -0,0 +1,98 @@
+#ifndef OMSK_UTILS_COMPRESS_H_
+#define OMSK_UTILS_COMPRESS_H_
+
+#include "omsk_msg_mosek.h"
+#include "omsk_utils_threads.h"
+
+#include <string>
+#include <vector>
+
+// ------------------------------
+// Compressed model files
+// ------------------------------
+//
+// Model files may be compressed, as indicated by a last extension of ".gz" or
+// ".zst" after the extension of the format (e.g. "model.mps.gz"). Gzip files
+// are handled by MOSEK itself, while zstd files are streamed through a codec
+// on a background thread connected to MOSEK by a pipe. The latter is only
+// available on UNIX-alike platforms when compiled with OMSK_HAVE_ZSTD.
+//
+enum msk_compresstype {
+	OMSK_COMPRESS_NONE,
+	OMSK_COMPRESS_GZIP,
+	OMSK_COMPRESS_ZSTD
+};
+
+// Detects the compression of 'filepath', and returns the path without the
+// compression extension in 'innerpath'
+msk_compresstype get_compresstype(const std::string &filepath, std::string &innerpath);
+
+// The data format selected by the extension of 'filepath' (e.g. ".mps" or ".opf")
+MSKdataformate get_mskdataformat(const std::string &filepath);
+
+// The data format named by 'name' (an extension without the dot, e.g. "mps")
+MSKdataformate get_mskdataformat_byname(const std::string &name);
+
+// Read and write model files, decompressing and compressing them on the fly
+// (these print nothing, and are safe to call from worker threads)
+void msk_readdata(MSKtask_t task, const std::string &filepath);
+void msk_writedata(MSKtask_t task, const std::string &filepath);
+
+// Returns true if the format of 'filepath' holds solutions (OPF and MBT files)
+bool has_solutionformat(const std::string &filepath);
+
+// Read and write models held in memory, in the given format, through a pipe
+// to MOSEK (only available on UNIX-alike platforms)
+void msk_readbuffer(MSKtask_t task, const char *data, size_t bytes, MSKdataformate format);
+void msk_writebuffer(MSKtask_t task, MSKdataformate format, std::vector<char> &data);
+
+
+// ------------------------------
+// Class Background_write
+// ------------------------------
+//
+// Writes a model file from a clone of a task on a background thread, while the
+// task itself is optimized or read. The clone holds the problem and parameters
+// of the task, and, if requested, the solutions defined at the time of 'start'
+// (with unknown statuses, see msk_copysolutions). Files that should hold the
+// solutions with their statuses are instead written from the task itself on
+// the calling thread by 'write', and reported in the same way.
+//
+class Background_write {
+private:
+	MSKtask_t	clone;
+	std::string	filepath;
+	msk_thread	thread;
+
+	bool		used;
+	double		started;
+	double		finished;
+	bool		failed;
+	double		code;
+	std::string	msg;
+
+	static void run(void *data);
+
+	// Overwrite copy constructor and provide no implementation
+	Background_write(const Background_write& that);
+
+public:
+	Background_write() : clone(NULL), used(false), started(NAN), finished(NAN), failed(false), code(MSK_RES_OK) {}
+	~Background_write();
+
+	void start(MSKtask_t task, const std::string &filepath, bool withsolutions);
+	void write(MSKtask_t task, const std::string &filepath);
+
+	// Waits for the write to finish (returns immediately if none was started)
+	void join();
+
+	bool isactive() const			{ return clone != NULL; }
+	bool isused() const				{ return used; }
+	msk_response getresponse() const;
+
+	// Duration of the write, and the wall-clock time it finished (see get_walltime)
+	double duration() const			{ return finished - started; }
+	double finishtime() const		{ return finished; }
+};
+
+#endif /* OMSK_UTILS_COMPRESS_H_ */
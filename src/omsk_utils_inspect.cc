@@ -0,0 +1,178 @@
+#include "omsk_utils_inspect.h"
+
+#include "omsk_utils_mosek.h"
+#include "omsk_utils_snapshot.h"
+#include "omsk_utils_mpsfile.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+
+using std::string;
+using std::vector;
+
+
+// ------------------------------
+// Class model_summary
+// ------------------------------
+
+model_summary::model_summary() :
+	sense(MSK_OBJECTIVE_SENSE_UNDEFINED),
+	numvar(0),
+	numcon(0),
+	numanz(0),
+	numintvar(0),
+	numcone(0),
+	rownzmin(0), rownzmax(0),
+	colnzmin(0), colnzmax(0),
+	amin(INFINITY), amax(0.0)
+{}
+
+void model_summary::setrows(const vector<MSKintt> &rownz)
+{
+	rownzmin = rownzmax = 0;
+	if (!rownz.empty()) {
+		rownzmin = *std::min_element(rownz.begin(), rownz.end());
+		rownzmax = *std::max_element(rownz.begin(), rownz.end());
+	}
+}
+
+void model_summary::setcols(const vector<MSKintt> &colnz)
+{
+	colnzmin = colnzmax = 0;
+	if (!colnz.empty()) {
+		colnzmin = *std::min_element(colnz.begin(), colnz.end());
+		colnzmax = *std::max_element(colnz.begin(), colnz.end());
+	}
+}
+
+/* This function returns a range as a vector [min max], or empty if there are no elements. */
+static RowVector get_range(bool nonempty, double min, double max)
+{
+	if (!nonempty)
+		return RowVector(0);
+
+	RowVector range(2);
+	range(0) = min;
+	range(1) = max;
+	return range;
+}
+
+void model_summary::OCT_write(Octave_map &info) const
+{
+	info.assign("sense", octave_value(get_objective(sense), '\"'));
+	info.assign("numvar", octave_value(static_cast<double>(numvar)));
+	info.assign("numcon", octave_value(static_cast<double>(numcon)));
+	info.assign("numanz", octave_value(static_cast<double>(numanz)));
+	info.assign("numintvar", octave_value(static_cast<double>(numintvar)));
+	info.assign("numcone", octave_value(static_cast<double>(numcone)));
+	info.assign("intfraction", octave_value(numvar > 0 ? static_cast<double>(numintvar) / numvar : 0.0));
+	info.assign("rownz", octave_value(get_range(numcon > 0, rownzmin, rownzmax)));
+	info.assign("colnz", octave_value(get_range(numvar > 0, colnzmin, colnzmax)));
+	info.assign("arange", octave_value(get_range(amin <= amax, amin, amax)));
+}
+
+
+// ------------------------------
+// Summaries of model files
+// ------------------------------
+
+void msk_inspectsnapshot(const string &filepath, model_summary &summary)
+{
+	Binfile_reader file;
+	file.open(filepath, OMSK_SNAPSHOT_MAGIC, OMSK_SNAPSHOT_VERSION);
+
+	for (int i = 0; i < 4; ++i)
+		if (file.dim(i) > static_cast<uint64_t>(INT_MAX))
+			throw msk_exception("The problem in snapshot '" + filepath + "' is too large");
+
+	summary.numvar = static_cast<MSKintt>(file.dim(0));
+	summary.numcon = static_cast<MSKintt>(file.dim(1));
+	summary.numanz = static_cast<MSKintt>(file.dim(2));
+	summary.numcone = static_cast<MSKintt>(file.dim(3));
+	summary.sense = static_cast<MSKobjsensee>(file.int32("sense", 1)[0]);
+	summary.numintvar = static_cast<MSKintt>(file.find("intsub", OMSK_SOLFILE_INT32).count);
+
+	// The constraint matrix is scanned in the mapped file
+	const int32_t *colptr = file.int32("A.colptr", summary.numvar + 1);
+	const int32_t *rowidx = file.int32("A.rowidx", summary.numanz);
+	const double *values = file.float64("A.values", summary.numanz);
+
+	if (colptr[0] != 0 || colptr[summary.numvar] != summary.numanz)
+		throw msk_exception("The constraint matrix in snapshot '" + filepath + "' is corrupted");
+
+	vector<MSKintt> rownz(summary.numcon, 0), colnz(summary.numvar);
+	for (MSKintt j = 0; j < summary.numvar; ++j) {
+		if (colptr[j+1] < colptr[j])
+			throw msk_exception("The constraint matrix in snapshot '" + filepath + "' is corrupted");
+		colnz[j] = colptr[j+1] - colptr[j];
+	}
+	for (MSKintt k = 0; k < summary.numanz; ++k) {
+		if (rowidx[k] < 0 || rowidx[k] >= summary.numcon)
+			throw msk_exception("The constraint matrix in snapshot '" + filepath + "' is corrupted");
+		++rownz[rowidx[k]];
+
+		if (values[k] != 0.0) {
+			summary.amin = std::min(summary.amin, fabs(values[k]));
+			summary.amax = std::max(summary.amax, fabs(values[k]));
+		}
+	}
+
+	summary.setrows(rownz);
+	summary.setcols(colnz);
+}
+
+void msk_inspectmpsfile(const string &filepath, int numthreads, model_summary &summary)
+{
+	Mpsfile_reader file;
+	file.open(filepath, numthreads);
+
+	summary.numvar = file.numvar;
+	summary.numcon = file.numcon;
+	summary.numanz = file.numnz;
+	summary.numcone = static_cast<MSKintt>(file.conetypes.size());
+	summary.numintvar = static_cast<MSKintt>(file.intsub.size());
+	summary.sense = file.sense;
+
+	vector<MSKintt> rownz(file.numcon), colnz(file.numvar);
+	file.scan_matrix(rownz.empty() ? NULL : &rownz[0], summary.amin, summary.amax);
+	file.get_colnz(colnz.empty() ? NULL : &colnz[0]);
+
+	summary.setrows(rownz);
+	summary.setcols(colnz);
+}
+
+void msk_inspecttask(MSKtask_t task, model_summary &summary)
+{
+	errcatch( MSK_getobjsense(task, &summary.sense) );
+	errcatch( MSK_getnumvar(task, &summary.numvar) );
+	errcatch( MSK_getnumcon(task, &summary.numcon) );
+	errcatch( MSK_getnumanz(task, &summary.numanz) );
+	errcatch( MSK_getnumintvar(task, &summary.numintvar) );
+	errcatch( MSK_getnumcone(task, &summary.numcone) );
+
+	// The constraint matrix is extracted one column at a time
+	vector<MSKintt> rownz(summary.numcon, 0), colnz(summary.numvar);
+	vector<MSKidxt> sub(summary.numcon + 1);
+	vector<MSKrealt> val(summary.numcon + 1);
+
+	for (MSKintt j = 0; j < summary.numvar; ++j) {
+		MSKintt nz;
+		errcatch( MSK_getavec(task, MSK_ACC_VAR, j, &nz, &sub[0], &val[0]) );
+
+		colnz[j] = nz;
+		for (MSKintt k = 0; k < nz; ++k) {
+			++rownz[sub[k]];
+
+			if (val[k] != 0.0) {
+				summary.amin = std::min(summary.amin, fabs(val[k]));
+				summary.amax = std::max(summary.amax, fabs(val[k]));
+			}
+		}
+	}
+
+	summary.setrows(rownz);
+	summary.setcols(colnz);
+}
@@ -0,0 +1,50 @@
+#ifndef OMSK_UTILS_INSPECT_H_
+#define OMSK_UTILS_INSPECT_H_
+
+#include "omsk_msg_mosek.h"
+
+#include <octave/oct.h>
+#include <octave/ov-struct.h>
+
+#include <string>
+#include <vector>
+
+// ------------------------------
+// Model inspection
+// ------------------------------
+//
+// Summarizes a model file without building the problem in Octave. Snapshots
+// are summarized from their header and mapped arrays, MPS files by a scan of
+// the native reader (keeping only row indexes), and all other formats from a
+// MOSEK task one column at a time. The functions print nothing, and are safe
+// to call from worker threads.
+//
+struct model_summary {
+	MSKobjsensee sense;
+	MSKintt		numvar;
+	MSKintt		numcon;
+	MSKintt		numanz;
+	MSKintt		numintvar;
+	MSKintt		numcone;
+
+	// Non-zeros per row and column, and range of the absolute non-zero values
+	// (the minimum is larger than the maximum when there are none)
+	MSKintt		rownzmin, rownzmax;
+	MSKintt		colnzmin, colnzmax;
+	double		amin, amax;
+
+	model_summary();
+
+	// Sets the row and column statistics from the non-zeros of each
+	void setrows(const std::vector<MSKintt> &rownz);
+	void setcols(const std::vector<MSKintt> &colnz);
+
+	// Writes the summary to Octave
+	void OCT_write(Octave_map &info) const;
+};
+
+void msk_inspectsnapshot(const std::string &filepath, model_summary &summary);
+void msk_inspectmpsfile(const std::string &filepath, int numthreads, model_summary &summary);
+void msk_inspecttask(MSKtask_t task, model_summary &summary);
+
+#endif /* OMSK_UTILS_INSPECT_H_ */
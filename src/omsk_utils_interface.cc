@@ -1,11 +1,26 @@
 #include "omsk_utils_interface.h"
 
 #include "omsk_utils_mosek.h"
+#include "omsk_utils_octave.h"
+#include "omsk_obj_lazy.h"
+#include "omsk_utils_solfile.h"
+#include "omsk_utils_compress.h"
+#include "omsk_utils_snapshot.h"
+#include "omsk_utils_mpsfile.h"
+#include "omsk_utils_inspect.h"
+#include "omsk_utils_threads.h"
+
+#include <octave/oct-time.h>
 
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
 #include <exception>
 
 using std::string;
+using std::vector;
+using std::auto_ptr;
 using std::exception;
 
 
@@ -88,30 +103,174 @@ void msk_addresponse(Octave_map &ret_val, const msk_response &res, bool overwrit
 // ------------------------------
 
 
-// Interrupts MOSEK if CTRL+C is caught in Octave
+// Data shared with the MOSEK callback during optimization
+struct callbackdata_type {
+	octave_time start;
+	incumbent_sink *incumbent;
+	termination_monitor *terminate;
+	double timeslice;
+	bool timesliceexpired;
+
+	// Octave exceptions caught in the callback (they must not unwind through
+	// MOSEK, and are rethrown once the optimizer has returned)
+	bool interrupted;
+	bool executionerror;
+	string failure;
+
+	callbackdata_type() : start(), incumbent(NULL), terminate(NULL), timeslice(NAN), timesliceexpired(false),
+			interrupted(false), executionerror(false), failure("") {}
+
+	double elapsed() const {
+		return octave_time().double_value() - start.double_value();
+	}
+
+	bool caught() const {
+		return (interrupted || executionerror || !failure.empty());
+	}
+
+	void rethrow() const {
+		if (interrupted)
+			throw octave_interrupt_exception();
+		if (executionerror)
+			throw octave_execution_exception();
+		if (!failure.empty())
+			throw msk_exception(failure);
+	}
+};
+
+
+// Interrupts MOSEK if CTRL+C is caught in Octave or a termination rule is met,
+// and delivers incumbents to their sinks
 static int MSKAPI mskcallback(MSKtask_t task, MSKuserhandle_t handle, MSKcallbackcodee caller) {
 
 	if (octave_signal_caught) {
 		printoutput("Interruption caught, terminating at first chance...\n", typeERROR);
 		return 1;
 	}
+
+	callbackdata_type *data = static_cast<callbackdata_type*>(handle);
+	if (data == NULL)
+		return 0;
+
+	if (data->caught())
+		return 1;
+
+	if (data->elapsed() >= data->timeslice) {
+		if (!data->timesliceexpired)
+			printoutput("Time slice expired, suspending at first chance...\n", typeINFO);
+
+		data->timesliceexpired = true;
+		return 1;
+	}
+
+	// Exceptions must not propagate through MOSEK (the incumbent callback runs
+	// Octave code, so Octave exceptions are kept and the solve is stopped)
+	try {
+		if (data->incumbent != NULL) {
+			if (caller == MSK_CALLBACK_NEW_INT_MIO)
+				data->incumbent->push(task, data->elapsed());
+			else
+				data->incumbent->poll(data->elapsed());
+		}
+	} catch (exception const& e) {
+		printwarning("The incumbent sinks were removed after an error: " + string(e.what()));
+		data->incumbent = NULL;
+
+	} catch (octave_interrupt_exception const&) {
+		data->interrupted = true;
+		return 1;
+
+	} catch (octave_execution_exception const&) {
+		data->executionerror = true;
+		return 1;
+
+	} catch (...) {
+		data->failure = "The incumbent callback failed with an unknown error";
+		return 1;
+	}
+
+	try {
+		if (data->terminate != NULL) {
+			if (data->terminate->check(task, data->elapsed())) {
+				printoutput("Termination rule '" + data->terminate->rule + "' met, terminating at first chance...\n", typeINFO);
+				return 1;
+			}
+		}
+	} catch (exception const& e) {
+		printwarning("The termination rules were removed after an error: " + string(e.what()));
+		data->terminate = NULL;
+	}
+
 	return 0;
 }
 
 
+/* This function waits for a model file written in the background, and reports
+ * its response, its duration and how long it delayed the result. */
+static void msk_finishwrite(Octave_map &ret_val, const string &name, Background_write &write, double ready) {
+	if (!write.isused())
+		return;
+
+	write.join();
+	msk_response response = write.getresponse();
+	if (response.code != MSK_RES_OK)
+		printwarning("The model file of option '" + name + "' could not be written: " + response.msg);
+
+	Octave_map res_vec;
+	res_vec.assign("code", octave_value(response.code));
+	res_vec.assign("msg", octave_value(response.msg, '\"'));
+
+	Octave_map write_val;
+	write_val.assign("response", octave_value(res_vec));
+	write_val.assign("time", octave_value(write.duration()));
+	write_val.assign("wait", octave_value(std::max(0.0, write.finishtime() - ready)));
+	ret_val.assign(name, octave_value(write_val));
+}
+
+
 /* Solve a loaded problem and return the solution */
-void msk_solve(Octave_map &ret_val, Task_handle &task, options_type options) {
+bool msk_solve(Octave_map &ret_val, Task_handle &task, options_type options) {
 
+	callbackdata_type cbdata;
+	cbdata.timeslice = options.timeslice;
+	auto_ptr<incumbent_sink> incumbent;
+	auto_ptr<termination_monitor> terminate;
+	Background_write writebefore, writeafter;
 
 	printdebug("msk_solve - INITIALIZATION");
 	{
+		/* Register sinks for the integer solutions found during optimization */
+		if (options.incumbent.isactive()) {
+			MSKintt numvar;
+			errcatch( MSK_getnumvar(task, &numvar) );
+
+			incumbent.reset( new incumbent_sink(options.incumbent, numvar) );
+			cbdata.incumbent = incumbent.get();
+		}
+
+		/* Register the rules for early termination */
+		if (options.terminate.isactive()) {
+			terminate.reset( new termination_monitor(options.terminate, task) );
+			cbdata.terminate = terminate.get();
+		}
+
+		/* Continue from the solutions kept by a previous time slice */
+		if (!xisnan(options.timeslice)) {
+			MSKintt isdef_itg;
+			errcatch( MSK_solutiondef(task, MSK_SOL_ITG, &isdef_itg) );
+			if (isdef_itg) {
+				errcatch( MSK_putintparam(task, MSK_IPAR_MIO_CONSTRUCT_SOL, MSK_ON) );
+			}
+		}
+
 		/* Make it interruptible with CTRL+C */
-		errcatch( MSK_putcallbackfunc(task, mskcallback, (void*)NULL) );
+		errcatch( MSK_putcallbackfunc(task, mskcallback, static_cast<void*>(&cbdata)) );
 
-		/* Write file containing problem description (filetypes: .lp, .mps, .opf, .mbt) */
+		/* Write file containing problem description (filetypes: .lp, .mps, .opf, .mbt)
+		 * from a copy of the task, in the background of the optimization */
 		if (!options.writebefore.empty()) {
 			MSK_putintparam(task, MSK_IPAR_OPF_WRITE_SOLUTIONS, MSK_ON);
-			errcatch( MSK_writedata(task, const_cast<MSKCONST char*>(options.writebefore.c_str())) );
+			writebefore.start(task, options.writebefore, true);
 		}
 	}
 
@@ -124,12 +283,30 @@ void msk_solve(Octave_map &ret_val, Task_handle &task, options_type options) {
 		if (mosek_interface_warnings > 0)
 			printoutput("\n", typeWARNING);
 
-		/* Run optimizer */
+		/* Run optimizer (rethrowing Octave exceptions caught in the callback) */
 		MSKrescodee trmcode;
-		errcatch( MSK_optimizetrm(task, &trmcode) );
-		msk_addresponse(ret_val, get_msk_response(trmcode));
+		MSKrescodee r = MSK_optimizetrm(task, &trmcode);
+		cbdata.rethrow();
+		errcatch( r );
+
+		/* Name the rule if the solve was stopped by one */
+		msk_response trmresponse = get_msk_response(trmcode);
+		if (cbdata.terminate != NULL && !cbdata.terminate->rule.empty()) {
+			trmresponse.msg += " (termination rule '" + cbdata.terminate->rule + "')";
+		}
+		msk_addresponse(ret_val, trmresponse);
+
+		/* Deliver the last incumbent held back by the callback interval */
+		if (cbdata.incumbent != NULL) {
+			cbdata.incumbent->finish(cbdata.elapsed());
+		}
+
+		/* The callback data goes out of scope with this function */
+		errcatch( MSK_putcallbackfunc(task, mskcallback, NULL) );
 
 	} catch (exception const& e) {
+		MSK_putcallbackfunc(task, mskcallback, NULL);
+
 		// Report that the CTRL+C interruption has been caught
 		if (octave_signal_caught) {
 
@@ -148,32 +325,75 @@ void msk_solve(Octave_map &ret_val, Task_handle &task, options_type options) {
 			printoutput("Optimization interrupted.\n", typeERROR);
 		}
 		throw;
+
+	} catch (...) {
+		// Octave exceptions from the incumbent callback
+		MSK_putcallbackfunc(task, mskcallback, NULL);
+		printoutput("Optimization interrupted by the incumbent callback.\n", typeERROR);
+		throw;
 	}
 
 
 
 	printdebug("msk_solve - EXTRACT SOLUTION");
+
+	/* Time-sliced solves stopped by expiry or interruption can be resumed */
+	bool resumable = (!xisnan(options.timeslice) && (cbdata.timesliceexpired || octave_signal_caught));
+
 	try
 	{
-		/* Write file containing problem description (solution only included if filetype is .opf or .mbt) */
+		/* Write file containing problem description (solution only included if filetype is .opf or .mbt).
+		 * A copy of the task can not hold the solution statuses, so files with solutions are written from
+		 * the task itself, and other files from a copy in the background of the solution extraction */
 		if (!options.writeafter.empty()) {
-			MSK_putintparam(task, MSK_IPAR_OPF_WRITE_SOLUTIONS, MSK_ON);
-			errcatch( MSK_writedata(task, const_cast<MSKCONST char*>(options.writeafter.c_str())) );
+			if (has_solutionformat(options.writeafter)) {
+				MSK_putintparam(task, MSK_IPAR_OPF_WRITE_SOLUTIONS, MSK_ON);
+				writeafter.write(task, options.writeafter);
+			} else {
+				writeafter.start(task, options.writeafter, false);
+			}
 		}
 
 		/* Print a summary containing information
 		 * about the solution for debugging purposes. */
 		errcatch( MSK_solutionsummary(task, MSK_STREAM_LOG) );
 
-		/* Extract solution from Mosek to Octave */
-		Octave_map sol_val;
-		msk_getsolution(sol_val, task);
-		ret_val.assign("sol", octave_value(sol_val));
+		/* Extract solution from Mosek to Octave (or hand the task over to a lazy solution) */
+		if (options.lazysol && !resumable) {
+			Task_shared *shared = Task_shared::adopt(task);
+			shared->skcodes = options.skcodes;
+			shared->soltypes = options.soltypes;
+			shared->solitems = options.solitems;
+			shared->sparseitems = options.sparseitems;
+
+			octave_mosek_solution::register_once();
+			ret_val.assign("sol", octave_value(new octave_mosek_solution(shared, "")));
+
+		} else if (!options.solfile.empty()) {
+			Octave_map sol_val;
+			msk_writesolfile(options.solfile, task, options, sol_val);
+			ret_val.assign("sol", octave_value(sol_val));
+			ret_val.assign("solfile", octave_value(options.solfile, '\"'));
+
+		} else {
+			Octave_map sol_val, outbuf_val;
+			msk_getsolution(sol_val, task, options, &outbuf_val);
+			ret_val.assign("sol", octave_value(sol_val));
+			if (outbuf_val.nfields() > 0)
+				ret_val.assign("outbuf", octave_value(outbuf_val));
+		}
 
 	} catch (exception const& e) {
 		printoutput("An error occurred while extracting the solution.\n", typeERROR);
 		throw;
 	}
+
+	/* Wait for the model files written in the background */
+	double ready = get_walltime();
+	msk_finishwrite(ret_val, options_type::OCT_ARGS.writebefore, writebefore, ready);
+	msk_finishwrite(ret_val, options_type::OCT_ARGS.writeafter, writeafter, ready);
+
+	return resumable;
 }
 
 
@@ -187,7 +407,7 @@ void msk_loadproblemfile(Task_handle &task, string filepath, options_type &optio
 	task.init(global_env, 0, 0);
 
 	try {
-		errcatch( MSK_readdata(task, const_cast<MSKCONST char*>(filepath.c_str())) );
+		msk_readdata(task, filepath);
 
 	} catch (exception const& e) {
 		printerror("An error occurred while loading up the problem from a file");
@@ -196,8 +416,543 @@ void msk_loadproblemfile(Task_handle &task, string filepath, options_type &optio
 }
 
 
-/* Save a problem description to file */
-void msk_saveproblemfile(Task_handle &task, string filepath, options_type &options) {
+// Data of one model file read by a worker thread
+struct readfile_job {
+	string		filepath;
+	Task_handle	task;
+	string		log;
+	bool		native;		// Read with the native reader on the calling thread
+
+	bool		failed;
+	double		code;
+	string		msg;
+
+	readfile_job() : native(false), failed(false), code(MSK_RES_OK) {}
+};
+
+// Model files read in a pipeline, with a slot per file in flight
+struct readfile_state {
+	const vector<string> *filepaths;
+	options_type *options;
+	int window;
+	auto_array<readfile_job> jobs;
+
+	Cell probs, responses;
+	int numfailed;
+
+	readfile_state(int window, const dim_vector &dims) :
+		window(window), jobs(new readfile_job[window]), probs(dims), responses(dims), numfailed(0) {}
+};
+
+/* This function creates the task of one model file, with its log kept until the parsing is done. */
+static void readfile_prepare(int i, void *data)
+{
+	readfile_state &state = *static_cast<readfile_state*>(data);
+	readfile_job &job = state.jobs[i % state.window];
+
+	job.filepath = (*state.filepaths)[i];
+	job.native = (state.options->reader == "native");
+	job.log.clear();
+	job.failed = false;
+
+	if (!job.native && !is_snapshotfile(job.filepath)) {
+		job.task.init(global_env, 0, 0);
+		job.task.bufferlog(&job.log);
+	}
+}
+
+/* This function parses one model file into its task (runs on worker threads). */
+static void readfile_worker(int i, void *data)
+{
+	readfile_state &state = *static_cast<readfile_state*>(data);
+	readfile_job &job = state.jobs[i % state.window];
+
+	// Snapshots and files for the native reader are read on the calling thread
+	if (job.native || is_snapshotfile(job.filepath))
+		return;
+
+	try {
+		msk_readdata(job.task, job.filepath);
+
+	} catch (msk_exception const& e) {
+		job.failed = true;
+		job.code = e.code;
+		job.msg = e.what();
+
+	} catch (exception const& e) {
+		job.failed = true;
+		job.code = NAN;
+		job.msg = e.what();
+	}
+}
+
+/* This function converts one parsed model file to Octave and releases its task. */
+static void readfile_finish(int i, void *data)
+{
+	readfile_state &state = *static_cast<readfile_state*>(data);
+	readfile_job &job = state.jobs[i % state.window];
+
+	if (!job.log.empty())
+		printoutput(job.log, typeMOSEK);
+
+	Octave_map prob_val;
+	msk_response response = get_msk_response(MSK_RES_OK);
+
+	try {
+		if (job.failed)
+			throw msk_exception(msk_response(job.code, job.msg));
+
+		problem_type probin;
+		probin.options = *state.options;
+
+		if (is_snapshotfile(job.filepath))
+			probin.SNAPSHOT_read(job.filepath);
+		else if (job.native)
+			probin.NATIVE_read(job.filepath);
+		else
+			probin.MOSEK_read(job.task);
+
+		probin.OCT_write(prob_val);
+
+	} catch (msk_exception const& e) {
+		printerror("The model file '" + job.filepath + "' could not be read");
+		response = e.getresponse();
+		++state.numfailed;
+	}
+
+	// Release the task as soon as the problem has been extracted
+	{
+		Task_handle released;
+		released.swap(job.task);
+	}
+
+	Octave_map res_vec;
+	res_vec.assign("code", octave_value(response.code));
+	res_vec.assign("msg", octave_value(response.msg, '\"'));
+
+	state.probs(i) = octave_value(prob_val);
+	state.responses(i) = octave_value(res_vec);
+}
+
+/* Load several problem descriptions from file, parsing them in parallel */
+void msk_loadproblemfiles(Octave_map &ret_val, const vector<string> &filepaths, const dim_vector &dims, options_type &options) {
+
+	int numfiles = static_cast<int>(filepaths.size());
+	int numthreads = std::max(1, std::min(numfiles, get_numprocessors()));
+
+	// Make sure the environment is initialized
+	global_env.init();
+
+	// Only a few tasks hold a model at a time, while problems are converted
+	// to Octave on this thread in input order
+	readfile_state state(2 * numthreads, dims);
+	state.filepaths = &filepaths;
+	state.options = &options;
+
+	printdebug("Reading " + tostring(numfiles) + " model files on " + tostring(numthreads) + " thread(s)");
+	run_pipelined(readfile_prepare, readfile_worker, readfile_finish, &state, numfiles, numthreads, state.window);
+
+	Octave_map results(dims);
+	results.assign("prob", state.probs);
+	results.assign("response", state.responses);
+	ret_val.assign("results", octave_value(results));
+
+	if (state.numfailed > 0)
+		printwarning(tostring(state.numfailed) + " of " + tostring(numfiles) + " model files could not be read");
+}
+
+
+// Summary of one model file inspected by a worker thread
+struct inspect_job {
+	string		filepath;
+	Task_handle	task;
+	string		log;
+	bool		native;		// Scan MPS files with the native reader
+	int			numthreads;	// Threads of the native reader
+
+	model_summary summary;
+	bool		fallback;	// Read by MOSEK after the native reader failed
+	string		fallbackmsg;
+	bool		failed;
+	double		code;
+	string		msg;
+
+	inspect_job() : native(false), numthreads(1), fallback(false), failed(false), code(MSK_RES_OK) {}
+};
+
+/* This function summarizes one model file (runs on worker threads). */
+static void inspect_worker(int i, void *data)
+{
+	inspect_job &job = static_cast<inspect_job*>(data)[i];
+
+	try {
+		if (is_snapshotfile(job.filepath)) {
+			msk_inspectsnapshot(job.filepath, job.summary);
+			return;
+		}
+
+		if (job.native && is_mpsfile(job.filepath)) {
+			try {
+				msk_inspectmpsfile(job.filepath, job.numthreads, job.summary);
+				return;
+
+			} catch (msk_exception const& e) {
+				// The native reader supports a subset of MPS (e.g. no QSECTION), so MOSEK tries as well
+				job.fallback = true;
+				job.fallbackmsg = e.what();
+				job.summary = model_summary();
+			}
+		}
+
+		msk_readdata(job.task, job.filepath);
+		msk_inspecttask(job.task, job.summary);
+
+	} catch (msk_exception const& e) {
+		job.failed = true;
+		job.code = e.code;
+		job.msg = e.what();
+
+	} catch (exception const& e) {
+		job.failed = true;
+		job.code = NAN;
+		job.msg = e.what();
+	}
+}
+
+/* Summarize model files without building the problems in Octave */
+void msk_inspectfiles(Octave_map &ret_val, const vector<string> &filepaths, const dim_vector &dims, bool multiple, options_type &options) {
+
+	int numfiles = static_cast<int>(filepaths.size());
+	int numthreads = std::max(1, std::min(numfiles, get_numprocessors()));
+
+	// Files are inspected in batches, such that only a few tasks hold a model at a time
+	int batchsize = multiple ? 4 * numthreads : 1;
+	auto_array<inspect_job> jobs( new inspect_job[batchsize] );
+
+	// Make sure the environment is initialized
+	global_env.init();
+
+	Cell infos(dims), responses(dims);
+	int numfailed = 0;
+
+	printdebug("Inspecting " + tostring(numfiles) + " model files on " + tostring(numthreads) + " thread(s)");
+	for (int first = 0; first < numfiles; first += batchsize) {
+		int numjobs = std::min(batchsize, numfiles - first);
+
+		// Tasks are created here, with their log kept until the inspection is done
+		for (int i = 0; i < numjobs; ++i) {
+			inspect_job &job = jobs[i];
+			job.filepath = filepaths[first + i];
+			job.native = (options.reader == "native");
+			job.numthreads = multiple ? 1 : get_numprocessors();
+			job.summary = model_summary();
+			job.log.clear();
+			job.fallback = false;
+			job.failed = false;
+
+			// MPS files for the native reader get a task as well, in case MOSEK has to read them
+			if (!is_snapshotfile(job.filepath)) {
+				job.task.init(global_env, 0, 0);
+				job.task.bufferlog(&job.log);
+			}
+		}
+
+		run_parallel(inspect_worker, static_cast<inspect_job*>(jobs), numjobs, numthreads);
+
+		// Summaries are converted to Octave on this thread, in input order
+		for (int i = 0; i < numjobs; ++i) {
+			inspect_job &job = jobs[i];
+			if (job.fallback)
+				printinfo("The model file '" + job.filepath + "' was read by MOSEK, as the native reader failed: " + job.fallbackmsg);
+			if (!job.log.empty())
+				printoutput(job.log, typeMOSEK);
+
+			// Release the task before the next batch
+			{
+				Task_handle released;
+				released.swap(job.task);
+			}
+
+			if (!multiple) {
+				if (job.failed)
+					throw msk_exception(msk_response(job.code, job.msg));
+
+				Octave_map info;
+				job.summary.OCT_write(info);
+				ret_val.assign("info", octave_value(info));
+				return;
+			}
+
+			Octave_map info;
+			msk_response response = get_msk_response(MSK_RES_OK);
+			if (job.failed) {
+				printerror("The model file '" + job.filepath + "' could not be inspected");
+				response = msk_response(job.code, job.msg);
+				++numfailed;
+			} else {
+				job.summary.OCT_write(info);
+			}
+
+			Octave_map res_vec;
+			res_vec.assign("code", octave_value(response.code));
+			res_vec.assign("msg", octave_value(response.msg, '\"'));
+
+			infos(first + i) = octave_value(info);
+			responses(first + i) = octave_value(res_vec);
+		}
+	}
+
+	Octave_map results(dims);
+	results.assign("info", infos);
+	results.assign("response", responses);
+	ret_val.assign("results", octave_value(results));
+
+	if (numfailed > 0)
+		printwarning(tostring(numfailed) + " of " + tostring(numfiles) + " model files could not be inspected");
+}
+
+
+/* This function returns true if a model file is loaded through a problem description (on the calling thread). */
+static bool solvefile_viaproblem(const string &filepath, const options_type &options)
+{
+	return is_snapshotfile(filepath) || options.reader == "native";
+}
+
+/* This function creates the task of a model file, and loads the model unless it is read by MOSEK. */
+static void solvefile_prepare(Task_handle &task, const string &filepath, options_type &options)
+{
+	if (solvefile_viaproblem(filepath, options)) {
+		problem_type probin;
+		probin.options = options;
+
+		if (is_snapshotfile(filepath))
+			probin.SNAPSHOT_read(filepath);
+		else
+			probin.NATIVE_read(filepath);
+
+		probin.MOSEK_write(task);
+
+	} else {
+		global_env.init();
+		task.init(global_env, 0, 0);
+
+		// Parameters given in the model file take precedence over the profile
+		if (!options.paramprofile.empty())
+			global_profiles.get(options.paramprofile).apply(task);
+	}
+}
+
+/* Load a model file into a task, ready to be solved */
+void msk_loadsolvefile(Task_handle &task, const string &filepath, options_type &options) {
+	solvefile_prepare(task, filepath, options);
+
+	if (!solvefile_viaproblem(filepath, options)) {
+		try {
+			msk_readdata(task, filepath);
+
+		} catch (exception const& e) {
+			printerror("An error occurred while loading up the problem from a file");
+			throw;
+		}
+	}
+}
+
+
+// Data of one model file solved by a worker thread
+struct solvefile_job {
+	string		filepath;
+	Task_handle	task;
+	string		log;
+	bool		loaded;		// Whether the model was loaded on the calling thread
+
+	MSKrescodee	trmcode;
+	bool		failed;
+	double		code;
+	string		msg;
+
+	solvefile_job() : loaded(false), trmcode(MSK_RES_OK), failed(false), code(MSK_RES_OK) {}
+};
+
+/* This function stops the optimization of a worker on CTRL+C (it only reads the flag, and prints nothing). */
+static int MSKAPI mskworkercallback(MSKtask_t task, MSKuserhandle_t handle, MSKcallbackcodee caller) {
+	return octave_signal_caught ? 1 : 0;
+}
+
+// Model files solved in a pipeline, with a slot per file in flight
+struct solvefile_state {
+	const vector<string> *filepaths;
+	options_type *options;
+	int window;
+	auto_array<solvefile_job> jobs;
+
+	Cell sols, responses;
+	int numfailed;
+
+	solvefile_state(int window, const dim_vector &dims) :
+		window(window), jobs(new solvefile_job[window]), sols(dims), responses(dims), numfailed(0) {}
+};
+
+/* This function creates the task of one model file (loading snapshots and native files as well),
+ * with its log kept until the optimization is done. Files are skipped once CTRL+C is pressed. */
+static void solvefile_prepareone(int i, void *data)
+{
+	solvefile_state &state = *static_cast<solvefile_state*>(data);
+	solvefile_job &job = state.jobs[i % state.window];
+
+	job.filepath = (*state.filepaths)[i];
+	job.loaded = solvefile_viaproblem(job.filepath, *state.options);
+	job.log.clear();
+	job.trmcode = MSK_RES_OK;
+	job.failed = false;
+
+	if (octave_signal_caught) {
+		job.failed = true;
+		return;
+	}
+
+	try {
+		solvefile_prepare(job.task, job.filepath, *state.options);
+		job.task.bufferlog(&job.log);
+
+	} catch (msk_exception const& e) {
+		job.failed = true;
+		job.code = e.code;
+		job.msg = e.what();
+
+	} catch (exception const& e) {
+		job.failed = true;
+		job.code = NAN;
+		job.msg = e.what();
+	}
+}
+
+/* This function reads and optimizes one model file (runs on worker threads). */
+static void solvefile_worker(int i, void *data)
+{
+	solvefile_state &state = *static_cast<solvefile_state*>(data);
+	solvefile_job &job = state.jobs[i % state.window];
+	if (job.failed)
+		return;
+
+	try {
+		if (!job.loaded)
+			msk_readdata(job.task, job.filepath);
+
+		errcatch( MSK_putcallbackfunc(job.task, mskworkercallback, NULL) );
+		MSKrescodee r = MSK_optimizetrm(job.task, &job.trmcode);
+		MSK_putcallbackfunc(job.task, NULL, NULL);
+		errcatch( r );
+
+		errcatch( MSK_solutionsummary(job.task, MSK_STREAM_LOG) );
+
+	} catch (msk_exception const& e) {
+		job.failed = true;
+		job.code = e.code;
+		job.msg = e.what();
+
+	} catch (exception const& e) {
+		job.failed = true;
+		job.code = NAN;
+		job.msg = e.what();
+	}
+}
+
+/* This function converts the solution of one model file to Octave and releases its task. */
+static void solvefile_finish(int i, void *data)
+{
+	solvefile_state &state = *static_cast<solvefile_state*>(data);
+	solvefile_job &job = state.jobs[i % state.window];
+
+	if (!job.log.empty())
+		printoutput(job.log, typeMOSEK);
+
+	// The results are not returned once CTRL+C is pressed
+	if (!octave_signal_caught) {
+		Octave_map sol_val;
+		msk_response response = get_msk_response(job.trmcode);
+
+		try {
+			if (job.failed)
+				throw msk_exception(msk_response(job.code, job.msg));
+
+			msk_getsolution(sol_val, job.task, *state.options);
+
+		} catch (msk_exception const& e) {
+			printerror("The model file '" + job.filepath + "' could not be solved");
+			response = e.getresponse();
+			++state.numfailed;
+		}
+
+		Octave_map res_vec;
+		res_vec.assign("code", octave_value(response.code));
+		res_vec.assign("msg", octave_value(response.msg, '\"'));
+
+		state.sols(i) = octave_value(sol_val);
+		state.responses(i) = octave_value(res_vec);
+	}
+
+	// Release the task before the slot is used by the next file
+	{
+		Task_handle released;
+		released.swap(job.task);
+	}
+}
+
+/* Solve several model files in parallel, with one task per file */
+void msk_solvefiles(Octave_map &ret_val, const vector<string> &filepaths, const dim_vector &dims, options_type &options) {
+
+	// Options interacting with Octave during the optimization, or naming a single file, are not supported
+	if (options.incumbent.isactive() || options.terminate.isactive() || !xisnan(options.timeslice) || options.lazysol ||
+			!isEmpty(options.outbuf) || !options.solfile.empty() || !options.writebefore.empty() || !options.writeafter.empty()) {
+		throw msk_exception("Options 'incumbent', 'terminate', 'timeslice', 'lazysol', 'outbuf', 'solfile', 'writebefore' and 'writeafter' are not supported when solving several files");
+	}
+
+	int numfiles = static_cast<int>(filepaths.size());
+	int numthreads = std::max(1, std::min(numfiles, get_numprocessors()));
+
+	// A new file is started as soon as one is done, with only a few tasks holding a
+	// model at a time, while solutions are converted to Octave on this thread in input order
+	solvefile_state state(2 * numthreads, dims);
+	state.filepaths = &filepaths;
+	state.options = &options;
+
+	printdebug("Solving " + tostring(numfiles) + " model files on " + tostring(numthreads) + " thread(s)");
+	run_pipelined(solvefile_prepareone, solvefile_worker, solvefile_finish, &state, numfiles, numthreads, state.window);
+
+	if (octave_signal_caught)
+		throw msk_exception("Solving the model files was interrupted");
+
+	Octave_map results(dims);
+	results.assign("sol", state.sols);
+	results.assign("response", state.responses);
+	ret_val.assign("results", octave_value(results));
+
+	if (state.numfailed > 0)
+		printwarning(tostring(state.numfailed) + " of " + tostring(numfiles) + " model files could not be solved");
+}
+
+
+/* Load a problem description from memory */
+void msk_loadproblembuffer(Task_handle &task, const vector<char> &data, options_type &options) {
+
+	// Make sure the environment is initialized
+	global_env.init();
+
+	// Initialize the task
+	task.init(global_env, 0, 0);
+
+	try {
+		msk_readbuffer(task, data.empty() ? NULL : &data[0], data.size(), get_mskdataformat_byname(options.format));
+
+	} catch (exception const& e) {
+		printerror("An error occurred while loading up the problem from memory");
+		throw;
+	}
+}
+
+
+/* Set the export parameters for writing solutions and parameters along with the problem */
+static void msk_setexportparams(Task_handle &task, const options_type &options) {
 
 	// Set export-parameters for whether to write any solution loaded into MOSEK
 	if (options.usesol) {
@@ -215,6 +970,195 @@ void msk_saveproblemfile(Task_handle &task, string filepath, options_type &optio
 		errcatch( MSK_putintparam(task, MSK_IPAR_OPF_WRITE_PARAMETERS,MSK_OFF) );
 	}
 
-	// Write to filepath model (filetypes: .lp, .mps, .opf, .mbt)
-	errcatch( MSK_writedata(task, const_cast<MSKCONST char*>(filepath.c_str())) );
+}
+
+/* Save a problem description to file or memory */
+void msk_saveproblemfile(Task_handle &task, string filepath, options_type &options) {
+	msk_setexportparams(task, options);
+
+	// Write to filepath model (filetypes: .lp, .mps, .opf, .mbt, optionally followed by .gz or .zst)
+	msk_writedata(task, filepath);
+}
+
+void msk_saveproblembuffer(Task_handle &task, vector<char> &data, options_type &options) {
+	msk_setexportparams(task, options);
+
+	// Write the model through a pipe into memory
+	msk_writebuffer(task, get_mskdataformat_byname(options.format), data);
+}
+
+
+// Data of one model file converted by a worker thread
+struct convert_job {
+	string		inpath;
+	string		outpath;
+	Task_handle	task;
+	string		log;
+	bool		loaded;		// Whether the model was loaded on the calling thread
+
+	bool		failed;
+	double		code;
+	string		msg;
+
+	convert_job() : loaded(false), failed(false), code(MSK_RES_OK) {}
+};
+
+// Model files converted in a pipeline, with a slot per file in flight
+struct convert_state {
+	const vector<string> *inpaths;
+	const vector<string> *outpaths;
+	options_type *options;
+	bool multiple;
+	int window;
+	auto_array<convert_job> jobs;
+
+	Cell responses;
+	int numfailed;
+
+	convert_state(int window, const dim_vector &dims) :
+		window(window), jobs(new convert_job[window]), responses(dims), numfailed(0) {}
+};
+
+/* This function creates the task of one model file (loading snapshots and native files as well),
+ * with its log kept until the conversion is done. Files are skipped once CTRL+C is pressed. */
+static void convert_prepare(int i, void *data)
+{
+	convert_state &state = *static_cast<convert_state*>(data);
+	convert_job &job = state.jobs[i % state.window];
+
+	job.inpath = (*state.inpaths)[i];
+	job.outpath = (*state.outpaths)[i];
+	job.loaded = solvefile_viaproblem(job.inpath, *state.options);
+	job.log.clear();
+	job.failed = false;
+
+	if (octave_signal_caught) {
+		job.failed = true;
+		return;
+	}
+
+	try {
+		solvefile_prepare(job.task, job.inpath, *state.options);
+		job.task.bufferlog(&job.log);
+
+	} catch (msk_exception const& e) {
+		job.failed = true;
+		job.code = e.code;
+		job.msg = e.what();
+
+	} catch (exception const& e) {
+		job.failed = true;
+		job.code = NAN;
+		job.msg = e.what();
+	}
+}
+
+/* This function reads and writes one model file (runs on worker threads). */
+static void convert_worker(int i, void *data)
+{
+	convert_state &state = *static_cast<convert_state*>(data);
+	convert_job &job = state.jobs[i % state.window];
+	if (job.failed)
+		return;
+
+	try {
+		if (!job.loaded)
+			msk_readdata(job.task, job.inpath);
+
+		// Snapshots are written from a problem description on the calling thread, while
+		// the export parameters are set after reading (overriding those of the model file)
+		if (!is_snapshotfile(job.outpath)) {
+			msk_setexportparams(job.task, *state.options);
+			msk_writedata(job.task, job.outpath);
+		}
+
+	} catch (msk_exception const& e) {
+		job.failed = true;
+		job.code = e.code;
+		job.msg = e.what();
+
+	} catch (exception const& e) {
+		job.failed = true;
+		job.code = NAN;
+		job.msg = e.what();
+	}
+}
+
+/* This function writes the snapshot of one model file, collects its response and releases its task. */
+static void convert_finish(int i, void *data)
+{
+	convert_state &state = *static_cast<convert_state*>(data);
+	convert_job &job = state.jobs[i % state.window];
+
+	if (!job.log.empty())
+		printoutput(job.log, typeMOSEK);
+
+	// The remaining files are not reported once CTRL+C is pressed
+	if (!octave_signal_caught) {
+		msk_response response = get_msk_response(MSK_RES_OK);
+
+		try {
+			if (job.failed)
+				throw msk_exception(msk_response(job.code, job.msg));
+
+			if (is_snapshotfile(job.outpath)) {
+				problem_type probin;
+				probin.options = *state.options;
+				probin.MOSEK_read(job.task);
+				probin.SNAPSHOT_write(job.outpath);
+			}
+
+		} catch (msk_exception const& e) {
+			if (!state.multiple)
+				throw;
+
+			printerror("The model file '" + job.inpath + "' could not be converted");
+			response = e.getresponse();
+			++state.numfailed;
+		}
+
+		Octave_map res_vec;
+		res_vec.assign("code", octave_value(response.code));
+		res_vec.assign("msg", octave_value(response.msg, '\"'));
+
+		state.responses(i) = octave_value(res_vec);
+	}
+
+	// Release the task before the slot is used by the next file
+	{
+		Task_handle released;
+		released.swap(job.task);
+	}
+}
+
+/* Convert model files between formats, reading and writing them in parallel */
+void msk_convertfiles(Octave_map &ret_val, const vector<string> &inpaths, const vector<string> &outpaths, const dim_vector &dims, bool multiple, options_type &options) {
+
+	if (inpaths.size() != outpaths.size())
+		throw msk_exception("The number of input and output files should be the same");
+
+	int numfiles = static_cast<int>(inpaths.size());
+	int numthreads = std::max(1, std::min(numfiles, get_numprocessors()));
+
+	// A new file is started as soon as one is done, with only a few tasks holding a model at a time
+	convert_state state(2 * numthreads, dims);
+	state.inpaths = &inpaths;
+	state.outpaths = &outpaths;
+	state.options = &options;
+	state.multiple = multiple;
+
+	printdebug("Converting " + tostring(numfiles) + " model files on " + tostring(numthreads) + " thread(s)");
+	run_pipelined(convert_prepare, convert_worker, convert_finish, &state, numfiles, numthreads, state.window);
+
+	if (octave_signal_caught)
+		throw msk_exception("Converting the model files was interrupted");
+
+	if (multiple) {
+		Octave_map results(dims);
+		results.assign("response", state.responses);
+		ret_val.assign("results", octave_value(results));
+	}
+
+	if (state.numfailed > 0)
+		printwarning(tostring(state.numfailed) + " of " + tostring(numfiles) + " model files could not be converted");
 }
@@ -5,6 +5,9 @@
 #include "omsk_obj_mosek.h"
 #include "omsk_obj_arguments.h"
 
+#include <string>
+#include <vector>
+
 
 // ------------------------------
 // Cleaning and termination code
@@ -22,12 +25,41 @@ void msk_addresponse(Octave_map &ret_val, const msk_response &res, bool overwrit
 // ------------------------------
 
 // Solve a loaded problem and return the solution
-void msk_solve(Octave_map &ret_val, Task_handle &task, options_type options);
+// (returns true if a time-sliced solve was stopped early and can be resumed)
+bool msk_solve(Octave_map &ret_val, Task_handle &task, options_type options);
 
 // Load a problem description from file
 void msk_loadproblemfile(Task_handle &task, std::string filepath, options_type &options);
 
+// Load problem descriptions from several files, parsed in parallel with one task per file
+// (adds a struct array 'results' of problems and responses, shaped as 'dims')
+void msk_loadproblemfiles(Octave_map &ret_val, const std::vector<std::string> &filepaths, const dim_vector &dims, options_type &options);
+
+// Load a problem description held in memory, in the format of option 'format'
+void msk_loadproblembuffer(Task_handle &task, const std::vector<char> &data, options_type &options);
+
+// Summarize model files without building the problems in Octave (adds 'info'
+// for a single file, or a struct array 'results' of summaries and responses,
+// shaped as 'dims', for multiple files)
+void msk_inspectfiles(Octave_map &ret_val, const std::vector<std::string> &filepaths, const dim_vector &dims, bool multiple, options_type &options);
+
+// Load a model file into a task, ready to be solved (snapshots and the native
+// reader go through a problem description, other files are read by MOSEK)
+void msk_loadsolvefile(Task_handle &task, const std::string &filepath, options_type &options);
+
+// Solve several model files in parallel with one task per file (adds a struct
+// array 'results' of solutions and responses, shaped as 'dims')
+void msk_solvefiles(Octave_map &ret_val, const std::vector<std::string> &filepaths, const dim_vector &dims, options_type &options);
+
+// Convert model files between formats (read into a task and written from it,
+// in parallel for multiple files, adding a struct array 'results' of responses
+// shaped as 'dims')
+void msk_convertfiles(Octave_map &ret_val, const std::vector<std::string> &inpaths, const std::vector<std::string> &outpaths, const dim_vector &dims, bool multiple, options_type &options);
+
 // Save a problem description to file
 void msk_saveproblemfile(Task_handle &task, std::string filepath, options_type &options);
 
+// Save a problem description to memory, in the format of option 'format'
+void msk_saveproblembuffer(Task_handle &task, std::vector<char> &data, options_type &options);
+
 #endif /* OMSK_UTILS_INTERFACE_H_ */
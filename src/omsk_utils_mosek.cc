@@ -3,6 +3,7 @@
 #include "omsk_utils_octave.h"
 #include "omsk_utils_interface.h"
 #include "omsk_obj_mosek.h"
+#include "omsk_obj_parameters.h"
 
 #include <string>
 #include <exception>
@@ -10,6 +11,7 @@
 //FIXME
 #include <memory>
 #include <vector>
+#include <algorithm>
 
 using std::string;
 using std::exception;
@@ -146,18 +148,16 @@ void get_boundvalues(MSKtask_t task, double *lower, double* upper, MSKaccmodee b
 
 void get_mskparamtype(MSKtask_t task, string type, string name, MSKparametertypee *ptype, MSKintt *pidx)
 {
-	// Convert name to mosek input with correct prefix
-	strtoupper(name);
-	if (type == "iparam") append_mskprefix(name, "MSK_IPAR_"); else
-	if (type == "dparam") append_mskprefix(name, "MSK_DPAR_"); else
-	if (type == "sparam") append_mskprefix(name, "MSK_SPAR_"); else
-		throw msk_exception("A parameter type was not recognized");
+	// Look up the name (case-insensitive and with or without prefix) in the parameter table
+	global_params.init(task);
+	const Parameter_table::entry &param = global_params.find(type, name);
 
-	errcatch( MSK_whichparam(task, const_cast<MSKCONST char*>(name.c_str()), ptype, pidx) );
+	*ptype = param.type;
+	*pidx = param.index;
 }
 
-/* This function checks and sets the parameters of the MOSEK task. */
-void set_parameter(MSKtask_t task, string type, string name, octave_value value)
+/* This function checks and compiles a parameter into a profile. */
+void compile_parameter(MSKtask_t task, string type, string name, octave_value value, Parameter_profile &profile)
 {
 	if (isEmpty(value)) {
 		printwarning("The parameter '" + name + "' from " + type + " was ignored due to an empty definition.");
@@ -175,29 +175,21 @@ void set_parameter(MSKtask_t task, string type, string name, octave_value value)
 	switch (ptype) {
 		case MSK_PAR_INT_TYPE:
 		{
-			int mskvalue;
+			MSKintt mskvalue;
 
 			if (value.is_scalar_type())
 				mskvalue = scalar2int(value.scalar_value());
 
 			else if (value.is_string()) {
-				string valuestr = value.string_value();
-
 				// Convert value string to MOSEK input
-				strtoupper(valuestr);
-				append_mskprefix(valuestr, "MSK_");
-
-				char mskvaluestr[MSK_MAX_STR_LEN];
-				if (!MSK_symnamtovalue(const_cast<MSKCONST char*>(valuestr.c_str()), mskvaluestr))
+				if (!global_params.symvalue(value.string_value(), &mskvalue))
 					throw msk_exception("The value of parameter '" + name + "' from " + type + " was not recognized");
 
-				mskvalue = atoi(mskvaluestr);
-
 			} else {
 				throw msk_exception("The value of parameter '" + name + "' from " + type + " should be an integer or string");
 			}
 
-			errcatch( MSK_putintparam(task,(MSKiparame)pidx,mskvalue) );
+			profile.iparam.push_back(std::make_pair((MSKiparame)pidx, mskvalue));
 			break;
 		}
 
@@ -207,7 +199,7 @@ void set_parameter(MSKtask_t task, string type, string name, octave_value value)
 			if (error_state)
 				throw msk_exception("The value of parameter '" + name + "' from " + type + " should be a double");
 
-			errcatch( MSK_putdouparam(task,(MSKdparame)pidx,mskvalue) );
+			profile.dparam.push_back(std::make_pair((MSKdparame)pidx, mskvalue));
 			break;
 		}
 
@@ -217,7 +209,7 @@ void set_parameter(MSKtask_t task, string type, string name, octave_value value)
 			if (error_state)
 				throw msk_exception("The value of parameter " + name + "' from " + type + " should be a string");
 
-			errcatch( MSK_putstrparam(task, (MSKsparame)pidx, const_cast<MSKCONST char*>(mskvalue.c_str())) );
+			profile.sparam.push_back(std::make_pair((MSKsparame)pidx, mskvalue));
 			break;
 		}
 
@@ -226,90 +218,99 @@ void set_parameter(MSKtask_t task, string type, string name, octave_value value)
 	}
 }
 
-void append_parameters(MSKtask_t task, Octave_map& iparam, Octave_map& dparam, Octave_map& sparam) {
-	/* Set integer parameters */
+/* This function checks and compiles all parameters into a profile. */
+void compile_parameters(MSKtask_t task, Octave_map& iparam, Octave_map& dparam, Octave_map& sparam, Parameter_profile &profile)
+{
+	/* Compile integer parameters */
 	for (Octave_map::iterator p0 = iparam.begin(); p0 != iparam.end(); p0++)
-		set_parameter(task, "iparam", iparam.key(p0), iparam.contents(p0)(0));
+		compile_parameter(task, "iparam", iparam.key(p0), iparam.contents(p0)(0), profile);
 
-	/* Set double parameters */
+	/* Compile double parameters */
 	for (Octave_map::iterator p0 = dparam.begin(); p0 != dparam.end(); p0++)
-		set_parameter(task, "dparam", dparam.key(p0), dparam.contents(p0)(0));
+		compile_parameter(task, "dparam", dparam.key(p0), dparam.contents(p0)(0), profile);
 
-	/* Set string parameters */
+	/* Compile string parameters */
 	for (Octave_map::iterator p0 = sparam.begin(); p0 != sparam.end(); p0++)
-		set_parameter(task, "sparam", sparam.key(p0), sparam.contents(p0)(0));
+		compile_parameter(task, "sparam", sparam.key(p0), sparam.contents(p0)(0), profile);
 }
 
-void get_int_parameters(Octave_map &paramvec, MSKtask_t task)
+/* This function checks and sets the parameters of the MOSEK task. */
+void set_parameter(MSKtask_t task, string type, string name, octave_value value)
 {
-	char paramname[MSK_MAX_STR_LEN];
-	char valuename[MSK_MAX_STR_LEN];	MSKintt value;
-	for (int v=MSK_IPAR_BEGIN; v<MSK_IPAR_END; ++v) {
+	Parameter_profile profile;
+	compile_parameter(task, type, name, value, profile);
+	profile.apply(task);
+}
 
-		// Get name of parameter
-		errcatch( MSK_getparamname(task, MSK_PAR_INT_TYPE, v, paramname) );
+void append_parameters(MSKtask_t task, Octave_map& iparam, Octave_map& dparam, Octave_map& sparam) {
+	Parameter_profile profile;
+	compile_parameters(task, iparam, dparam, sparam, profile);
+	profile.apply(task);
+}
 
-		string paramstr = paramname;
-		remove_mskprefix(paramstr, "MSK_IPAR_");
+void get_int_parameters(Octave_map &paramvec, MSKtask_t task, bool nondefault)
+{
+	global_params.init(task);
+
+	MSKintt value;
+	for (MSKintt v=0; v<global_params.size(MSK_PAR_INT_TYPE); ++v) {
+		const Parameter_table::entry &param = global_params.get(MSK_PAR_INT_TYPE, v);
 
 		// Get value of parameter
-		errcatch( MSK_getintparam(task, static_cast<MSKiparame>(v), &value) );
-		errcatch( MSK_iparvaltosymnam(global_env, static_cast<MSKiparame>(v), value, valuename) );
+		errcatch( MSK_getintparam(task, static_cast<MSKiparame>(param.index), &value) );
+		if (nondefault && value == global_params.intdefault(param.index))
+			continue;
 
-		string valuestr = valuename;
-		remove_mskprefix(valuestr, "MSK_");
+		const string &valuestr = global_params.symname(static_cast<MSKiparame>(param.index), value);
 
 		// Append parameter to list
 		if (!valuestr.empty())
-			paramvec.assign(paramstr, octave_value(valuestr, '\"'));
+			paramvec.assign(param.name, octave_value(valuestr, '\"'));
 		else
-			paramvec.assign(paramstr, octave_value(value));
+			paramvec.assign(param.name, octave_value(value));
 	}
 }
 
-void get_dou_parameters(Octave_map &paramvec, MSKtask_t task)
+void get_dou_parameters(Octave_map &paramvec, MSKtask_t task, bool nondefault)
 {
-	char paramname[MSK_MAX_STR_LEN];	MSKrealt value;
-	for (int v=MSK_DPAR_BEGIN; v<MSK_DPAR_END; ++v) {
+	global_params.init(task);
 
-		// Get name of parameter
-		errcatch( MSK_getparamname(task, MSK_PAR_DOU_TYPE, v, paramname) );
-
-		string paramstr = paramname;
-		remove_mskprefix(paramstr, "MSK_DPAR_");
+	MSKrealt value;
+	for (MSKintt v=0; v<global_params.size(MSK_PAR_DOU_TYPE); ++v) {
+		const Parameter_table::entry &param = global_params.get(MSK_PAR_DOU_TYPE, v);
 
 		// Get value of parameter
-		errcatch( MSK_getdouparam(task, static_cast<MSKdparame>(v), &value) );
+		errcatch( MSK_getdouparam(task, static_cast<MSKdparame>(param.index), &value) );
+		if (nondefault && value == global_params.doudefault(param.index))
+			continue;
 
 		// Append parameter to list
-		paramvec.assign(paramstr, octave_value(value));
+		paramvec.assign(param.name, octave_value(value));
 	}
 }
 
-void get_str_parameters(Octave_map &paramvec, MSKtask_t task)
+void get_str_parameters(Octave_map &paramvec, MSKtask_t task, bool nondefault)
 {
-	char paramname[MSK_MAX_STR_LEN];
-	for (int v=MSK_SPAR_BEGIN; v<MSK_SPAR_END; ++v) {
+	global_params.init(task);
 
-		// Get name of parameter
-		errcatch( MSK_getparamname(task, MSK_PAR_STR_TYPE, v, paramname) );
-
-		string paramstr = paramname;
-		remove_mskprefix(paramstr, "MSK_SPAR_");
+	for (MSKintt v=0; v<global_params.size(MSK_PAR_STR_TYPE); ++v) {
+		const Parameter_table::entry &param = global_params.get(MSK_PAR_STR_TYPE, v);
 
 		// Prepare for value of parameter by retrieving length
 		size_t strlength;
-		errcatch( MSK_getstrparam(task, static_cast<MSKsparame>(v), 0, &strlength, NULL) );
+		errcatch( MSK_getstrparam(task, static_cast<MSKsparame>(param.index), 0, &strlength, NULL) );
 
 		// Terminating null-character not counted by 'MSK_getstrparam'
 		++strlength;
 
 		// Get value of parameter
 		auto_array<char> value ( new char[strlength] );
-		errcatch( MSK_getstrparam(task, static_cast<MSKsparame>(v), strlength, NULL, value) );
+		errcatch( MSK_getstrparam(task, static_cast<MSKsparame>(param.index), strlength, NULL, value) );
+		if (nondefault && global_params.strdefault(param.index) == static_cast<char*>(value))
+			continue;
 
 		// Append parameter to list
-		paramvec.assign(paramstr, octave_value(value, '\"'));
+		paramvec.assign(param.name, octave_value(value, '\"'));
 	}
 }
 
@@ -421,8 +422,287 @@ void getspecs_solitem(MSKsoliteme vtype, int NUMVAR, int NUMCON, string &name, i
 	}
 }
 
-/* This function extract the solution from MOSEK. */
-void msk_getsolution(Octave_map &solvec, MSKtask_t task)
+/* This function extracts the status keys of a solution, as strings or as codes. */
+octave_value get_stakeys(MSKtask_t task, MSKsoltypee stype, MSKaccmodee accmode, MSKintt num, bool skcodes)
+{
+	auto_array<MSKstakeye> msksk ( new MSKstakeye[num] );
+
+	errcatch( MSK_getsolutionstatuskeyslice(task,
+							accmode,		/* Request constraint or variable status keys. */
+							stype,			/* Current solution type. */
+							0,				/* Index of first variable. */
+							num,			/* Index of last variable+1. */
+							msksk));
+
+	// Codes are stored in bulk, and can be translated by the table of 'get_stakeymap'
+	if (skcodes) {
+		uint8NDArray skvec(dim_vector(1, num));
+		octave_uint8 *psk = skvec.fortran_vec();
+		for (MSKintt i = 0; i < num; i++) {
+			psk[i] = octave_uint8(msksk[i]);
+		}
+		return octave_value(skvec);
+	}
+
+	Cell skvec(dim_vector(1, num));
+	char skname[MSK_MAX_STR_LEN];
+	for (MSKintt i = 0; i < num; i++) {
+		errcatch( MSK_sktostr(task, msksk[i], skname) );
+		skvec.elem(i) = octave_value(skname, '\"');
+	}
+	return octave_value(skvec);
+}
+
+/* This function returns the names of all status key codes (code i is at index i+1). */
+void get_stakeymap(Cell &skmap, MSKtask_t task)
+{
+	skmap = Cell(dim_vector(1, MSK_SK_END - MSK_SK_BEGIN));
+
+	char skname[MSK_MAX_STR_LEN];
+	for (int sk = MSK_SK_BEGIN; sk < MSK_SK_END; ++sk) {
+		errcatch( MSK_sktostr(task, static_cast<MSKstakeye>(sk), skname) );
+		skmap.elem(sk - MSK_SK_BEGIN) = octave_value(skname, '\"');
+	}
+}
+
+/* This function converts status keys from Octave, given as strings or as codes. */
+void set_stakeys(MSKtask_t task, octave_value &skval, MSKstakeye *msksk, MSKintt num, string name)
+{
+	// Missing status keys are unknown
+	if (isEmpty(skval)) {
+		for (MSKintt i = 0; i < num; i++)
+			msksk[i] = MSK_SK_UNK;
+		return;
+	}
+
+	if (skval.numel() != num)
+		throw msk_exception("The status keys \"" + name + "\" have the wrong dimensions");
+
+	if (skval.is_cell()) {
+		Cell skvec = skval.cell_value();
+		for (MSKintt i = 0; i < num; i++) {
+			if (isEmpty(skvec(i))) {
+				msksk[i] = MSK_SK_UNK;
+			} else {
+				string skname = skvec(i).string_value();
+				if (error_state)
+					throw msk_exception("The status keys \"" + name + "\" should be strings or integer codes");
+
+				MSKintt sk;
+				errcatch( MSK_strtosk(task, const_cast<MSKCONST char*>(skname.c_str()), &sk) );
+				msksk[i] = static_cast<MSKstakeye>(sk);
+			}
+		}
+
+	} else {
+		// Codes are converted in bulk without string lookups
+		uint8NDArray skvec = skval.uint8_array_value();
+		if (error_state)
+			throw msk_exception("The status keys \"" + name + "\" should be strings or integer codes");
+
+		const octave_uint8 *psk = skvec.data();
+		for (MSKintt i = 0; i < num; i++) {
+			int sk = psk[i].value();
+			if (sk < MSK_SK_BEGIN || sk >= MSK_SK_END)
+				throw msk_exception("The status keys \"" + name + "\" contain an unknown code");
+
+			msksk[i] = static_cast<MSKstakeye>(sk);
+		}
+	}
+}
+
+/* This function tells if a solution type or item is in the requested list (all if empty). */
+bool isrequested(const vector<string> &requested, const string &name)
+{
+	if (requested.empty())
+		return true;
+
+	return (std::find(requested.begin(), requested.end(), name) != requested.end());
+}
+
+/* This function returns the solution type of a name, e.g. "itr" (inverse of getspecs_soltype). */
+MSKsoltypee get_msksoltype(const string &name)
+{
+	for (int s=MSK_SOL_BEGIN; s<MSK_SOL_END; ++s) {
+		string sname;
+		getspecs_soltype((MSKsoltypee)s, sname);
+
+		if (sname == name)
+			return (MSKsoltypee)s;
+	}
+	throw msk_exception("The solution type '" + name + "' was not recognized");
+}
+
+/* This function finds the solution item of a slice name, e.g. "xx" (returns false if not a slice). */
+bool get_msksolitem(const string &name, MSKsoliteme &vtype)
+{
+	for (int v=MSK_SOL_ITEM_BEGIN; v<MSK_SOL_ITEM_END; ++v) {
+		string vname;
+		int vsize;
+		getspecs_solitem((MSKsoliteme)v, 0, 0, vname, vsize);
+
+		if (vname == name) {
+			vtype = (MSKsoliteme)v;
+			return true;
+		}
+	}
+	return false;
+}
+
+/* This function lists the solution types defined in task, in the order of msk_getsolution. */
+void get_soltypenames(MSKtask_t task, vector<string> &names)
+{
+	names.clear();
+	for (int s=MSK_SOL_BEGIN; s<MSK_SOL_END; ++s) {
+		MSKintt isdef_soltype;
+		errcatch( MSK_solutiondef(task, (MSKsoltypee)s, &isdef_soltype) );
+
+		if (!isdef_soltype)
+			continue;
+
+		string sname;
+		getspecs_soltype((MSKsoltypee)s, sname);
+		names.push_back(sname);
+	}
+}
+
+/* This function lists the items returned for a solution type, in the order of msk_getsolution. */
+void get_solitemnames(MSKsoltypee stype, vector<string> &names)
+{
+	names.clear();
+	names.push_back("solsta");
+	names.push_back("prosta");
+	names.push_back("skc");
+	names.push_back("skx");
+
+	for (int v=MSK_SOL_ITEM_BEGIN; v<MSK_SOL_ITEM_END; ++v)
+	{
+		MSKsoliteme vtype = (MSKsoliteme)v;
+
+		if (!isdef_solitem(stype, vtype))
+			continue;
+
+		string vname;
+		int vsize;
+		getspecs_solitem(vtype, 0, 0, vname, vsize);
+		names.push_back(vname);
+	}
+}
+
+/* This function extracts a solution slice as a sparse row vector (oriented like the dense items). */
+SparseMatrix get_sparsesolitem(MSKtask_t task, MSKsoltypee stype, MSKsoliteme vtype, MSKintt vsize)
+{
+	vector<double> xx(vsize > 0 ? vsize : 1);
+	const double *pxx = &xx[0];
+
+	errcatch( MSK_getsolutionslice(task, stype, vtype, 0, vsize, &xx[0]) );
+
+	// Count the nonzeros first (a branch-free loop the compiler can vectorize)
+	octave_idx_type nnz = 0;
+	for (MSKintt i = 0; i < vsize; ++i)
+		nnz += (pxx[i] != 0.0);
+
+	// Fill the preallocated matrix directly, one column per element of the slice
+	SparseMatrix sp(1, vsize, nnz);
+	octave_idx_type k = 0;
+	sp.cidx(0) = 0;
+	for (MSKintt i = 0; i < vsize; ++i) {
+		if (pxx[i] != 0.0) {
+			sp.ridx(k) = 0;
+			sp.data(k) = pxx[i];
+			++k;
+		}
+		sp.cidx(i+1) = k;
+	}
+
+	return sp;
+}
+
+/* This function extracts one item, e.g. "solsta", "skx" or "xx", of a solution from MOSEK. */
+octave_value msk_getsolitem(MSKtask_t task, MSKsoltypee stype, const string &item, bool skcodes, bool sparse)
+{
+	MSKintt NUMVAR, NUMCON;
+	errcatch( MSK_getnumvar(task, &NUMVAR) );
+	errcatch( MSK_getnumcon(task, &NUMCON) );
+
+	// The problem status and solution status
+	if (item == "solsta" || item == "prosta") {
+		MSKprostae prosta;
+		MSKsolstae solsta;
+		errcatch( MSK_getsolutionstatus(task, stype, &prosta, &solsta) );
+
+		char sta_str[MSK_MAX_STR_LEN];
+		if (item == "solsta") {
+			errcatch( MSK_solstatostr(task, solsta, sta_str) );
+		} else {
+			errcatch( MSK_prostatostr(task, prosta, sta_str) );
+		}
+		return octave_value(sta_str, '\"');
+	}
+
+	// The constraint and variable status keys
+	if (item == "skc")
+		return get_stakeys(task, stype, MSK_ACC_CON, NUMCON, skcodes);
+
+	if (item == "skx")
+		return get_stakeys(task, stype, MSK_ACC_VAR, NUMVAR, skcodes);
+
+	// The solution variable slices
+	MSKsoliteme vtype;
+	if (get_msksolitem(item, vtype) && isdef_solitem(stype, vtype))
+	{
+		string vname;
+		int vsize;
+		getspecs_solitem(vtype, NUMVAR, NUMCON, vname, vsize);
+
+		if (sparse)
+			return octave_value(get_sparsesolitem(task, stype, vtype, vsize));
+
+		RowVector xx(vsize);
+		double *pxx = xx.fortran_vec();
+		errcatch( MSK_getsolutionslice(task,
+								stype, 		/* Request current solution type. */
+								vtype,		/* Which part of solution. */
+								0, 			/* Index of first variable. */
+								vsize, 		/* Index of last variable+1. */
+								pxx));
+
+		return octave_value(xx);
+	}
+
+	throw msk_exception("The solution item '" + item + "' was not recognized");
+}
+
+/* This function checks the caller-provided buffer of a solution item, and returns false if none is given.
+ * Octave values can not be written in place, so only the shape of the buffer is used: the slice is
+ * returned as a column to be stored by the caller (e.g. X(:,k) = r.outbuf.itr.xx). */
+bool has_outbuffer(const options_type &options, const string &sname, const string &vname, int vsize)
+{
+	Octave_map outbuf = options.outbuf;
+	Octave_map soltype;
+	map_seek_OctaveMap(&soltype, outbuf, sname, true);
+	if (isEmpty(soltype))
+		return false;
+
+	octave_value buf;
+	map_seek_Value(&buf, soltype, vname, true);
+	if (!buf.is_defined())
+		return false;
+
+	string name = options_type::OCT_ARGS.outbuf + "." + sname + "." + vname;
+	if (!buf.is_real_matrix() || !buf.is_double_type() || buf.is_sparse_type())
+		throw msk_exception("Argument '" + name + "' should be a full real matrix (not a scalar or range)");
+
+	int col = scalar2int(options.outcol);
+	if (buf.rows() != vsize || buf.columns() < col)
+		throw msk_exception("Argument '" + name + "' should have " + tostring(vsize) + " rows and at least " + tostring(col) + " columns");
+
+	return true;
+}
+
+/* This function extract the solution from MOSEK. Slices requested by option 'outbuf' are
+ * returned as columns in 'outvec' (organized like the option), if given. */
+void msk_getsolution(Octave_map &solvec, MSKtask_t task, const options_type &options, Octave_map *outvec)
 {
 	printdebug("msk_getsolution called");
 
@@ -434,100 +714,96 @@ void msk_getsolution(Octave_map &solvec, MSKtask_t task)
 	for (int s=MSK_SOL_BEGIN; s<MSK_SOL_END; ++s)
 	{
 		Octave_map soltype;
+		Octave_map soltypebuf;
 
 		MSKsoltypee stype = (MSKsoltypee)s;
+
+		string sname;
+		getspecs_soltype(stype, sname);
+
+		// Skip solution types that were not requested
+		if (!isrequested(options.soltypes, sname))
+			continue;
+
 		MSKintt isdef_soltype;
 		errcatch( MSK_solutiondef(task, stype, &isdef_soltype) );
 
 		if (!isdef_soltype)
 			continue;
 
-		// Add the problem status and solution status
-		MSKprostae prosta;
-		MSKsolstae solsta;
-		errcatch( MSK_getsolutionstatus(task, stype, &prosta, &solsta) );
-
-		char solsta_str[MSK_MAX_STR_LEN];
-		errcatch( MSK_solstatostr(task, solsta, solsta_str) );
-		soltype.assign("solsta", octave_value(solsta_str, '\"'));
-
-		char prosta_str[MSK_MAX_STR_LEN];
-		errcatch( MSK_prostatostr(task, prosta, prosta_str) );
-		soltype.assign("prosta", octave_value(prosta_str, '\"'));
+		// Add the problem status, solution status, status keys and variable slices
+		vector<string> items;
+		get_solitemnames(stype, items);
 
-		// Add the constraint status keys
+		for (size_t i=0; i<items.size(); ++i)
 		{
-			auto_array<MSKstakeye> mskskc ( new MSKstakeye[NUMCON] );
-
-			errcatch( MSK_getsolutionstatuskeyslice(task,
-									MSK_ACC_CON,	/* Request constraint status keys. */
-									stype,			/* Current solution type. */
-									0,				/* Index of first variable. */
-									NUMCON,			/* Index of last variable+1. */
-									mskskc));
-
-			Cell skcvec(dim_vector(1, NUMCON));
-			char skcname[MSK_MAX_STR_LEN];
-			for (int ci = 0; ci < NUMCON; ci++) {
-				errcatch( MSK_sktostr(task, mskskc[ci], skcname) );
-				skcvec.elem(ci) = octave_value(skcname, '\"');
+			// Skip solution items that were not requested (statuses are always added)
+			if (items[i] != "solsta" && items[i] != "prosta")
+				if (!isrequested(options.solitems, items[i]))
+					continue;
+
+			// Return slices with a buffer as columns, allocating only the slice (omitted from result)
+			if (outvec != NULL && options.outbuf.nfields() > 0) {
+				MSKsoliteme vtype;
+				if (get_msksolitem(items[i], vtype)) {
+					string vname;
+					int vsize;
+					getspecs_solitem(vtype, NUMVAR, NUMCON, vname, vsize);
+
+					if (has_outbuffer(options, sname, vname, vsize)) {
+						ColumnVector xx(vsize);
+						errcatch( MSK_getsolutionslice(task, stype, vtype, 0, vsize, xx.fortran_vec()) );
+						soltypebuf.assign(vname, octave_value(xx));
+						continue;
+					}
+				}
 			}
-			soltype.assign("skc", octave_value(skcvec));
-		}
 
-		// Add the variable status keys
-		{
-			auto_array<MSKstakeye> mskskx ( new MSKstakeye[NUMVAR] );
-
-			errcatch( MSK_getsolutionstatuskeyslice(task,
-									MSK_ACC_VAR,	/* Request variable status keys. */
-									stype,			/* Current solution type. */
-									0,				/* Index of first variable. */
-									NUMVAR,			/* Index of last variable+1. */
-									mskskx));
-
-			Cell skxvec(dim_vector(1, NUMVAR));
-			char skxname[MSK_MAX_STR_LEN];
-			for (int xi = 0; xi < NUMVAR; xi++) {
-				errcatch( MSK_sktostr(task, mskskx[xi], skxname) );
-				skxvec.elem(xi) = octave_value(skxname, '\"');
-			}
-			soltype.assign("skx", octave_value(skxvec));
+			bool sparse = !options.sparseitems.empty() && isrequested(options.sparseitems, items[i]);
+			soltype.assign(items[i], msk_getsolitem(task, stype, items[i], options.skcodes, sparse));
 		}
 
-		// Add solution variable slices
-		for (int v=MSK_SOL_ITEM_BEGIN; v<MSK_SOL_ITEM_END; ++v)
-		{
-			MSKsoliteme vtype = (MSKsoliteme)v;
-
-			if (!isdef_solitem(stype, vtype))
-				continue;
-
-			string vname;
-			int vsize;
-			getspecs_solitem(vtype, NUMVAR, NUMCON, vname, vsize);
-
-			RowVector xx(vsize);
-			double *pxx = xx.fortran_vec();
-			errcatch( MSK_getsolutionslice(task,
-									stype, 		/* Request current solution type. */
-									vtype,		/* Which part of solution. */
-									0, 			/* Index of first variable. */
-									vsize, 		/* Index of last variable+1. */
-									pxx));
-
-			soltype.assign(vname, octave_value(xx));
-		}
+		solvec.assign(sname, octave_value(soltype));
+		if (soltypebuf.nfields() > 0)
+			outvec->assign(sname, octave_value(soltypebuf));
+	}
+}
 
-		string sname;
-		getspecs_soltype(stype, sname);
+/* This function copies the defined solutions of one task into another with the same problem.
+ * MSK_putsolution takes no problem or solution status, so these are unknown in the copy. */
+void msk_copysolutions(MSKtask_t from, MSKtask_t to)
+{
+	MSKintt numcon, numvar, numcone;
+	errcatch( MSK_getnumcon(from, &numcon) );
+	errcatch( MSK_getnumvar(from, &numvar) );
+	errcatch( MSK_getnumcone(from, &numcone) );
+
+	// Room for at least one element, such that no pointer is NULL
+	vector<MSKstakeye> skc(numcon + 1), skx(numvar + 1), skn(numcone + 1);
+	vector<MSKrealt> xc(numcon + 1), xx(numvar + 1), y(numcon + 1), slc(numcon + 1), suc(numcon + 1);
+	vector<MSKrealt> slx(numvar + 1), sux(numvar + 1), snx(numvar + 1);
+
+	MSKsoltypee soltypes[] = {MSK_SOL_BAS, MSK_SOL_ITR, MSK_SOL_ITG};
+	for (int i = 0; i < 3; ++i) {
+		MSKintt isdef;
+		errcatch( MSK_solutiondef(from, soltypes[i], &isdef) );
+		if (!isdef)
+			continue;
 
-		solvec.assign(sname, octave_value(soltype));
+		MSKprostae prosta;
+		MSKsolstae solsta;
+		errcatch( MSK_getsolution(from, soltypes[i], &prosta, &solsta, &skc[0], &skx[0], &skn[0],
+				&xc[0], &xx[0], &y[0], &slc[0], &suc[0], &slx[0], &sux[0], &snx[0]) );
+		errcatch( MSK_putsolution(to, soltypes[i], &skc[0], &skx[0], &skn[0],
+				&xc[0], &xx[0], &y[0], &slc[0], &suc[0], &slx[0], &sux[0], &snx[0]) );
 	}
 }
 
 void append_initsol(MSKtask_t task, Octave_map initsol, int NUMCON, int NUMVAR)
 {
+	auto_array<MSKstakeye> mskskc ( new MSKstakeye[NUMCON] );
+	auto_array<MSKstakeye> mskskx ( new MSKstakeye[NUMVAR] );
+
 	for (Octave_map::iterator solitr = initsol.begin();
 							  solitr != initsol.end();
 							  solitr++)
@@ -560,12 +836,12 @@ void append_initsol(MSKtask_t task, Octave_map initsol, int NUMCON, int NUMVAR)
 		}
 
 		// Get current solution items
-		Cell skc; 		map_seek_Cell(&skc, cursol, "skc", true);		validate_Cell(skc, "skc", NUMCON, true);
+		octave_value skc; map_seek_Value(&skc, cursol, "skc", true);
 		RowVector xc;  	map_seek_RowVector(&xc, cursol, "xc", true);	validate_RowVector(xc, "xc", NUMCON, true);
 		RowVector slc; 	map_seek_RowVector(&slc, cursol, "slc", true);	validate_RowVector(slc, "slc", NUMCON, true);
 		RowVector suc; 	map_seek_RowVector(&suc, cursol, "suc", true);	validate_RowVector(suc, "suc", NUMCON, true);
 
-		Cell skx; 		map_seek_Cell(&skx, cursol, "skx", true);		validate_Cell(skx, "skx", NUMVAR, true);
+		octave_value skx; map_seek_Value(&skx, cursol, "skx", true);
 		RowVector xx;  	map_seek_RowVector(&xx, cursol, "xx", true);	validate_RowVector(xx, "xx", NUMVAR, true);
 		RowVector slx; 	map_seek_RowVector(&slx, cursol, "slx", true);	validate_RowVector(slx, "slx", NUMVAR, true);
 		RowVector sux; 	map_seek_RowVector(&sux, cursol, "sux", true);	validate_RowVector(sux, "sux", NUMVAR, true);
@@ -576,20 +852,11 @@ void append_initsol(MSKtask_t task, Octave_map initsol, int NUMCON, int NUMVAR)
 
 		// Set all constraints
 		if (anyinfocon) {
+			set_stakeys(task, skc, mskskc, NUMCON, "skc");
+
 			for (int ci = 0; ci < NUMCON; ci++)
 			{
-				MSKstakeye curskc;
-				if (!isEmpty(skc) || !isEmpty(skc(ci))) {
-					curskc = MSK_SK_UNK;
-				} else {
-					string skcname = skc(ci).string_value();
-					if (error_state)
-						throw msk_exception("The status keys of constraints in the initial solution \"" + name + "\" should be strings");
-
-					MSKintt skcval;
-					errcatch( MSK_strtosk(task, const_cast<MSKCONST char*>(skcname.c_str()), &skcval) );
-					curskc = (MSKstakeye)skcval;
-				}
+				MSKstakeye curskc = mskskc[ci];
 
 				MSKrealt curxc;
 				if (isEmpty(xc)) {
@@ -620,20 +887,11 @@ void append_initsol(MSKtask_t task, Octave_map initsol, int NUMCON, int NUMVAR)
 
 		// Set all variables
 		if (anyinfovar) {
+			set_stakeys(task, skx, mskskx, NUMVAR, "skx");
+
 			for (int xi = 0; xi < NUMVAR; xi++)
 			{
-				MSKstakeye curskx;
-				if (isEmpty(skx) || isEmpty(skx(xi))) {
-					curskx = MSK_SK_UNK;
-				} else {
-					string skxname = skx(xi).string_value();
-					if (error_state)
-						throw msk_exception("The status keys of variables in the initial solution \"" + name + "\" should be strings");
-
-					MSKintt skxval;
-					errcatch( MSK_strtosk(task, const_cast<MSKCONST char*>(skxname.c_str()), &skxval) );
-					curskx = (MSKstakeye)skxval;
-				}
+				MSKstakeye curskx = mskskx[xi];
 
 				MSKrealt curxx;
 				if (isEmpty(xx)) {
@@ -3,11 +3,13 @@
 
 #include "omsk_msg_mosek.h"
 #include "omsk_obj_mosek.h"
+#include "omsk_obj_parameters.h"
 
 #include "omsk_obj_arguments.h"
 #include "omsk_obj_constraints.h"
 
 #include <string>
+#include <vector>
 
 
 // ------------------------------
@@ -27,14 +29,32 @@ void set_boundkey(double bl, double bu, MSKboundkeye *bk);
 void get_boundvalues(MSKtask_t task, double *lower, double* upper, MSKaccmodee boundtype, MSKintt numbounds);
 
 // Gets and sets the parameters in task
+void compile_parameter(MSKtask_t task, std::string type, std::string name, octave_value value, Parameter_profile &profile);
+void compile_parameters(MSKtask_t task, Octave_map& iparam, Octave_map& dparam, Octave_map& sparam, Parameter_profile &profile);
 void set_parameter(MSKtask_t task, std::string type, std::string name, octave_value value);
 void append_parameters(MSKtask_t task, Octave_map& iparam, Octave_map& dparam, Octave_map& sparam);
-void get_int_parameters(Octave_map &paramvec, MSKtask_t task);
-void get_dou_parameters(Octave_map &paramvec, MSKtask_t task);
-void get_str_parameters(Octave_map &paramvec, MSKtask_t task);
+void get_int_parameters(Octave_map &paramvec, MSKtask_t task, bool nondefault=false);
+void get_dou_parameters(Octave_map &paramvec, MSKtask_t task, bool nondefault=false);
+void get_str_parameters(Octave_map &paramvec, MSKtask_t task, bool nondefault=false);
+
+// Get and set status keys as strings or codes
+octave_value get_stakeys(MSKtask_t task, MSKsoltypee stype, MSKaccmodee accmode, MSKintt num, bool skcodes);
+void get_stakeymap(Cell &skmap, MSKtask_t task);
+void set_stakeys(MSKtask_t task, octave_value &skval, MSKstakeye *msksk, MSKintt num, std::string name);
 
 // Get and set solutions in task
-void msk_getsolution(Octave_map &solvec, MSKtask_t task);
+bool isdef_solitem(MSKsoltypee s, MSKsoliteme v);
+void getspecs_solitem(MSKsoliteme vtype, int NUMVAR, int NUMCON, std::string &name, int &size);
+MSKsoltypee get_msksoltype(const std::string &name);
+bool get_msksolitem(const std::string &name, MSKsoliteme &vtype);
+void get_soltypenames(MSKtask_t task, std::vector<std::string> &names);
+void get_solitemnames(MSKsoltypee stype, std::vector<std::string> &names);
+SparseMatrix get_sparsesolitem(MSKtask_t task, MSKsoltypee stype, MSKsoliteme vtype, MSKintt vsize);
+octave_value msk_getsolitem(MSKtask_t task, MSKsoltypee stype, const std::string &item, bool skcodes, bool sparse=false);
+bool has_outbuffer(const options_type &options, const std::string &sname, const std::string &vname, int vsize);
+bool isrequested(const std::vector<std::string> &requested, const std::string &name);
+void msk_getsolution(Octave_map &solvec, MSKtask_t task, const options_type &options, Octave_map *outvec = NULL);
+void msk_copysolutions(MSKtask_t from, MSKtask_t to);
 void append_initsol(MSKtask_t task, Octave_map initsol, int NUMCON, int NUMVAR);
 
 // Initialise the task and load problem from arguments
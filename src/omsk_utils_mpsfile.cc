@@ -0,0 +1,1516 @@
+#include "omsk_utils_mpsfile.h"
+
+#include "omsk_utils_threads.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cctype>
+#include <cmath>
+#include <climits>
+
+using std::string;
+using std::vector;
+
+// Tokens kept per line (longer lines are rejected in all sections)
+#define OMSK_MPS_MAXTOKENS		8
+
+// Longest number accepted, and smallest chunk of the COLUMNS section per job
+#define OMSK_MPS_MAXNUMBER		64
+#define OMSK_MPS_MINCHUNK		(1 << 20)
+
+// Bounds of this magnitude or larger are infinite (as in MOSEK)
+#define OMSK_MPS_INFINITY		1.0e30
+
+/* This function returns true if 'filepath' ends with the lower-case extension 'ext' in any case. */
+static bool has_extension(const string &filepath, const string &ext)
+{
+	if (filepath.length() <= ext.length())
+		return false;
+
+	for (size_t i = 0; i < ext.length(); ++i)
+		if (tolower(filepath[filepath.length() - ext.length() + i]) != ext[i])
+			return false;
+
+	return true;
+}
+
+bool is_mpsfile(const string &filepath)
+{
+	return has_extension(filepath, ".mps");
+}
+
+bool is_lpfile(const string &filepath)
+{
+	return has_extension(filepath, ".lp");
+}
+
+bool is_opffile(const string &filepath)
+{
+	return has_extension(filepath, ".opf");
+}
+
+
+// ------------------------------
+// Lines and tokens
+// ------------------------------
+
+struct mps_line {
+	const char	*begin;
+	const char	*end;
+	int			numtok;
+	const char	*tok[OMSK_MPS_MAXTOKENS];
+	size_t		len[OMSK_MPS_MAXTOKENS];
+};
+
+static inline bool is_blank(char ch)
+{
+	return (ch == ' ' || ch == '\t' || ch == '\r');
+}
+
+/* This function tokenizes the line starting at 'p', and returns the start of the next line. */
+static const char* read_line(const char *p, const char *end, mps_line &line)
+{
+	const char *eol = static_cast<const char*>(memchr(p, '\n', end - p));
+	if (eol == NULL)
+		eol = end;
+
+	line.begin = p;
+	line.end = eol;
+	line.numtok = 0;
+
+	// Comment lines have no tokens
+	if (p < eol && *p == '*')
+		p = eol;
+
+	while (p < eol) {
+		while (p < eol && is_blank(*p))
+			++p;
+		if (p == eol)
+			break;
+
+		const char *start = p;
+		while (p < eol && !is_blank(*p))
+			++p;
+
+		if (line.numtok < OMSK_MPS_MAXTOKENS) {
+			line.tok[line.numtok] = start;
+			line.len[line.numtok] = p - start;
+		}
+		++line.numtok;
+	}
+
+	return (eol < end) ? eol + 1 : end;
+}
+
+static inline bool token_equals(const mps_line &line, int i, const char *str, size_t len)
+{
+	return (line.len[i] == len && memcmp(line.tok[i], str, len) == 0);
+}
+
+static inline bool token_equals(const mps_line &line, int i, const char *str)
+{
+	return token_equals(line, i, str, strlen(str));
+}
+
+static string token_string(const mps_line &line, int i)
+{
+	return string(line.tok[i], line.len[i]);
+}
+
+static msk_exception line_error(const string &filepath, const mps_line &line, const string &msg)
+{
+	string text(line.begin, std::min<size_t>(line.end - line.begin, 80));
+	if (!text.empty() && text[text.length()-1] == '\r')
+		text.erase(text.length()-1);
+
+	return msk_exception(msg + " in MPS file '" + filepath + "' at line: " + text);
+}
+
+/* This function parses token 'i' as a number (safe to call from worker threads). */
+static double parse_number(const string &filepath, const mps_line &line, int i)
+{
+	char buf[OMSK_MPS_MAXNUMBER];
+	if (line.len[i] >= sizeof(buf))
+		throw line_error(filepath, line, "Invalid number '" + token_string(line, i) + "'");
+
+	memcpy(buf, line.tok[i], line.len[i]);
+	buf[line.len[i]] = '\0';
+
+	char *endptr;
+	double value = strtod(buf, &endptr);
+	if (endptr != buf + line.len[i])
+		throw line_error(filepath, line, "Invalid number '" + token_string(line, i) + "'");
+
+	return value;
+}
+
+/* This function parses token 'i' as a bound, where magnitudes of 1e30 and above mean infinity as in MOSEK. */
+static double parse_bound(const string &filepath, const mps_line &line, int i)
+{
+	double value = parse_number(filepath, line, i);
+	if (value >= OMSK_MPS_INFINITY)
+		return INFINITY;
+	if (value <= -OMSK_MPS_INFINITY)
+		return -INFINITY;
+	return value;
+}
+
+/* This function recognizes section headers, which start in the first column with a keyword. */
+static bool is_header(const mps_line &line)
+{
+	if (line.numtok == 0 || is_blank(*line.begin))
+		return false;
+
+	static const char *keywords[] = {
+		"NAME", "OBJSENSE", "OBJNAME", "ROWS", "COLUMNS", "RHS", "RANGES", "BOUNDS", "CSECTION", "ENDATA",
+		"QSECTION", "QMATRIX", "QUADOBJ", "QCMATRIX", "SOS", "INDICATORS", "LAZYCONS", "USERCUTS"
+	};
+	for (size_t i = 0; i < sizeof(keywords)/sizeof(char*); ++i)
+		if (token_equals(line, 0, keywords[i]))
+			return true;
+
+	return false;
+}
+
+/* This function returns the start of the next section header, or 'end' if there is none. */
+static const char* find_header(const char *p, const char *end)
+{
+	mps_line line;
+	while (p < end) {
+		// Only lines starting in the first column can be headers
+		if (!is_blank(*p) && *p != '*' && *p != '\n') {
+			const char *next = read_line(p, end, line);
+			if (is_header(line))
+				return p;
+			p = next;
+		} else {
+			const char *eol = static_cast<const char*>(memchr(p, '\n', end - p));
+			p = (eol != NULL) ? eol + 1 : end;
+		}
+	}
+	return end;
+}
+
+static bool parse_sense(const mps_line &line, int i, MSKobjsensee &sense)
+{
+	if (token_equals(line, i, "MAX") || token_equals(line, i, "MAXIMIZE")) {
+		sense = MSK_OBJECTIVE_SENSE_MAXIMIZE;
+		return true;
+	}
+	if (token_equals(line, i, "MIN") || token_equals(line, i, "MINIMIZE")) {
+		sense = MSK_OBJECTIVE_SENSE_MINIMIZE;
+		return true;
+	}
+	return false;
+}
+
+
+// ------------------------------
+// Class Name_table
+// ------------------------------
+
+/* This function is the FNV-1a hash of a name. */
+static inline size_t hash_name(const char *name, size_t len)
+{
+	size_t h = 2166136261u;
+	for (size_t i = 0; i < len; ++i) {
+		h ^= static_cast<unsigned char>(name[i]);
+		h *= 16777619u;
+	}
+	return h;
+}
+
+void Name_table::grow()
+{
+	vector<entry> old;
+	old.swap(table);
+
+	entry empty = {NULL, 0, -1};
+	table.assign(old.empty() ? 1024 : 2 * old.size(), empty);
+	size_t mask = table.size() - 1;
+
+	for (vector<entry>::const_iterator it = old.begin(); it != old.end(); ++it) {
+		if (it->name == NULL)
+			continue;
+
+		size_t k = hash_name(it->name, it->len) & mask;
+		while (table[k].name != NULL)
+			k = (k + 1) & mask;
+		table[k] = *it;
+	}
+}
+
+MSKintt Name_table::insert(const char *name, size_t len, MSKintt index)
+{
+	// Keep the table at most half full
+	if (2 * (numused + 1) > table.size())
+		grow();
+
+	size_t mask = table.size() - 1;
+	size_t k = hash_name(name, len) & mask;
+	while (table[k].name != NULL) {
+		if (table[k].len == len && memcmp(table[k].name, name, len) == 0)
+			return table[k].index;
+		k = (k + 1) & mask;
+	}
+
+	table[k].name = name;
+	table[k].len = len;
+	table[k].index = index;
+	++numused;
+	return index;
+}
+
+MSKintt Name_table::find(const char *name, size_t len) const
+{
+	if (table.empty())
+		return -1;
+
+	size_t mask = table.size() - 1;
+	size_t k = hash_name(name, len) & mask;
+	while (table[k].name != NULL) {
+		if (table[k].len == len && memcmp(table[k].name, name, len) == 0)
+			return table[k].index;
+		k = (k + 1) & mask;
+	}
+	return -1;
+}
+
+
+// ------------------------------
+// Class Mpsfile_reader
+// ------------------------------
+
+// A block of consecutive lines in a chunk of the COLUMNS section, belonging to
+// the same column (or a single marker line)
+struct mps_run {
+	const char	*name;
+	size_t		len;
+	int			marker;		// 0 (entries), 1 (INTORG) or 2 (INTEND)
+	MSKintt		count;		// Non-zeros, excluding the objective
+	double		cobj;
+	bool		hasobj;
+	MSKintt		offset;		// Position of the first non-zero in the matrix
+};
+
+struct Mpsfile_reader::chunk_type {
+	const char	*begin;
+	const char	*end;
+	vector<mps_run> runs;
+
+	// Range of the absolute non-zero values (found in the second pass)
+	double		amin;
+	double		amax;
+
+	chunk_type(const char *begin, const char *end) : begin(begin), end(end), amin(INFINITY), amax(0.0) {}
+};
+
+/* This function classifies a line of the COLUMNS section, returning its marker type or 0 for entries. */
+static int column_marker(const string &filepath, const mps_line &line)
+{
+	if (line.numtok > OMSK_MPS_MAXTOKENS)
+		throw line_error(filepath, line, "Too many fields");
+
+	if (line.numtok >= 3 && token_equals(line, 1, "'MARKER'")) {
+		if (token_equals(line, line.numtok - 1, "'INTORG'"))
+			return 1;
+		if (token_equals(line, line.numtok - 1, "'INTEND'"))
+			return 2;
+		throw line_error(filepath, line, "Unknown marker");
+	}
+
+	if (line.numtok != 3 && line.numtok != 5)
+		throw line_error(filepath, line, "Expected a column name and one or two pairs of row name and value");
+
+	return 0;
+}
+
+/* This function decides whether a line of the COLUMNS section starts a new run. */
+static inline bool starts_run(const mps_line &line, int marker, const mps_run *last)
+{
+	return (marker != 0 || last == NULL || last->marker != 0 ||
+			!token_equals(line, 0, last->name, last->len));
+}
+
+Mpsfile_reader::Mpsfile_reader() :
+	numthreads(1),
+	sub(NULL),
+	val(NULL),
+
+	numvar(0),
+	numcon(0),
+	numnz(0),
+	sense(MSK_OBJECTIVE_SENSE_MINIMIZE),
+	c0(0.0)
+{}
+
+void Mpsfile_reader::close()
+{
+	for (size_t i = 0; i < chunks.size(); ++i)
+		delete chunks[i];
+	chunks.clear();
+	file.close();
+
+	rows = Name_table();
+	cols = Name_table();
+	rowtype.clear();
+	isint.clear();
+	objname.clear();
+	colptr.clear();
+
+	numvar = numcon = numnz = 0;
+	sense = MSK_OBJECTIVE_SENSE_MINIMIZE;
+	c0 = 0.0;
+	c.clear();		blc.clear();	buc.clear();	blx.clear();	bux.clear();
+	intsub.clear();	conetypes.clear();	coneptr.clear();	conesub.clear();
+}
+
+void Mpsfile_reader::open(const string &path, int threads)
+{
+	close();
+	filepath = path;
+	numthreads = std::max(1, threads);
+
+	file.open(filepath);
+	const char *p = file.data();
+	const char *end = p + file.length();
+
+	enum { NONE, NAME, OBJSENSE, OBJNAME, ROWS, COLUMNS, RHS, RANGES, BOUNDS, CSECTION } section = NONE;
+	bool hasobjrow = false;
+	bool ended = false;
+	vector<double> rhs, ranges;
+	vector<bool> hasrange;
+	colptr.assign(1, 0);
+	coneptr.assign(1, 0);
+
+	mps_line line;
+	while (p < end && !ended) {
+		const char *next = read_line(p, end, line);
+
+		if (line.numtok == 0) {
+			p = next;
+			continue;
+		}
+		if (line.numtok > OMSK_MPS_MAXTOKENS)
+			throw line_error(filepath, line, "Too many fields");
+
+		// Section headers
+		if (is_header(line)) {
+			if (token_equals(line, 0, "NAME")) {
+				section = NAME;
+
+			} else if (token_equals(line, 0, "OBJSENSE")) {
+				section = OBJSENSE;
+				if (line.numtok >= 2 && !parse_sense(line, 1, sense))
+					throw line_error(filepath, line, "Unknown objective sense");
+
+			} else if (token_equals(line, 0, "OBJNAME")) {
+				section = OBJNAME;
+				if (line.numtok >= 2)
+					objname = token_string(line, 1);
+
+			} else if (token_equals(line, 0, "ROWS")) {
+				section = ROWS;
+
+			} else if (token_equals(line, 0, "COLUMNS")) {
+				// The whole section is parsed in parallel
+				section = COLUMNS;
+				const char *colend = find_header(next, end);
+				parse_columns(next, colend);
+				next = colend;
+
+			} else if (token_equals(line, 0, "RHS") || token_equals(line, 0, "RANGES")) {
+				section = token_equals(line, 0, "RHS") ? RHS : RANGES;
+				if (rhs.empty()) {
+					rhs.assign(numcon, 0.0);
+					ranges.assign(numcon, 0.0);
+					hasrange.assign(numcon, false);
+				}
+
+			} else if (token_equals(line, 0, "BOUNDS")) {
+				section = BOUNDS;
+
+			} else if (token_equals(line, 0, "CSECTION")) {
+				section = CSECTION;
+				if (line.numtok < 3)
+					throw line_error(filepath, line, "Expected a cone name and type");
+
+				// The cone type is the last field
+				if (token_equals(line, line.numtok - 1, "QUAD"))
+					conetypes.push_back("QUAD");
+				else if (token_equals(line, line.numtok - 1, "RQUAD"))
+					conetypes.push_back("RQUAD");
+				else
+					throw line_error(filepath, line, "Unknown cone type");
+
+				coneptr.push_back(coneptr.back());
+
+			} else if (token_equals(line, 0, "ENDATA")) {
+				ended = true;
+
+			} else {
+				throw line_error(filepath, line, "The section '" + token_string(line, 0) + "' is not supported by the native reader");
+			}
+
+			p = next;
+			continue;
+		}
+
+		// Data lines
+		switch (section) {
+			case NONE:
+				throw line_error(filepath, line, "Data outside of any section");
+
+			case NAME:
+				break;
+
+			case OBJSENSE:
+				if (!parse_sense(line, 0, sense))
+					throw line_error(filepath, line, "Unknown objective sense");
+				break;
+
+			case OBJNAME:
+				objname = token_string(line, 0);
+				break;
+
+			case ROWS: {
+				if (line.numtok != 2 || line.len[0] != 1 || !strchr("NELG", line.tok[0][0]))
+					throw line_error(filepath, line, "Expected a row type (N, E, L or G) and name");
+
+				char type = line.tok[0][0];
+
+				// The objective is the first N row, unless named by OBJNAME
+				if (!hasobjrow && (objname.empty() || token_equals(line, 1, objname.data(), objname.size()))) {
+					if (type == 'N') {
+						objname = token_string(line, 1);
+						hasobjrow = true;
+						break;
+					}
+					if (!objname.empty())
+						throw line_error(filepath, line, "The objective row should have type N");
+				}
+
+				if (numcon == INT_MAX)
+					throw msk_exception("The MPS file '" + filepath + "' has too many rows");
+				if (rows.insert(line.tok[1], line.len[1], numcon) != numcon)
+					throw line_error(filepath, line, "Duplicate row name");
+
+				rowtype.push_back(type);
+				++numcon;
+				break;
+			}
+
+			case COLUMNS:
+				break;
+
+			case RHS:
+			case RANGES: {
+				// The name of the vector is optional
+				if (line.numtok < 2 || line.numtok > 5)
+					throw line_error(filepath, line, "Expected one or two pairs of row name and value");
+
+				for (int k = line.numtok % 2; k < line.numtok; k += 2) {
+					if (token_equals(line, k, objname.data(), objname.size())) {
+						// The right-hand side of the objective is minus the constant
+						if (section == RHS)
+							c0 = -parse_number(filepath, line, k+1);
+						continue;
+					}
+
+					double value = parse_bound(filepath, line, k+1);
+
+					MSKintt row = rows.find(line.tok[k], line.len[k]);
+					if (row < 0)
+						throw line_error(filepath, line, "Unknown row '" + token_string(line, k) + "'");
+
+					if (section == RHS)
+						rhs[row] = value;
+					else {
+						ranges[row] = value;
+						hasrange[row] = true;
+					}
+				}
+				break;
+			}
+
+			case BOUNDS: {
+				if (line.numtok < 2)
+					throw line_error(filepath, line, "Expected a bound type and column name");
+
+				bool hasvalue = (token_equals(line, 0, "UP") || token_equals(line, 0, "LO") || token_equals(line, 0, "FX") ||
+								 token_equals(line, 0, "LI") || token_equals(line, 0, "UI"));
+
+				// The name of the bound vector is optional
+				int k;
+				if (hasvalue)
+					k = (line.numtok == 4) ? 2 : 1;
+				else
+					k = (line.numtok >= 3) ? 2 : 1;
+
+				if (hasvalue && k + 1 >= line.numtok)
+					throw line_error(filepath, line, "Expected a bound value");
+
+				MSKintt col = cols.find(line.tok[k], line.len[k]);
+				if (col < 0)
+					throw line_error(filepath, line, "Unknown column '" + token_string(line, k) + "'");
+
+				double value = hasvalue ? parse_bound(filepath, line, k+1) : 0.0;
+
+				if (token_equals(line, 0, "UP")) {
+					// A negative upper bound frees the default lower bound
+					if (value < 0 && blx[col] == 0.0)
+						blx[col] = -INFINITY;
+					bux[col] = value;
+				} else if (token_equals(line, 0, "LO")) {
+					blx[col] = value;
+				} else if (token_equals(line, 0, "FX")) {
+					blx[col] = bux[col] = value;
+				} else if (token_equals(line, 0, "FR")) {
+					blx[col] = -INFINITY;
+					bux[col] = INFINITY;
+				} else if (token_equals(line, 0, "MI")) {
+					blx[col] = -INFINITY;
+				} else if (token_equals(line, 0, "PL")) {
+					bux[col] = INFINITY;
+				} else if (token_equals(line, 0, "BV")) {
+					isint[col] = true;
+					blx[col] = 0.0;
+					bux[col] = 1.0;
+				} else if (token_equals(line, 0, "LI")) {
+					isint[col] = true;
+					blx[col] = value;
+				} else if (token_equals(line, 0, "UI")) {
+					isint[col] = true;
+					bux[col] = value;
+				} else {
+					throw line_error(filepath, line, "Unknown bound type");
+				}
+				break;
+			}
+
+			case CSECTION: {
+				MSKintt col = cols.find(line.tok[0], line.len[0]);
+				if (col < 0)
+					throw line_error(filepath, line, "Unknown column '" + token_string(line, 0) + "'");
+
+				conesub.push_back(col);
+				++coneptr.back();
+				break;
+			}
+		}
+
+		p = next;
+	}
+
+	if (!ended)
+		throw msk_exception("The MPS file '" + filepath + "' has no ENDATA section");
+
+	// Constraint bounds from the right-hand sides and ranges
+	if (rhs.empty()) {
+		rhs.assign(numcon, 0.0);
+		ranges.assign(numcon, 0.0);
+		hasrange.assign(numcon, false);
+	}
+
+	blc.resize(numcon);
+	buc.resize(numcon);
+	for (MSKintt i = 0; i < numcon; ++i) {
+		double r = ranges[i];
+		switch (rowtype[i]) {
+			case 'N':
+				blc[i] = -INFINITY;
+				buc[i] = INFINITY;
+				break;
+			case 'E':
+				// The sign of the range decides the side it extends
+				blc[i] = (r < 0) ? rhs[i] + r : rhs[i];
+				buc[i] = (r > 0) ? rhs[i] + r : rhs[i];
+				break;
+			case 'L':
+				blc[i] = hasrange[i] ? rhs[i] - fabs(r) : -INFINITY;
+				buc[i] = rhs[i];
+				break;
+			case 'G':
+				blc[i] = rhs[i];
+				buc[i] = hasrange[i] ? rhs[i] + fabs(r) : INFINITY;
+				break;
+		}
+	}
+
+	for (MSKintt j = 0; j < numvar; ++j)
+		if (isint[j])
+			intsub.push_back(j);
+}
+
+void Mpsfile_reader::parse_columns(const char *begin, const char *end)
+{
+	if (!chunks.empty())
+		throw msk_exception("The MPS file '" + filepath + "' has more than one COLUMNS section");
+
+	// Cut the section into chunks at line boundaries
+	size_t target = std::max<size_t>(OMSK_MPS_MINCHUNK, (end - begin) / (4 * numthreads) + 1);
+	const char *p = begin;
+	while (p < end) {
+		const char *q = end;
+		if (static_cast<size_t>(end - p) > target) {
+			const char *eol = static_cast<const char*>(memchr(p + target, '\n', end - p - target));
+			q = (eol != NULL) ? eol + 1 : end;
+		}
+		chunks.push_back(NULL);
+		chunks.back() = new chunk_type(p, q);
+		p = q;
+	}
+
+	// First pass: count the non-zeros of the column runs in each chunk
+	run_parallel(count_job, this, static_cast<int>(chunks.size()), numthreads);
+
+	merge_chunks();
+}
+
+void Mpsfile_reader::count_job(int i, void *data)
+{
+	Mpsfile_reader &reader = *static_cast<Mpsfile_reader*>(data);
+	chunk_type &chunk = *reader.chunks[i];
+	const string &objname = reader.objname;
+
+	mps_line line;
+	const char *p = chunk.begin;
+	while (p < chunk.end) {
+		p = read_line(p, chunk.end, line);
+		if (line.numtok == 0)
+			continue;
+
+		int marker = column_marker(reader.filepath, line);
+		if (starts_run(line, marker, chunk.runs.empty() ? NULL : &chunk.runs.back())) {
+			mps_run run = {line.tok[0], line.len[0], marker, 0, 0.0, false, 0};
+			chunk.runs.push_back(run);
+		}
+		if (marker != 0)
+			continue;
+
+		mps_run &run = chunk.runs.back();
+		for (int k = 1; k < line.numtok; k += 2) {
+			if (token_equals(line, k, objname.data(), objname.size())) {
+				if (run.hasobj)
+					throw line_error(reader.filepath, line, "Duplicate objective coefficient");
+				run.cobj = parse_number(reader.filepath, line, k+1);
+				run.hasobj = true;
+			} else {
+				if (run.count == INT_MAX)
+					throw line_error(reader.filepath, line, "Too many non-zeros");
+				++run.count;
+			}
+		}
+	}
+}
+
+void Mpsfile_reader::merge_chunks()
+{
+	bool intmode = false;
+	vector<bool> hasobj;
+	const mps_run *last = NULL;
+	MSKintt offset = 0;
+
+	// Columns are numbered in order of appearance, so their non-zeros are consecutive
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		vector<mps_run> &runs = chunks[i]->runs;
+
+		for (size_t r = 0; r < runs.size(); ++r) {
+			mps_run &run = runs[r];
+
+			if (run.marker != 0) {
+				intmode = (run.marker == 1);
+				last = &run;
+				continue;
+			}
+
+			bool samecol = (last != NULL && last->marker == 0 && last->len == run.len && memcmp(last->name, run.name, run.len) == 0);
+			if (!samecol) {
+				if (cols.insert(run.name, run.len, numvar) != numvar)
+					throw msk_exception("The column '" + string(run.name, run.len) + "' in MPS file '" + filepath + "' is not given in one contiguous block");
+
+				c.push_back(0.0);
+				hasobj.push_back(false);
+				isint.push_back(intmode);
+				colptr.push_back(offset);
+				++numvar;
+			}
+			last = &run;
+
+			MSKintt col = numvar - 1;
+			if (run.hasobj) {
+				if (hasobj[col])
+					throw msk_exception("The column '" + string(run.name, run.len) + "' in MPS file '" + filepath + "' has more than one objective coefficient");
+				c[col] = run.cobj;
+				hasobj[col] = true;
+			}
+
+			if (run.count > INT_MAX - offset)
+				throw msk_exception("The MPS file '" + filepath + "' has too many non-zeros");
+
+			run.offset = offset;
+			offset += run.count;
+			colptr[col+1] = offset;
+		}
+	}
+
+	numnz = offset;
+	blx.assign(numvar, 0.0);
+	bux.assign(numvar, INFINITY);
+}
+
+void Mpsfile_reader::fill_job(int i, void *data)
+{
+	Mpsfile_reader &reader = *static_cast<Mpsfile_reader*>(data);
+	chunk_type &chunk = *reader.chunks[i];
+	const string &objname = reader.objname;
+
+	// Second pass: the lines are split into runs exactly as in the first
+	mps_line line;
+	const mps_run *run = NULL;
+	size_t r = 0;
+	MSKintt pos = 0;
+
+	const char *p = chunk.begin;
+	while (p < chunk.end) {
+		p = read_line(p, chunk.end, line);
+		if (line.numtok == 0)
+			continue;
+
+		int marker = column_marker(reader.filepath, line);
+		if (starts_run(line, marker, run)) {
+			run = &chunk.runs[r++];
+			pos = run->offset;
+		}
+		if (marker != 0)
+			continue;
+
+		for (int k = 1; k < line.numtok; k += 2) {
+			if (token_equals(line, k, objname.data(), objname.size()))
+				continue;
+
+			MSKintt row = reader.rows.find(line.tok[k], line.len[k]);
+			if (row < 0)
+				throw line_error(reader.filepath, line, "Unknown row '" + token_string(line, k) + "'");
+
+			double value = parse_number(reader.filepath, line, k+1);
+			if (value != 0.0) {
+				chunk.amin = std::min(chunk.amin, fabs(value));
+				chunk.amax = std::max(chunk.amax, fabs(value));
+			}
+
+			// The values are not kept when only scanning the matrix
+			reader.sub[pos] = row;
+			if (reader.val != NULL)
+				reader.val[pos] = value;
+			++pos;
+		}
+	}
+}
+
+/* This function returns the number of jobs sorting the columns. */
+static int get_numsortjobs(MSKintt numvar, int numthreads)
+{
+	return static_cast<int>(std::min<MSKintt>(numvar, 4 * numthreads));
+}
+
+void Mpsfile_reader::sort_job(int i, void *data)
+{
+	Mpsfile_reader &reader = *static_cast<Mpsfile_reader*>(data);
+	int numjobs = get_numsortjobs(reader.numvar, reader.numthreads);
+
+	MSKintt first = static_cast<MSKintt>(static_cast<MSKint64t>(reader.numvar) * i / numjobs);
+	MSKintt last = static_cast<MSKintt>(static_cast<MSKint64t>(reader.numvar) * (i+1) / numjobs);
+
+	vector< std::pair<MSKlidxt, double> > entries;
+	for (MSKintt j = first; j < last; ++j) {
+		MSKintt begin = reader.colptr[j];
+		MSKintt end = reader.colptr[j+1];
+
+		// Most columns are already sorted
+		bool sorted = true;
+		for (MSKintt k = begin + 1; k < end && sorted; ++k)
+			sorted = (reader.sub[k-1] < reader.sub[k]);
+		if (sorted)
+			continue;
+
+		entries.clear();
+		for (MSKintt k = begin; k < end; ++k)
+			entries.push_back(std::make_pair(reader.sub[k], reader.val[k]));
+		std::sort(entries.begin(), entries.end());
+
+		for (MSKintt k = begin; k < end; ++k) {
+			if (k > begin && entries[k-begin].first == entries[k-begin-1].first)
+				throw msk_exception("Column " + tostring(j+1) + " in MPS file '" + reader.filepath + "' has more than one entry in the same row");
+
+			reader.sub[k] = entries[k-begin].first;
+			reader.val[k] = entries[k-begin].second;
+		}
+	}
+}
+
+void Mpsfile_reader::fill_matrix(MSKintt *ptrb, MSKlidxt *sub, double *val)
+{
+	if (colptr.size() != static_cast<size_t>(numvar) + 1)
+		throw msk_exception("Internal error in Mpsfile_reader::fill_matrix, no file was read");
+
+	for (MSKintt j = 0; j <= numvar; ++j)
+		ptrb[j] = colptr[j];
+
+	this->sub = sub;
+	this->val = val;
+
+	try {
+		// Second pass: write the non-zeros of each chunk in place
+		run_parallel(fill_job, this, static_cast<int>(chunks.size()), numthreads);
+
+		// Sort the rows within each column
+		run_parallel(sort_job, this, get_numsortjobs(numvar, numthreads), numthreads);
+
+	} catch (...) {
+		this->sub = NULL;
+		this->val = NULL;
+		throw;
+	}
+
+	this->sub = NULL;
+	this->val = NULL;
+}
+
+void Mpsfile_reader::scan_matrix(MSKintt *rownz, double &amin, double &amax)
+{
+	if (colptr.size() != static_cast<size_t>(numvar) + 1)
+		throw msk_exception("Internal error in Mpsfile_reader::scan_matrix, no file was read");
+
+	// Only the row indexes are kept, in place of the full matrix
+	vector<MSKlidxt> rowidx(numnz);
+	this->sub = rowidx.empty() ? NULL : &rowidx[0];
+	this->val = NULL;
+
+	try {
+		run_parallel(fill_job, this, static_cast<int>(chunks.size()), numthreads);
+
+	} catch (...) {
+		this->sub = NULL;
+		throw;
+	}
+	this->sub = NULL;
+
+	for (MSKintt i = 0; i < numcon; ++i)
+		rownz[i] = 0;
+	for (MSKintt k = 0; k < numnz; ++k)
+		++rownz[rowidx[k]];
+
+	amin = INFINITY;
+	amax = 0.0;
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		amin = std::min(amin, chunks[i]->amin);
+		amax = std::max(amax, chunks[i]->amax);
+	}
+}
+
+void Mpsfile_reader::get_colnz(MSKintt *colnz) const
+{
+	if (colptr.size() != static_cast<size_t>(numvar) + 1)
+		throw msk_exception("Internal error in Mpsfile_reader::get_colnz, no file was read");
+
+	for (MSKintt j = 0; j < numvar; ++j)
+		colnz[j] = colptr[j+1] - colptr[j];
+}
+
+
+// ------------------------------
+// Class Modelfile_writer
+// ------------------------------
+
+// Non-zeros per chunk of the constraint matrix formatted by one job
+#define OMSK_MPS_WRITECHUNK		(1 << 16)
+
+// Longest line written (two names and a number)
+#define OMSK_MPS_MAXLINE		128
+
+// Terms and names per line in the LP and OPF formats
+#define OMSK_LP_TERMSPERLINE	8
+
+/* This function formats a number with the fewest digits that read back exactly (safe to call from worker threads). */
+static const char* format_number(char *buf, double value)
+{
+	sprintf(buf, "%.15g", value);
+	if (strtod(buf, NULL) != value) {
+		sprintf(buf, "%.16g", value);
+		if (strtod(buf, NULL) != value)
+			sprintf(buf, "%.17g", value);
+	}
+
+	return buf;
+}
+
+// A range of columns (MPS) or rows (LP and OPF) formatted by one job
+struct Modelfile_writer::chunk_type {
+	MSKintt		first;
+	MSKintt		last;
+	string		text;
+};
+
+/* This function returns the type of a constraint, with its right-hand side and range. */
+static char get_rowtype(double bl, double bu, double &rhs, double &range)
+{
+	range = 0.0;
+	if (bl == -INFINITY) {
+		rhs = bu;
+		return (bu == INFINITY) ? 'N' : 'L';
+	}
+	rhs = bl;
+	if (bu == INFINITY)
+		return 'G';
+	if (bl == bu)
+		return 'E';
+
+	// The range of a two-sided constraint is added to the lower bound on reading
+	range = bu - bl;
+	return 'G';
+}
+
+/* This function appends the 'count'th term of an expression in the LP and OPF formats, with 'j' < 0 for a constant (safe to call from worker threads). */
+static void append_term(string &text, MSKintt count, double value, MSKidxt j)
+{
+	char line[OMSK_MPS_MAXLINE], num[OMSK_MPS_MAXNUMBER];
+
+	if (count > 0 && count % OMSK_LP_TERMSPERLINE == 0)
+		text += "\n   ";
+
+	const char *sign = (value < 0) ? " - " : ((count > 0) ? " + " : " ");
+	if (j < 0)
+		sprintf(line, "%s%s", sign, format_number(num, fabs(value)));
+	else
+		sprintf(line, "%s%s C%d", sign, format_number(num, fabs(value)), j+1);
+
+	text += line;
+}
+
+/* This function formats the bound of a variable in the LP and OPF formats, and returns false for the default bounds (zero and infinity). */
+static bool format_varbound(char *line, MSKidxt j, double bl, double bu)
+{
+	char lower[OMSK_MPS_MAXNUMBER], upper[OMSK_MPS_MAXNUMBER];
+	bool freelower = (bl == -INFINITY);
+	bool freeupper = (bu == INFINITY);
+
+	if (freelower && freeupper)
+		sprintf(line, "C%d free", j+1);
+	else if (bl == bu)
+		sprintf(line, "C%d = %s", j+1, format_number(lower, bl));
+	else if (freelower)
+		sprintf(line, "-inf <= C%d <= %s", j+1, format_number(upper, bu));
+	else if (freeupper && bl == 0.0)
+		return false;
+	else if (freeupper)
+		sprintf(line, "C%d >= %s", j+1, format_number(lower, bl));
+	else
+		sprintf(line, "%s <= C%d <= %s", format_number(lower, bl), j+1, format_number(upper, bu));
+
+	return true;
+}
+
+/* This function returns the name of a format in messages. */
+static const char* format_name(Modelfile_writer::format_type format)
+{
+	switch (format) {
+		case Modelfile_writer::LP:	return "LP";
+		case Modelfile_writer::OPF:	return "OPF";
+		default:					return "MPS";
+	}
+}
+
+Modelfile_writer::Modelfile_writer(format_type format) :
+	format(format),
+	out(NULL),
+	numthreads(1),
+
+	numvar(0),
+	numcon(0),
+	sense(MSK_OBJECTIVE_SENSE_MINIMIZE),
+	c0(0.0),
+	c(NULL), blc(NULL), buc(NULL), blx(NULL), bux(NULL),
+	ptrb(NULL), sub(NULL), val(NULL)
+{
+	coneptr.assign(1, 0);
+}
+
+void Modelfile_writer::close()
+{
+	for (size_t i = 0; i < chunks.size(); ++i)
+		delete chunks[i];
+	chunks.clear();
+	cuts.clear();
+	buffer.clear();
+
+	// Release the transposed constraint matrix
+	vector<MSKintt>().swap(rowptr);
+	vector<MSKlidxt>().swap(rowsub);
+	vector<double>().swap(rowval);
+
+	if (out != NULL) {
+		fclose(out);
+		out = NULL;
+	}
+}
+
+void Modelfile_writer::fail() const
+{
+	throw msk_exception("Could not write to the " + string(format_name(format)) + " file '" + filepath + "'");
+}
+
+void Modelfile_writer::append(const string &str)
+{
+	buffer += str;
+	if (buffer.size() >= OMSK_MPS_MINCHUNK)
+		flush();
+}
+
+void Modelfile_writer::flush()
+{
+	if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size())
+		fail();
+
+	buffer.clear();
+}
+
+void Modelfile_writer::write(const string &path, int threads)
+{
+	close();
+	filepath = path;
+	numthreads = std::max(1, threads);
+
+	if (!isint.empty() && isint.size() != static_cast<size_t>(numvar))
+		throw msk_exception("Internal error in Modelfile_writer::write, the integer markers do not match the columns");
+
+	if (format == LP && !conetypes.empty())
+		throw msk_exception("The LP format can not hold cones, use the MPS or OPF format for conic problems");
+
+	out = fopen(filepath.c_str(), "wb");
+	if (out == NULL)
+		throw msk_exception("Could not open the " + string(format_name(format)) + " file '" + filepath + "' for writing");
+
+	switch (format) {
+		case LP:	write_lp();		break;
+		case OPF:	write_opf();	break;
+		default:	write_mps();	break;
+	}
+	flush();
+
+	FILE *file = out;
+	out = NULL;
+	if (fclose(file) != 0)
+		fail();
+}
+
+void Modelfile_writer::write_chunks(const MSKintt *ptr, MSKintt n)
+{
+	flush();
+
+	// Cut the items into chunks of about the same number of non-zeros
+	cuts.assign(1, 0);
+	for (MSKintt k = 0; k < n; ) {
+		MSKint64t count = 0;
+		do {
+			count += ptr[k+1] - ptr[k] + 1;
+			++k;
+		} while (k < n && count < OMSK_MPS_WRITECHUNK);
+		cuts.push_back(k);
+	}
+
+	// A few chunks are formatted at a time, and appended to the file in order
+	int window = 4 * numthreads;
+	for (int i = static_cast<int>(chunks.size()); i < window; ++i)
+		chunks.push_back(new chunk_type());
+
+	run_pipelined(prepare_job, format_job, finish_job, this, static_cast<int>(cuts.size()) - 1, numthreads, window);
+}
+
+void Modelfile_writer::prepare_job(int i, void *data)
+{
+	Modelfile_writer &writer = *static_cast<Modelfile_writer*>(data);
+	chunk_type &chunk = *writer.chunks[i % writer.chunks.size()];
+
+	chunk.first = writer.cuts[i];
+	chunk.last = writer.cuts[i+1];
+	chunk.text.clear();
+}
+
+void Modelfile_writer::format_job(int i, void *data)
+{
+	Modelfile_writer &writer = *static_cast<Modelfile_writer*>(data);
+	chunk_type &chunk = *writer.chunks[i % writer.chunks.size()];
+
+	if (writer.format == MPS)
+		writer.format_columns(chunk);
+	else
+		writer.format_constraints(chunk);
+}
+
+void Modelfile_writer::finish_job(int i, void *data)
+{
+	Modelfile_writer &writer = *static_cast<Modelfile_writer*>(data);
+	const string &text = writer.chunks[i % writer.chunks.size()]->text;
+
+	if (fwrite(text.data(), 1, text.size(), writer.out) != text.size())
+		writer.fail();
+}
+
+
+// ------------------------------
+// MPS format
+// ------------------------------
+
+void Modelfile_writer::write_mps()
+{
+	append("NAME\n");
+	append(sense == MSK_OBJECTIVE_SENSE_MAXIMIZE ? "OBJSENSE\n    MAX\n" : "OBJSENSE\n    MIN\n");
+
+	write_rows();
+	write_columns();
+	write_rhs();
+	write_bounds();
+	write_cones();
+
+	append("ENDATA\n");
+}
+
+void Modelfile_writer::write_rows()
+{
+	char line[OMSK_MPS_MAXLINE];
+	double rhs, range;
+
+	append("ROWS\n N  OBJ\n");
+	for (MSKintt i = 0; i < numcon; ++i) {
+		sprintf(line, " %c  R%d\n", get_rowtype(blc[i], buc[i], rhs, range), i+1);
+		append(line);
+	}
+}
+
+void Modelfile_writer::write_columns()
+{
+	append("COLUMNS\n");
+	write_chunks(ptrb, numvar);
+}
+
+void Modelfile_writer::format_columns(chunk_type &chunk) const
+{
+	char line[OMSK_MPS_MAXLINE], num[OMSK_MPS_MAXNUMBER];
+
+	chunk.text.reserve(static_cast<size_t>(ptrb[chunk.last] - ptrb[chunk.first] + chunk.last - chunk.first) * 40);
+
+	for (MSKintt j = chunk.first; j < chunk.last; ++j) {
+		bool intcol = !isint.empty() && isint[j];
+		if (intcol && (j == 0 || !isint[j-1]))
+			chunk.text += "    MARKER    'MARKER'    'INTORG'\n";
+
+		// Empty columns are given by their objective coefficient
+		MSKintt begin = ptrb[j];
+		MSKintt end = ptrb[j+1];
+		if (c[j] != 0.0 || begin == end) {
+			sprintf(line, "    C%-9d OBJ        %s\n", j+1, format_number(num, c[j]));
+			chunk.text += line;
+		}
+
+		for (MSKintt k = begin; k < end; ++k) {
+			sprintf(line, "    C%-9d R%-9d %s\n", j+1, static_cast<int>(sub[k])+1, format_number(num, val[k]));
+			chunk.text += line;
+		}
+
+		if (intcol && (j+1 == numvar || !isint[j+1]))
+			chunk.text += "    MARKER    'MARKER'    'INTEND'\n";
+	}
+}
+
+void Modelfile_writer::write_rhs()
+{
+	char line[OMSK_MPS_MAXLINE], num[OMSK_MPS_MAXNUMBER];
+	double rhs, range;
+
+	// The right-hand side of the objective is minus the constant
+	append("RHS\n");
+	if (c0 != 0.0) {
+		sprintf(line, "    RHS        OBJ        %s\n", format_number(num, -c0));
+		append(line);
+	}
+	for (MSKintt i = 0; i < numcon; ++i) {
+		if (get_rowtype(blc[i], buc[i], rhs, range) != 'N' && rhs != 0.0) {
+			sprintf(line, "    RHS        R%-9d %s\n", i+1, format_number(num, rhs));
+			append(line);
+		}
+	}
+
+	bool hasranges = false;
+	for (MSKintt i = 0; i < numcon; ++i) {
+		get_rowtype(blc[i], buc[i], rhs, range);
+		if (range != 0.0) {
+			if (!hasranges)
+				append("RANGES\n");
+			hasranges = true;
+
+			sprintf(line, "    RNG        R%-9d %s\n", i+1, format_number(num, range));
+			append(line);
+		}
+	}
+}
+
+void Modelfile_writer::write_bounds()
+{
+	char line[OMSK_MPS_MAXLINE], num[OMSK_MPS_MAXNUMBER];
+
+	append("BOUNDS\n");
+	for (MSKintt j = 0; j < numvar; ++j) {
+		bool freelower = (blx[j] == -INFINITY);
+		bool freeupper = (bux[j] == INFINITY);
+
+		if (freelower && freeupper) {
+			sprintf(line, " FR BND        C%d\n", j+1);
+			append(line);
+			continue;
+		}
+		if (blx[j] == bux[j]) {
+			sprintf(line, " FX BND        C%-9d %s\n", j+1, format_number(num, blx[j]));
+			append(line);
+			continue;
+		}
+
+		// A negative upper bound frees a default lower bound of zero on reading,
+		// so the upper bound goes first and the lower bound is then restored
+		if (!freeupper) {
+			sprintf(line, " UP BND        C%-9d %s\n", j+1, format_number(num, bux[j]));
+			append(line);
+		}
+		if (freelower) {
+			sprintf(line, " MI BND        C%d\n", j+1);
+			append(line);
+		} else if (blx[j] != 0.0 || (!freeupper && bux[j] < 0)) {
+			sprintf(line, " LO BND        C%-9d %s\n", j+1, format_number(num, blx[j]));
+			append(line);
+		}
+	}
+}
+
+void Modelfile_writer::write_cones()
+{
+	char line[OMSK_MPS_MAXLINE];
+
+	for (size_t i = 0; i < conetypes.size(); ++i) {
+		sprintf(line, "CSECTION      K%-9d 0.0        ", static_cast<int>(i+1));
+		append(line + conetypes[i] + "\n");
+
+		for (MSKidxt k = coneptr[i]; k < coneptr[i+1]; ++k) {
+			sprintf(line, "    C%d\n", conesub[k]+1);
+			append(line);
+		}
+	}
+}
+
+
+// ------------------------------
+// LP and OPF formats
+// ------------------------------
+
+void Modelfile_writer::write_lp()
+{
+	transpose();
+
+	// All variables are listed in the objective, such that they are
+	// numbered in order when read back (and none of them is dropped)
+	append(sense == MSK_OBJECTIVE_SENSE_MAXIMIZE ? "maximize\n" : "minimize\n");
+	append(" OBJ:");
+	write_objective();
+
+	append("subject to\n");
+	write_chunks(&rowptr[0], numcon);
+
+	append("bounds\n");
+	write_varbounds();
+
+	write_integers();
+	append("end\n");
+}
+
+void Modelfile_writer::write_opf()
+{
+	char line[OMSK_MPS_MAXLINE];
+	transpose();
+
+	// The variables are declared first, such that they are numbered in order
+	append("[variables]\n");
+	for (MSKintt j = 0; j < numvar; ++j) {
+		sprintf(line, (j % OMSK_LP_TERMSPERLINE == OMSK_LP_TERMSPERLINE-1 || j+1 == numvar) ? " C%d\n" : " C%d", j+1);
+		append(line);
+	}
+	append("[/variables]\n");
+
+	append(sense == MSK_OBJECTIVE_SENSE_MAXIMIZE ? "[objective maximize 'OBJ']\n" : "[objective minimize 'OBJ']\n");
+	write_objective();
+	append("[/objective]\n");
+
+	append("[constraints]\n");
+	write_chunks(&rowptr[0], numcon);
+	append("[/constraints]\n");
+
+	append("[bounds]\n");
+	write_varbounds();
+	append("[/bounds]\n");
+
+	write_integers();
+}
+
+void Modelfile_writer::transpose()
+{
+	MSKintt numnz = ptrb[numvar];
+
+	// Count the non-zeros of each row, and turn the counts into row pointers
+	rowptr.assign(numcon + 1, 0);
+	for (MSKintt k = 0; k < numnz; ++k)
+		++rowptr[sub[k] + 1];
+	for (MSKintt i = 0; i < numcon; ++i)
+		rowptr[i+1] += rowptr[i];
+
+	// Scanning the columns in order keeps the columns sorted within each row
+	rowsub.resize(numnz);
+	rowval.resize(numnz);
+	vector<MSKintt> next(rowptr.begin(), rowptr.end() - 1);
+	for (MSKintt j = 0; j < numvar; ++j) {
+		for (MSKintt k = ptrb[j]; k < ptrb[j+1]; ++k) {
+			MSKintt p = next[sub[k]]++;
+			rowsub[p] = j;
+			rowval[p] = val[k];
+		}
+	}
+}
+
+void Modelfile_writer::write_objective()
+{
+	string expr;
+	MSKintt count = 0;
+
+	// The LP format keeps the zeros (see write_lp)
+	for (MSKintt j = 0; j < numvar; ++j) {
+		if (c[j] != 0.0 || format == LP) {
+			expr.clear();
+			append_term(expr, count++, c[j], j);
+			append(expr);
+		}
+	}
+	if (c0 != 0.0) {
+		expr.clear();
+		append_term(expr, count++, c0, -1);
+		append(expr);
+	}
+	append("\n");
+}
+
+void Modelfile_writer::format_constraints(chunk_type &chunk) const
+{
+	char line[OMSK_MPS_MAXLINE], lower[OMSK_MPS_MAXNUMBER], upper[OMSK_MPS_MAXNUMBER];
+
+	chunk.text.reserve(static_cast<size_t>(rowptr[chunk.last] - rowptr[chunk.first] + chunk.last - chunk.first) * 30);
+
+	for (MSKintt i = chunk.first; i < chunk.last; ++i) {
+		bool freelower = (blc[i] == -INFINITY);
+		bool freeupper = (buc[i] == INFINITY);
+
+		if (format == LP)
+			sprintf(line, " R%d:", i+1);
+		else
+			sprintf(line, " [con 'R%d']", i+1);
+		chunk.text += line;
+
+		// Ranged constraints start with their lower bound
+		if (!freelower && !freeupper && blc[i] != buc[i]) {
+			chunk.text += " ";
+			chunk.text += format_number(lower, blc[i]);
+			chunk.text += " <=";
+		}
+
+		// Empty rows are given by a zero term, as an expression can not be empty
+		MSKintt begin = rowptr[i];
+		MSKintt end = rowptr[i+1];
+		if (begin == end && numvar > 0)
+			append_term(chunk.text, 0, 0.0, 0);
+		for (MSKintt k = begin; k < end; ++k)
+			append_term(chunk.text, k - begin, rowval[k], static_cast<MSKidxt>(rowsub[k]));
+
+		// Free constraints are bounded by minus infinity (as read by MOSEK)
+		if (freelower && freeupper)
+			sprintf(line, " >= -1e+30");
+		else if (freelower)
+			sprintf(line, " <= %s", format_number(upper, buc[i]));
+		else if (freeupper)
+			sprintf(line, " >= %s", format_number(lower, blc[i]));
+		else if (blc[i] == buc[i])
+			sprintf(line, " = %s", format_number(lower, blc[i]));
+		else
+			sprintf(line, " <= %s", format_number(upper, buc[i]));
+		chunk.text += line;
+
+		chunk.text += (format == LP) ? "\n" : " [/con]\n";
+	}
+}
+
+void Modelfile_writer::write_varbounds()
+{
+	char line[OMSK_MPS_MAXLINE], bound[OMSK_MPS_MAXLINE];
+
+	for (MSKintt j = 0; j < numvar; ++j) {
+		if (format_varbound(bound, j, blx[j], bux[j])) {
+			if (format == LP)
+				sprintf(line, " %s\n", bound);
+			else
+				sprintf(line, " [b] %s [/b]\n", bound);
+			append(line);
+		}
+	}
+
+	// Cones belong to the bounds in the OPF format
+	if (format == OPF) {
+		for (size_t i = 0; i < conetypes.size(); ++i) {
+			string type = conetypes[i];
+			for (size_t k = 0; k < type.length(); ++k)
+				type[k] = static_cast<char>(tolower(type[k]));
+
+			sprintf(line, " [cone %s 'K%d']", type.c_str(), static_cast<int>(i+1));
+			append(line);
+			for (MSKidxt k = coneptr[i]; k < coneptr[i+1]; ++k) {
+				MSKidxt count = k - coneptr[i];
+				if (count > 0 && count % OMSK_LP_TERMSPERLINE == 0)
+					append(",\n   ");
+				else if (count > 0)
+					append(",");
+				sprintf(line, " C%d", conesub[k]+1);
+				append(line);
+			}
+			append(" [/cone]\n");
+		}
+	}
+}
+
+void Modelfile_writer::write_integers()
+{
+	char line[OMSK_MPS_MAXLINE];
+	MSKintt count = 0;
+
+	for (MSKintt j = 0; j < numvar; ++j) {
+		if (isint.empty() || !isint[j])
+			continue;
+
+		if (count == 0)
+			append((format == LP) ? "general\n" : "[integer]\n");
+		sprintf(line, (count % OMSK_LP_TERMSPERLINE == OMSK_LP_TERMSPERLINE-1) ? " C%d\n" : " C%d", j+1);
+		append(line);
+		++count;
+	}
+	if (count > 0 && count % OMSK_LP_TERMSPERLINE != 0)
+		append("\n");
+	if (count > 0 && format == OPF)
+		append("[/integer]\n");
+}
@@ -0,0 +1,246 @@
+#ifndef OMSK_UTILS_MPSFILE_H_
+#define OMSK_UTILS_MPSFILE_H_
+
+#include "omsk_msg_mosek.h"
+#include "omsk_utils_snapshot.h"
+
+#include <string>
+#include <vector>
+#include <cstdio>
+
+// ------------------------------
+// Native MPS reader
+// ------------------------------
+//
+// Reads the free MPS format without creating a MOSEK task. The file is mapped
+// into memory, and the COLUMNS section (holding almost all of the data) is cut
+// into chunks at line boundaries and tokenized on worker threads in two passes:
+// the first counts the non-zeros of each column, and the second writes them
+// straight into the compressed sparse column arrays of the caller.
+//
+// Supported sections are NAME, OBJSENSE, OBJNAME, ROWS, COLUMNS (with integer
+// markers), RHS, RANGES, BOUNDS and CSECTION (QUAD and RQUAD cones). Quadratic
+// sections are rejected. Names can not contain spaces, and the first N row is
+// the objective unless OBJNAME says otherwise (other N rows become free
+// constraints). All indexes count from 0.
+//
+
+// Returns true if 'filepath' names an MPS file (by its extension)
+bool is_mpsfile(const std::string &filepath);
+
+// Returns true if 'filepath' names an LP or an OPF file (by its extension)
+bool is_lpfile(const std::string &filepath);
+bool is_opffile(const std::string &filepath);
+
+
+// ------------------------------
+// Class Name_table
+// ------------------------------
+//
+// Open addressing hash table from names to indexes. The keys are not copied,
+// but point into the mapped file. Lookups are safe from several threads once
+// all names have been inserted.
+//
+class Name_table {
+private:
+	struct entry {
+		const char	*name;
+		size_t		len;
+		MSKintt		index;
+	};
+	std::vector<entry> table;
+	size_t numused;
+
+	void grow();
+
+public:
+	Name_table() : numused(0) {}
+
+	// Returns the index of an existing name, or inserts it with 'index'
+	MSKintt insert(const char *name, size_t len, MSKintt index);
+
+	// Returns the index of a name, or -1 if not found
+	MSKintt find(const char *name, size_t len) const;
+};
+
+
+// ------------------------------
+// Class Mpsfile_reader
+// ------------------------------
+class Mpsfile_reader {
+private:
+	struct chunk_type;
+
+	std::string	filepath;
+	Mapped_file	file;
+	int			numthreads;
+
+	// Rows and columns
+	Name_table	rows;
+	Name_table	cols;
+	std::vector<char> rowtype;
+	std::vector<char> isint;
+	std::string	objname;
+
+	// The COLUMNS section cut into chunks, the column pointers, and the
+	// matrix being filled
+	std::vector<chunk_type*> chunks;
+	std::vector<MSKintt> colptr;
+	MSKlidxt	*sub;
+	double		*val;
+
+	void parse_columns(const char *begin, const char *end);
+	void merge_chunks();
+
+	// Jobs run on worker threads (see run_parallel)
+	static void count_job(int i, void *data);
+	static void fill_job(int i, void *data);
+	static void sort_job(int i, void *data);
+
+	// Overwrite copy constructor and provide no implementation
+	Mpsfile_reader(const Mpsfile_reader& that);
+
+public:
+	// Problem data (except the constraint matrix)
+	MSKintt			numvar;
+	MSKintt			numcon;
+	MSKintt			numnz;
+	MSKobjsensee	sense;
+	double			c0;
+	std::vector<double> c;
+	std::vector<double> blc;
+	std::vector<double> buc;
+	std::vector<double> blx;
+	std::vector<double> bux;
+	std::vector<MSKidxt> intsub;
+	std::vector<std::string> conetypes;
+	std::vector<MSKidxt> coneptr;
+	std::vector<MSKidxt> conesub;
+
+	Mpsfile_reader();
+	~Mpsfile_reader() { close(); }
+
+	// Maps and parses the file, counting the non-zeros of the constraint matrix
+	void open(const std::string &filepath, int numthreads);
+	void close();
+
+	// Fills the preallocated constraint matrix (numvar+1 column pointers, and
+	// numnz row indexes and values) with rows sorted within each column
+	void fill_matrix(MSKintt *ptrb, MSKlidxt *sub, double *val);
+
+	// Counts the non-zeros of each row (numcon elements), and finds the range
+	// of the absolute non-zero values, without keeping the constraint matrix
+	void scan_matrix(MSKintt *rownz, double &amin, double &amax);
+
+	// The non-zeros of each column (numvar elements), known once the file is open
+	void get_colnz(MSKintt *colnz) const;
+};
+
+
+// ------------------------------
+// Class Modelfile_writer
+// ------------------------------
+//
+// Writes the free MPS, LP or OPF format straight from the arrays of a problem
+// description, without creating a MOSEK task. The bulk of the file (the columns
+// of the constraint matrix in MPS files, and its rows in LP and OPF files) is
+// formatted in chunks on worker threads, a few chunks at a time, and appended
+// in order to the file, such that the output is never held in memory as a
+// whole. The other sections are formatted on the calling thread. The LP and OPF
+// formats list the constraints row by row, so the constraint matrix is first
+// transposed into a copy in compressed sparse row format.
+//
+// Rows are named R1..Rm, columns C1..Cn, cones K1..Kp and the objective OBJ,
+// and the file is read back by MOSEK (and MPS files by the native reader) as
+// the same problem. The LP format can not hold cones. The writer prints
+// nothing. All indexes count from 0.
+//
+class Modelfile_writer {
+public:
+	enum format_type { MPS, LP, OPF };
+
+private:
+	struct chunk_type;
+
+	format_type	format;
+	std::string	filepath;
+	FILE		*out;
+	int			numthreads;
+
+	// Sections are formatted into 'buffer', and appended to the file when full
+	std::string	buffer;
+
+	// Chunks of the constraint matrix in flight (see run_pipelined)
+	std::vector<MSKintt> cuts;
+	std::vector<chunk_type*> chunks;
+
+	// Constraint matrix in compressed sparse row format (LP and OPF only)
+	std::vector<MSKintt> rowptr;
+	std::vector<MSKlidxt> rowsub;
+	std::vector<double> rowval;
+
+	void write_mps();
+	void write_rows();
+	void write_columns();
+	void write_rhs();
+	void write_bounds();
+	void write_cones();
+
+	void write_lp();
+	void write_opf();
+	void transpose();
+	void write_objective();
+	void write_constraints();
+	void write_varbounds();
+	void write_integers();
+
+	// Formats the items [0, n) in chunks on worker threads, where item k holds
+	// the non-zeros 'ptr[k]' to 'ptr[k+1]' (columns in MPS files, rows otherwise)
+	void write_chunks(const MSKintt *ptr, MSKintt n);
+	void format_columns(chunk_type &chunk) const;
+	void format_constraints(chunk_type &chunk) const;
+
+	void append(const std::string &str);
+	void flush();
+	void fail() const;
+
+	// Jobs of run_pipelined (only 'format_job' runs on worker threads)
+	static void prepare_job(int i, void *data);
+	static void format_job(int i, void *data);
+	static void finish_job(int i, void *data);
+
+	// Overwrite copy constructor and provide no implementation
+	Modelfile_writer(const Modelfile_writer& that);
+
+public:
+	// Problem data (referenced, not copied)
+	MSKintt			numvar;
+	MSKintt			numcon;
+	MSKobjsensee	sense;
+	double			c0;
+	const double	*c;
+	const double	*blc;
+	const double	*buc;
+	const double	*blx;
+	const double	*bux;
+
+	// Constraint matrix in compressed sparse column format (numvar+1 column
+	// pointers, and row indexes and values)
+	const MSKintt	*ptrb;
+	const MSKlidxt	*sub;
+	const double	*val;
+
+	std::vector<char> isint;
+	std::vector<std::string> conetypes;
+	std::vector<MSKidxt> coneptr;
+	std::vector<MSKidxt> conesub;
+
+	explicit Modelfile_writer(format_type format);
+	~Modelfile_writer() { close(); }
+
+	// Writes the file, formatting the constraint matrix on 'numthreads' threads
+	void write(const std::string &filepath, int numthreads);
+	void close();
+};
+
+#endif /* OMSK_UTILS_MPSFILE_H_ */
@@ -274,3 +274,55 @@ void map_seek_Boolean(bool *out, Octave_map& map, string name, bool optional)
 
 	*out = temp;
 }
+
+// ------------------------------
+// Seek object: String list (a String or a Cell of Strings)
+// ------------------------------
+void map_seek_StringList(vector<string> *out, Octave_map& map, string name, bool optional)
+{
+	octave_value val = empty_octave_value;
+	map_seek_Value(&val, map, name, optional);
+
+	if (isEmpty(val)) {
+		if (optional)
+			return;
+		else
+			throw msk_exception("Variable \"" + name + "\" needs a non-empty definition");
+	}
+
+	vector<string> temp;
+	if (val.is_string()) {
+		temp.push_back(val.string_value());
+
+	} else if (val.is_cell()) {
+		Cell cell = val.cell_value();
+		for (int i=0; i<cell.nelem(); i++) {
+			string str = cell(i).string_value();
+			if (error_state)
+				throw msk_exception("Variable \"" + name + "\" should be a Cell of Strings");
+
+			temp.push_back(str);
+		}
+
+	} else {
+		throw msk_exception("Variable \"" + name + "\" should be a String or a Cell of Strings");
+	}
+
+	*out = temp;
+}
+void validate_StringList(vector<string>& object, string name, vector<string> keywords, bool optional)
+{
+	if (optional && object.empty())
+		return;
+
+	for (size_t i = 0; i < object.size(); i++) {
+		bool recognized = false;
+
+		for (size_t j = 0; j < keywords.size() && !recognized; j++)
+			if (object[i] == keywords[j])
+				recognized = true;
+
+		if (!recognized)
+			throw msk_exception("Value \"" + object[i] + "\" in \"" + name + "\" not recognized");
+	}
+}
@@ -31,6 +31,7 @@ void map_seek_IntegerArray(int32NDArray *out, Octave_map& map, std::string name,
 void map_seek_Scalar(double *out, Octave_map& map, std::string name, bool optional=false);
 void map_seek_String(std::string *out, Octave_map& map, std::string name, bool optional=false);
 void map_seek_Boolean(bool *out, Octave_map& map, std::string name, bool optional=false);
+void map_seek_StringList(std::vector<std::string> *out, Octave_map& map, std::string name, bool optional=false);
 
 // Validate other types fetched from list
 void validate_OctaveMap(Octave_map& object, std::string name, std::vector<std::string> keywords, bool optional=false);
@@ -38,6 +39,7 @@ void validate_Cell(Cell &object, std::string name, int nelem, bool optional=fals
 void validate_SparseMatrix(SparseMatrix& object, std::string name, int nrows, int ncols, bool optional=false);
 void validate_RowVector(RowVector& object, std::string name, int nrows, bool optional=false);
 void validate_IntegerArray(int32NDArray& object, std::string name, int nrows, bool optional=false);
+void validate_StringList(std::vector<std::string>& object, std::string name, std::vector<std::string> keywords, bool optional=false);
 
 
 #endif /* OMSK_UTILS_OCTAVE_H_ */
@@ -0,0 +1,366 @@
+#include "omsk_utils_snapshot.h"
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using std::string;
+using std::vector;
+using std::list;
+using std::map;
+
+
+bool is_snapshotfile(const string &filepath)
+{
+	const string ext = OMSK_SNAPSHOT_EXTENSION;
+	if (filepath.length() <= ext.length())
+		return false;
+
+	for (size_t i = 0; i < ext.length(); ++i)
+		if (tolower(filepath[filepath.length() - ext.length() + i]) != ext[i])
+			return false;
+
+	return true;
+}
+
+/* This function rounds a byte count up to the alignment of the sections. */
+static uint64_t binfile_align(uint64_t bytes)
+{
+	return (bytes + 7) & ~static_cast<uint64_t>(7);
+}
+
+static uint64_t binfile_bytes(uint32_t type, uint64_t count)
+{
+	switch (type) {
+		case OMSK_SOLFILE_FLOAT64:	return count * sizeof(double);
+		case OMSK_SOLFILE_UINT8:	return count * sizeof(uint8_t);
+		case OMSK_SOLFILE_INT32:	return count * sizeof(int32_t);
+		case OMSK_SOLFILE_TEXT:		return count;
+		default:
+			throw msk_exception("Internal error in binfile_bytes, unknown element type");
+	}
+}
+
+
+// ------------------------------
+// Class Binfile_writer
+// ------------------------------
+
+Binfile_writer::item& Binfile_writer::append(const string &name, uint32_t type, uint64_t count)
+{
+	if (name.length() >= OMSK_SOLFILE_NAME_SIZE)
+		throw msk_exception("Internal error in Binfile_writer::append, the item name '" + name + "' is too long");
+
+	items.push_back(item());
+	item &it = items.back();
+	it.name = name;
+	it.type = type;
+	it.count = count;
+	it.data = NULL;
+	it.bytes = binfile_bytes(type, count);
+	return it;
+}
+
+void Binfile_writer::add_float64(const string &name, const double *data, uint64_t count)
+{
+	append(name, OMSK_SOLFILE_FLOAT64, count).data = reinterpret_cast<const char*>(data);
+}
+
+void Binfile_writer::add_int32(const string &name, const vector<int32_t> &data)
+{
+	item &it = append(name, OMSK_SOLFILE_INT32, data.size());
+	it.owned.assign(reinterpret_cast<const char*>(&data[0]), reinterpret_cast<const char*>(&data[0]) + it.bytes);
+	it.data = it.owned.empty() ? NULL : &it.owned[0];
+}
+
+void Binfile_writer::add_uint8(const string &name, const uint8_t *data, uint64_t count)
+{
+	item &it = append(name, OMSK_SOLFILE_UINT8, count);
+	it.owned.assign(reinterpret_cast<const char*>(data), reinterpret_cast<const char*>(data) + it.bytes);
+	it.data = it.owned.empty() ? NULL : &it.owned[0];
+}
+
+void Binfile_writer::add_text(const string &name, const vector<string> &strings)
+{
+	vector<char> buffer;
+	for (size_t i = 0; i < strings.size(); ++i) {
+		buffer.insert(buffer.end(), strings[i].begin(), strings[i].end());
+		buffer.push_back('\0');
+	}
+
+	item &it = append(name, OMSK_SOLFILE_TEXT, buffer.size());
+	it.owned.swap(buffer);
+	it.data = it.owned.empty() ? NULL : &it.owned[0];
+}
+
+/* This function writes a block of bytes, or throws on failure. */
+static void binfile_write(FILE *stream, const void *data, size_t bytes, const string &filepath)
+{
+	if (bytes > 0 && fwrite(data, 1, bytes, stream) != bytes)
+		throw msk_exception("The file '" + filepath + "' could not be written");
+}
+
+void Binfile_writer::write(const string &filepath, const char *magic, uint32_t version, const vector<uint64_t> &dims)
+{
+	if (16 + 8 * dims.size() > OMSK_SOLFILE_HEADER_SIZE)
+		throw msk_exception("Internal error in Binfile_writer::write, too many header fields");
+
+	FILE *stream = fopen(filepath.c_str(), "wb");
+	if (stream == NULL)
+		throw msk_exception("The file '" + filepath + "' could not be opened for writing");
+
+	try {
+		char header[OMSK_SOLFILE_HEADER_SIZE];
+		memset(header, 0, sizeof(header));
+		memcpy(header, magic, 8);
+
+		uint32_t numitems = static_cast<uint32_t>(items.size());
+		memcpy(header + 8, &version, sizeof(version));
+		memcpy(header + 12, &numitems, sizeof(numitems));
+		for (size_t i = 0; i < dims.size(); ++i)
+			memcpy(header + 16 + 8 * i, &dims[i], sizeof(uint64_t));
+		binfile_write(stream, header, sizeof(header), filepath);
+
+		uint64_t offset = OMSK_SOLFILE_HEADER_SIZE + OMSK_SOLFILE_ITEM_SIZE * items.size();
+		for (list<item>::const_iterator it = items.begin(); it != items.end(); ++it) {
+			char entry[OMSK_SOLFILE_ITEM_SIZE];
+			memset(entry, 0, sizeof(entry));
+			strncpy(entry, it->name.c_str(), OMSK_SOLFILE_NAME_SIZE - 1);
+			memcpy(entry + 16, &it->type, sizeof(it->type));
+			memcpy(entry + 24, &it->count, sizeof(it->count));
+			memcpy(entry + 32, &offset, sizeof(offset));
+			binfile_write(stream, entry, sizeof(entry), filepath);
+
+			offset += binfile_align(it->bytes);
+		}
+
+		static const char zeros[8] = {0};
+		for (list<item>::const_iterator it = items.begin(); it != items.end(); ++it) {
+			binfile_write(stream, it->data, static_cast<size_t>(it->bytes), filepath);
+			binfile_write(stream, zeros, static_cast<size_t>(binfile_align(it->bytes) - it->bytes), filepath);
+		}
+
+		if (fclose(stream) != 0) {
+			stream = NULL;
+			throw msk_exception("The file '" + filepath + "' could not be written");
+		}
+
+	} catch (msk_exception const& e) {
+		if (stream != NULL)
+			fclose(stream);
+		remove(filepath.c_str());
+		throw;
+	}
+}
+
+
+// ------------------------------
+// Class Mapped_file
+// ------------------------------
+
+void Mapped_file::open(const string &filepath)
+{
+	close();
+
+#ifdef _WIN32
+	FILE *stream = fopen(filepath.c_str(), "rb");
+	if (stream == NULL)
+		throw msk_exception("The file '" + filepath + "' could not be opened for reading");
+
+	fseek(stream, 0, SEEK_END);
+	size = static_cast<uint64_t>(ftell(stream));
+	fseek(stream, 0, SEEK_SET);
+
+	base = new char[size > 0 ? size : 1];
+	bool success = (fread(base, 1, static_cast<size_t>(size), stream) == size);
+	fclose(stream);
+
+	if (!success) {
+		close();
+		throw msk_exception("The file '" + filepath + "' could not be read");
+	}
+#else
+	int fd = ::open(filepath.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw msk_exception("The file '" + filepath + "' could not be opened for reading");
+
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		::close(fd);
+		throw msk_exception("The file '" + filepath + "' could not be read");
+	}
+	size = static_cast<uint64_t>(info.st_size);
+
+	if (size > 0) {
+		void *addr = mmap(NULL, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr == MAP_FAILED) {
+			::close(fd);
+			size = 0;
+			throw msk_exception("The file '" + filepath + "' could not be mapped into memory");
+		}
+		base = static_cast<char*>(addr);
+	}
+	::close(fd);
+#endif
+}
+
+void Mapped_file::close()
+{
+	if (base != NULL) {
+#ifdef _WIN32
+		delete[] base;
+#else
+		munmap(base, static_cast<size_t>(size));
+#endif
+	}
+	base = NULL;
+	size = 0;
+}
+
+
+// ------------------------------
+// Class Binfile_reader
+// ------------------------------
+
+void Binfile_reader::open(const string &path, const char *magic, uint32_t version)
+{
+	close();
+	filepath = path;
+
+	file.open(filepath);
+	base = file.data();
+	size = file.length();
+
+	// Check the header
+	uint32_t fileversion, numitems;
+	if (size < OMSK_SOLFILE_HEADER_SIZE || memcmp(base, magic, 8) != 0) {
+		close();
+		throw msk_exception("The file '" + path + "' is not of the expected binary format");
+	}
+	memcpy(&fileversion, base + 8, sizeof(fileversion));
+	memcpy(&numitems, base + 12, sizeof(numitems));
+
+	if (fileversion != version) {
+		close();
+		throw msk_exception("The file '" + path + "' has version " + tostring(fileversion) + ", but version " + tostring(version) + " was expected");
+	}
+
+	// Check the item table
+	if (size < OMSK_SOLFILE_HEADER_SIZE + static_cast<uint64_t>(numitems) * OMSK_SOLFILE_ITEM_SIZE) {
+		close();
+		throw msk_exception("The file '" + path + "' is truncated");
+	}
+
+	for (uint32_t i = 0; i < numitems; ++i) {
+		const char *entry = base + OMSK_SOLFILE_HEADER_SIZE + i * OMSK_SOLFILE_ITEM_SIZE;
+
+		const char *nameend = static_cast<const char*>(memchr(entry, '\0', OMSK_SOLFILE_NAME_SIZE));
+
+		solfile_item item;
+		item.name = string(entry, nameend ? nameend - entry : OMSK_SOLFILE_NAME_SIZE);
+		memcpy(&item.type, entry + 16, sizeof(item.type));
+		memcpy(&item.count, entry + 24, sizeof(item.count));
+		memcpy(&item.offset, entry + 32, sizeof(item.offset));
+
+		uint64_t bytes;
+		try {
+			bytes = binfile_bytes(item.type, item.count);
+		} catch (msk_exception const&) {
+			close();
+			throw msk_exception("The item '" + item.name + "' in file '" + path + "' has an unknown element type");
+		}
+
+		if (item.offset % 8 != 0 || item.offset > size || bytes > size - item.offset) {
+			close();
+			throw msk_exception("The item '" + item.name + "' in file '" + path + "' lies outside the file");
+		}
+
+		items[item.name] = item;
+	}
+}
+
+void Binfile_reader::close()
+{
+	file.close();
+	base = NULL;
+	size = 0;
+	items.clear();
+}
+
+uint64_t Binfile_reader::dim(int i) const
+{
+	uint64_t value;
+	memcpy(&value, base + 16 + 8 * i, sizeof(value));
+	return value;
+}
+
+bool Binfile_reader::has(const string &name) const
+{
+	return items.find(name) != items.end();
+}
+
+const solfile_item& Binfile_reader::find(const string &name, uint32_t type) const
+{
+	map<string, solfile_item>::const_iterator it = items.find(name);
+	if (it == items.end())
+		throw msk_exception("The item '" + name + "' is missing in file '" + filepath + "'");
+
+	if (it->second.type != type)
+		throw msk_exception("The item '" + name + "' in file '" + filepath + "' has an unexpected element type");
+
+	return it->second;
+}
+
+/* This function checks the number of elements of an item, unless 'count' is negative. */
+static void binfile_checkcount(const solfile_item &item, int64_t count, const string &filepath)
+{
+	if (count >= 0 && item.count != static_cast<uint64_t>(count))
+		throw msk_exception("The item '" + item.name + "' in file '" + filepath + "' has " + tostring(item.count) + " elements, but " + tostring(count) + " were expected");
+}
+
+const double* Binfile_reader::float64(const string &name, int64_t count) const
+{
+	const solfile_item &item = find(name, OMSK_SOLFILE_FLOAT64);
+	binfile_checkcount(item, count, filepath);
+	return reinterpret_cast<const double*>(base + item.offset);
+}
+
+const int32_t* Binfile_reader::int32(const string &name, int64_t count) const
+{
+	const solfile_item &item = find(name, OMSK_SOLFILE_INT32);
+	binfile_checkcount(item, count, filepath);
+	return reinterpret_cast<const int32_t*>(base + item.offset);
+}
+
+const uint8_t* Binfile_reader::uint8(const string &name, int64_t count) const
+{
+	const solfile_item &item = find(name, OMSK_SOLFILE_UINT8);
+	binfile_checkcount(item, count, filepath);
+	return reinterpret_cast<const uint8_t*>(base + item.offset);
+}
+
+void Binfile_reader::text(const string &name, vector<string> &strings) const
+{
+	const solfile_item &item = find(name, OMSK_SOLFILE_TEXT);
+	const char *data = base + item.offset;
+
+	if (item.count > 0 && data[item.count - 1] != '\0')
+		throw msk_exception("The item '" + name + "' in file '" + filepath + "' is not NUL-terminated");
+
+	strings.clear();
+	for (uint64_t i = 0; i < item.count; ) {
+		strings.push_back(string(data + i));
+		i += strings.back().length() + 1;
+	}
+}
@@ -0,0 +1,143 @@
+#ifndef OMSK_UTILS_SNAPSHOT_H_
+#define OMSK_UTILS_SNAPSHOT_H_
+
+#include "omsk_msg_base.h"
+#include "omsk_utils_solfile.h"
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <stdint.h>
+
+// ------------------------------
+// Binary problem snapshots
+// ------------------------------
+//
+// A snapshot holds a problem description exactly as given in Octave, and is
+// read and written without creating a MOSEK task. It shares the layout of the
+// binary solution files (see omsk_utils_solfile.h) with its own header:
+//
+//   Header (64 bytes):
+//     0  char[8]   magic "OMSKPRB1"
+//     8  uint32    version (1)
+//    12  uint32    number of items
+//    16  uint64    number of variables
+//    24  uint64    number of constraints
+//    32  uint64    number of non-zeros in A
+//    40  uint64    number of cones
+//    48  reserved  (zero)
+//
+// followed by the item table and the 8-byte aligned data sections. Items of
+// type OMSK_SOLFILE_TEXT count bytes and hold NUL-terminated strings.
+//
+#define OMSK_SNAPSHOT_MAGIC			"OMSKPRB1"
+#define OMSK_SNAPSHOT_VERSION		1
+#define OMSK_SNAPSHOT_EXTENSION		".omsk"
+
+// Returns true if 'filepath' names a snapshot (by its extension)
+bool is_snapshotfile(const std::string &filepath);
+
+
+// ------------------------------
+// Class Binfile_writer
+// ------------------------------
+//
+// Collects the items of a binary file and writes them with the item table in
+// one pass. Items of type OMSK_SOLFILE_FLOAT64 refer to the memory of the
+// caller (which must outlive the call to 'write'), while all others are copied.
+//
+class Binfile_writer {
+private:
+	struct item {
+		std::string name;
+		uint32_t	type;
+		uint64_t	count;
+		const char	*data;
+		uint64_t	bytes;
+		std::vector<char> owned;
+	};
+	std::list<item> items;
+
+	item& append(const std::string &name, uint32_t type, uint64_t count);
+
+public:
+	void add_float64(const std::string &name, const double *data, uint64_t count);
+	void add_int32(const std::string &name, const std::vector<int32_t> &data);
+	void add_uint8(const std::string &name, const uint8_t *data, uint64_t count);
+	void add_text(const std::string &name, const std::vector<std::string> &strings);
+
+	// Writes the file with the given magic, and 'dims' in the header from offset 16
+	void write(const std::string &filepath, const char *magic, uint32_t version, const std::vector<uint64_t> &dims);
+};
+
+
+// ------------------------------
+// Class Mapped_file
+// ------------------------------
+//
+// A read-only view of a whole file, memory-mapped (read into memory on Windows).
+//
+class Mapped_file {
+private:
+	char		*base;
+	uint64_t	size;
+
+	// Overwrite copy constructor and provide no implementation
+	Mapped_file(const Mapped_file& that);
+
+public:
+	Mapped_file() : base(NULL), size(0) {}
+	~Mapped_file() { close(); }
+
+	void open(const std::string &filepath);
+	void close();
+
+	const char*	data() const	{ return base; }
+	uint64_t	length() const	{ return size; }
+};
+
+
+// ------------------------------
+// Class Binfile_reader
+// ------------------------------
+//
+// Maps a binary file into memory and checks the header and item table, such
+// that the data sections can be accessed in place.
+//
+class Binfile_reader {
+private:
+	std::string filepath;
+	Mapped_file	file;
+	const char	*base;
+	uint64_t	size;
+	std::map<std::string, solfile_item> items;
+
+	// Overwrite copy constructor and provide no implementation
+	Binfile_reader(const Binfile_reader& that);
+
+public:
+	Binfile_reader() : base(NULL), size(0) {}
+	~Binfile_reader() { close(); }
+
+	// Opens a file, requiring the given magic and version
+	void open(const std::string &filepath, const char *magic, uint32_t version);
+	void close();
+
+	// The header field at offset 16 + 8*i
+	uint64_t dim(int i) const;
+
+	// The item table, sorted by name
+	const std::map<std::string, solfile_item>& itemlist() const { return items; }
+
+	bool has(const std::string &name) const;
+	const solfile_item& find(const std::string &name, uint32_t type) const;
+
+	// Access to the data sections in place (checking type and, unless negative, count)
+	const double*	float64(const std::string &name, int64_t count) const;
+	const int32_t*	int32(const std::string &name, int64_t count) const;
+	const uint8_t*	uint8(const std::string &name, int64_t count) const;
+	void			text(const std::string &name, std::vector<std::string> &strings) const;
+};
+
+#endif /* OMSK_UTILS_SNAPSHOT_H_ */
@@ -0,0 +1,484 @@
+#include "omsk_utils_solfile.h"
+
+#include "omsk_utils_mosek.h"
+#include "omsk_utils_octave.h"
+#include "omsk_utils_snapshot.h"
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <cstdio>
+#include <cstring>
+
+using std::string;
+using std::vector;
+
+
+// ------------------------------
+// Writing binary solution files
+// ------------------------------
+
+/* This function rounds a byte count up to the alignment of the sections. */
+static uint64_t solfile_align(uint64_t bytes)
+{
+	return (bytes + 7) & ~static_cast<uint64_t>(7);
+}
+
+static uint64_t solfile_bytes(const solfile_item &item)
+{
+	switch (item.type) {
+		case OMSK_SOLFILE_FLOAT64:	return solfile_align(item.count * sizeof(double));
+		case OMSK_SOLFILE_UINT8:	return solfile_align(item.count * sizeof(uint8_t));
+		case OMSK_SOLFILE_INT32:	return solfile_align(item.count * sizeof(int32_t));
+		default:
+			throw msk_exception("Internal error in solfile_bytes, unknown element type");
+	}
+}
+
+/* This function writes a block of bytes, or throws on failure. */
+static void solfile_write(FILE *stream, const void *data, size_t bytes, const string &filepath)
+{
+	if (bytes > 0 && fwrite(data, 1, bytes, stream) != bytes)
+		throw msk_exception("The solution file '" + filepath + "' could not be written");
+}
+
+/* This function writes zeros up to the next multiple of 8 bytes. */
+static void solfile_pad(FILE *stream, uint64_t bytes, const string &filepath)
+{
+	static const char zeros[8] = {0};
+	solfile_write(stream, zeros, static_cast<size_t>(solfile_align(bytes) - bytes), filepath);
+}
+
+/* This function streams one item from the task in chunks. */
+static void solfile_writeitem(FILE *stream, MSKtask_t task, const solfile_item &item, const string &filepath)
+{
+	string sname = item.name.substr(0, item.name.find('.'));
+	string vname = item.name.substr(item.name.find('.') + 1);
+	MSKsoltypee stype = get_msksoltype(sname);
+
+	MSKintt num = static_cast<MSKintt>(item.count);
+
+	// The solution and problem status
+	if (item.type == OMSK_SOLFILE_INT32) {
+		MSKprostae prosta;
+		MSKsolstae solsta;
+		errcatch( MSK_getsolutionstatus(task, stype, &prosta, &solsta) );
+
+		int32_t code = (vname == "solsta") ? static_cast<int32_t>(solsta) : static_cast<int32_t>(prosta);
+		solfile_write(stream, &code, sizeof(code), filepath);
+		solfile_pad(stream, sizeof(code), filepath);
+		return;
+	}
+
+	// The constraint and variable status keys
+	if (item.type == OMSK_SOLFILE_UINT8) {
+		MSKaccmodee accmode = (vname == "skc") ? MSK_ACC_CON : MSK_ACC_VAR;
+
+		vector<MSKstakeye> msksk(OMSK_SOLFILE_CHUNK);
+		vector<uint8_t> codes(OMSK_SOLFILE_CHUNK);
+		for (MSKintt first = 0; first < num; first += OMSK_SOLFILE_CHUNK) {
+			MSKintt last = (num - first > OMSK_SOLFILE_CHUNK) ? first + OMSK_SOLFILE_CHUNK : num;
+
+			errcatch( MSK_getsolutionstatuskeyslice(task, accmode, stype, first, last, &msksk[0]) );
+			for (MSKintt i = 0; i < last - first; ++i)
+				codes[i] = static_cast<uint8_t>(msksk[i]);
+
+			solfile_write(stream, &codes[0], last - first, filepath);
+		}
+		solfile_pad(stream, item.count, filepath);
+		return;
+	}
+
+	// The solution variable slices
+	MSKsoliteme vtype;
+	if (!get_msksolitem(vname, vtype))
+		throw msk_exception("Internal error in solfile_writeitem, unknown solution item");
+
+	vector<double> xx(OMSK_SOLFILE_CHUNK);
+	for (MSKintt first = 0; first < num; first += OMSK_SOLFILE_CHUNK) {
+		MSKintt last = (num - first > OMSK_SOLFILE_CHUNK) ? first + OMSK_SOLFILE_CHUNK : num;
+
+		errcatch( MSK_getsolutionslice(task, stype, vtype, first, last, &xx[0]) );
+		solfile_write(stream, &xx[0], (last - first) * sizeof(double), filepath);
+	}
+}
+
+void msk_writesolfile(const string &filepath, MSKtask_t task, const options_type &options, Octave_map &solvec)
+{
+	printdebug("msk_writesolfile called");
+
+	MSKintt NUMVAR, NUMCON;
+	errcatch( MSK_getnumvar(task, &NUMVAR) );
+	errcatch( MSK_getnumcon(task, &NUMCON) );
+
+	// Lay out the requested items of all defined solution types
+	vector<solfile_item> items;
+	vector<string> soltypes;
+	get_soltypenames(task, soltypes);
+
+	for (size_t s = 0; s < soltypes.size(); ++s) {
+		if (!isrequested(options.soltypes, soltypes[s]))
+			continue;
+
+		MSKsoltypee stype = get_msksoltype(soltypes[s]);
+
+		// The solution and problem status are also returned to Octave
+		Octave_map soltype;
+		soltype.assign("solsta", msk_getsolitem(task, stype, "solsta", false));
+		soltype.assign("prosta", msk_getsolitem(task, stype, "prosta", false));
+		solvec.assign(soltypes[s], octave_value(soltype));
+
+		vector<string> names;
+		get_solitemnames(stype, names);
+
+		for (size_t i = 0; i < names.size(); ++i) {
+			solfile_item item;
+			item.name = soltypes[s] + "." + names[i];
+			item.offset = 0;
+
+			if (names[i] == "solsta" || names[i] == "prosta") {
+				item.type = OMSK_SOLFILE_INT32;
+				item.count = 1;
+
+			} else {
+				if (!isrequested(options.solitems, names[i]))
+					continue;
+
+				if (names[i] == "skc" || names[i] == "skx") {
+					item.type = OMSK_SOLFILE_UINT8;
+					item.count = (names[i] == "skc") ? NUMCON : NUMVAR;
+
+				} else {
+					MSKsoliteme vtype;
+					get_msksolitem(names[i], vtype);
+
+					string vname;
+					int vsize;
+					getspecs_solitem(vtype, NUMVAR, NUMCON, vname, vsize);
+
+					item.type = OMSK_SOLFILE_FLOAT64;
+					item.count = vsize;
+				}
+			}
+			items.push_back(item);
+		}
+	}
+
+	uint64_t offset = OMSK_SOLFILE_HEADER_SIZE + OMSK_SOLFILE_ITEM_SIZE * items.size();
+	for (size_t i = 0; i < items.size(); ++i) {
+		items[i].offset = offset;
+		offset += solfile_bytes(items[i]);
+	}
+
+	// Write header, item table and data sections
+	FILE *stream = fopen(filepath.c_str(), "wb");
+	if (stream == NULL)
+		throw msk_exception("The solution file '" + filepath + "' could not be opened for writing");
+
+	try {
+		char header[OMSK_SOLFILE_HEADER_SIZE];
+		memset(header, 0, sizeof(header));
+		memcpy(header, OMSK_SOLFILE_MAGIC, 8);
+
+		uint32_t version = OMSK_SOLFILE_VERSION;
+		uint32_t numitems = static_cast<uint32_t>(items.size());
+		uint64_t numvar = NUMVAR;
+		uint64_t numcon = NUMCON;
+		memcpy(header + 8, &version, sizeof(version));
+		memcpy(header + 12, &numitems, sizeof(numitems));
+		memcpy(header + 16, &numvar, sizeof(numvar));
+		memcpy(header + 24, &numcon, sizeof(numcon));
+		solfile_write(stream, header, sizeof(header), filepath);
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			char entry[OMSK_SOLFILE_ITEM_SIZE];
+			memset(entry, 0, sizeof(entry));
+			strncpy(entry, items[i].name.c_str(), OMSK_SOLFILE_NAME_SIZE - 1);
+			memcpy(entry + 16, &items[i].type, sizeof(items[i].type));
+			memcpy(entry + 24, &items[i].count, sizeof(items[i].count));
+			memcpy(entry + 32, &items[i].offset, sizeof(items[i].offset));
+			solfile_write(stream, entry, sizeof(entry), filepath);
+		}
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			printdebug("Writing solution item " + items[i].name + " to file");
+			solfile_writeitem(stream, task, items[i], filepath);
+		}
+
+		if (fclose(stream) != 0) {
+			stream = NULL;
+			throw msk_exception("The solution file '" + filepath + "' could not be written");
+		}
+
+	} catch (msk_exception const& e) {
+		if (stream != NULL)
+			fclose(stream);
+		remove(filepath.c_str());
+		throw;
+	}
+}
+
+
+// ------------------------------
+// Saving and loading solutions
+// ------------------------------
+
+/* This function tells whether a solution item has one element per constraint. */
+static bool solfile_isconitem(const string &vname)
+{
+	return (vname == "skc" || vname == "xc" || vname == "slc" || vname == "suc");
+}
+
+/* This function checks that all items of the same kind have the same length. */
+static void solfile_setdim(int64_t &dim, int64_t count, const string &name)
+{
+	if (dim >= 0 && dim != count)
+		throw msk_exception("The solution item '" + name + "' does not have the length of the other items");
+	dim = count;
+}
+
+/* This function translates a problem or solution status name, e.g. "OPTIMAL", into its code. */
+static int32_t solfile_statuscode(string status, const string &prefix, const string &name)
+{
+	strtoupper(status);
+	append_mskprefix(status, prefix);
+
+	char value[MSK_MAX_STR_LEN];
+	if (!MSK_symnamtovalue(const_cast<MSKCONST char*>(status.c_str()), value))
+		throw msk_exception("The status of solution item '" + name + "' was not recognized");
+
+	return static_cast<int32_t>(atoi(value));
+}
+
+void msk_savesolfile(const string &filepath, MSKtask_t task, Octave_map &solvec)
+{
+	printdebug("msk_savesolfile called");
+
+	Binfile_writer file;
+	std::list<RowVector> slices;		// Referenced by the writer until the file is written
+	int64_t numvar = -1, numcon = -1;
+
+	for (Octave_map::iterator it = solvec.begin(); it != solvec.end(); ++it) {
+		string sname = solvec.key(it);
+		if (sname != "bas" && sname != "itr" && sname != "int") {
+			printwarning("The solution '" + sname + "' was not recognized.");
+			continue;
+		}
+
+		octave_value val = solvec.contents(it)(0);
+		if (isEmpty(val))
+			continue;
+
+		Octave_map sol = val.map_value();
+		if (error_state)
+			throw msk_exception("The solution \"" + sname + "\" should be a 'struct'");
+
+		vector<string> names;
+		get_solitemnames(get_msksoltype(sname), names);
+
+		for (size_t i = 0; i < names.size(); ++i) {
+			octave_value item;
+			map_seek_Value(&item, sol, names[i], true);
+			if (isEmpty(item))
+				continue;
+
+			string name = sname + "." + names[i];
+
+			if (names[i] == "solsta" || names[i] == "prosta") {
+				string status = item.string_value();
+				if (error_state)
+					throw msk_exception("The solution item '" + name + "' should be a string");
+
+				string prefix = (names[i] == "solsta") ? "MSK_SOL_STA_" : "MSK_PRO_STA_";
+				file.add_int32(name, vector<int32_t>(1, solfile_statuscode(status, prefix, name)));
+
+			} else if (names[i] == "skc" || names[i] == "skx") {
+				MSKintt num = item.numel();
+				solfile_setdim(names[i] == "skc" ? numcon : numvar, num, name);
+
+				// Strings and codes are both accepted, as for initial solutions
+				auto_array<MSKstakeye> msksk( new MSKstakeye[num] );
+				set_stakeys(task, item, msksk, num, names[i]);
+
+				vector<uint8_t> codes(static_cast<MSKstakeye*>(msksk), static_cast<MSKstakeye*>(msksk) + num);
+				file.add_uint8(name, codes.empty() ? NULL : &codes[0], codes.size());
+
+			} else {
+				// Sparse slices are stored in full
+				slices.push_back(RowVector());
+				if (item.is_sparse_type())
+					slices.back() = octave_value(item.matrix_value()).row_vector_value();
+				else
+					slices.back() = item.row_vector_value();
+				if (error_state)
+					throw msk_exception("The solution item '" + name + "' should be a vector");
+
+				solfile_setdim(solfile_isconitem(names[i]) ? numcon : numvar, slices.back().nelem(), name);
+				file.add_float64(name, slices.back().data(), slices.back().nelem());
+			}
+		}
+	}
+
+	vector<uint64_t> dims(2);
+	dims[0] = (numvar < 0) ? 0 : numvar;
+	dims[1] = (numcon < 0) ? 0 : numcon;
+	file.write(filepath, OMSK_SOLFILE_MAGIC, OMSK_SOLFILE_VERSION, dims);
+}
+
+void msk_loadsolfile(const string &filepath, MSKtask_t task, bool skcodes, Octave_map &solvec)
+{
+	printdebug("msk_loadsolfile called");
+
+	Binfile_reader file;
+	file.open(filepath, OMSK_SOLFILE_MAGIC, OMSK_SOLFILE_VERSION);
+
+	std::map<string, Octave_map> solutions;
+	const std::map<string, solfile_item> &items = file.itemlist();
+	for (std::map<string, solfile_item>::const_iterator it = items.begin(); it != items.end(); ++it) {
+		string sname = it->first.substr(0, it->first.find('.'));
+		if (sname != "bas" && sname != "itr" && sname != "int")
+			continue;
+
+		string vname = it->first.substr(sname.length() + 1);
+		Octave_map &sol = solutions[sname];
+
+		switch (it->second.type) {
+			case OMSK_SOLFILE_INT32: {
+				int32_t code = file.int32(it->first, 1)[0];
+
+				char status[MSK_MAX_STR_LEN];
+				if (vname == "solsta") {
+					errcatch( MSK_solstatostr(task, static_cast<MSKsolstae>(code), status) );
+				} else {
+					errcatch( MSK_prostatostr(task, static_cast<MSKprostae>(code), status) );
+				}
+				sol.assign(vname, octave_value(status, '\"'));
+				break;
+			}
+			case OMSK_SOLFILE_UINT8: {
+				const uint8_t *codes = file.uint8(it->first, -1);
+				octave_idx_type num = static_cast<octave_idx_type>(it->second.count);
+
+				if (skcodes) {
+					uint8NDArray skvec(dim_vector(1, num));
+					octave_uint8 *psk = skvec.fortran_vec();
+					for (octave_idx_type i = 0; i < num; ++i)
+						psk[i] = octave_uint8(codes[i]);
+					sol.assign(vname, octave_value(skvec));
+
+				} else {
+					Cell skvec(dim_vector(1, num));
+					char skname[MSK_MAX_STR_LEN];
+					for (octave_idx_type i = 0; i < num; ++i) {
+						errcatch( MSK_sktostr(task, static_cast<MSKstakeye>(codes[i]), skname) );
+						skvec.elem(i) = octave_value(skname, '\"');
+					}
+					sol.assign(vname, octave_value(skvec));
+				}
+				break;
+			}
+			case OMSK_SOLFILE_FLOAT64: {
+				RowVector vec(static_cast<octave_idx_type>(it->second.count));
+				memcpy(vec.fortran_vec(), file.float64(it->first, -1), it->second.count * sizeof(double));
+				sol.assign(vname, octave_value(vec));
+				break;
+			}
+			default:
+				throw msk_exception("The solution item '" + it->first + "' in file '" + filepath + "' has an unexpected element type");
+		}
+	}
+
+	for (std::map<string, Octave_map>::iterator it = solutions.begin(); it != solutions.end(); ++it)
+		solvec.assign(it->first, octave_value(it->second));
+}
+
+/* This function returns an item of the file, or 'fallback' if it is not there. */
+static const double* solfile_slice(const Binfile_reader &file, const string &name, MSKintt num, const double *fallback)
+{
+	return file.has(name) ? file.float64(name, num) : fallback;
+}
+
+/* This function converts the status key codes of an item, which are unknown if it is not there. */
+static void solfile_stakeys(const Binfile_reader &file, const string &name, MSKintt num, vector<MSKstakeye> &msksk)
+{
+	if (!file.has(name)) {
+		std::fill(msksk.begin(), msksk.end(), MSK_SK_UNK);
+		return;
+	}
+
+	const uint8_t *codes = file.uint8(name, num);
+	for (MSKintt i = 0; i < num; ++i) {
+		if (codes[i] >= MSK_SK_END)
+			throw msk_exception("The status keys '" + name + "' contain an unknown code");
+		msksk[i] = static_cast<MSKstakeye>(codes[i]);
+	}
+}
+
+/* This function checks the length of each solution item in the file against the problem. The
+ * header is not used, as it has zero constraints for solutions saved without constraint items. */
+static void solfile_checkdims(const Binfile_reader &file, const string &filepath, MSKintt NUMVAR, MSKintt NUMCON)
+{
+	const std::map<string, solfile_item> &items = file.itemlist();
+	for (std::map<string, solfile_item>::const_iterator it = items.begin(); it != items.end(); ++it) {
+		size_t dot = it->first.find('.');
+		if (dot == string::npos || (it->second.type != OMSK_SOLFILE_FLOAT64 && it->second.type != OMSK_SOLFILE_UINT8))
+			continue;
+
+		string vname = it->first.substr(dot + 1);
+		uint64_t expected = solfile_isconitem(vname) ? NUMCON : NUMVAR;
+		if (it->second.count != expected)
+			throw msk_exception("The solution item '" + it->first + "' in file '" + filepath + "' does not match the dimensions of the problem");
+	}
+}
+
+void msk_putsolfile(MSKtask_t task, const string &filepath)
+{
+	printdebug("msk_putsolfile called");
+
+	Binfile_reader file;
+	file.open(filepath, OMSK_SOLFILE_MAGIC, OMSK_SOLFILE_VERSION);
+
+	MSKintt NUMVAR, NUMCON, NUMCONE;
+	errcatch( MSK_getnumvar(task, &NUMVAR) );
+	errcatch( MSK_getnumcon(task, &NUMCON) );
+	errcatch( MSK_getnumcone(task, &NUMCONE) );
+
+	solfile_checkdims(file, filepath, NUMVAR, NUMCON);
+
+	// Room for at least one element, such that no pointer is NULL
+	vector<double> zeros(std::max(NUMVAR, NUMCON) + 1, 0.0);
+	vector<double> y(NUMCON + 1);
+	vector<MSKstakeye> skc(NUMCON + 1), skx(NUMVAR + 1), skn(NUMCONE + 1, MSK_SK_UNK);
+
+	const std::map<string, solfile_item> &items = file.itemlist();
+	string snames[] = {"bas", "itr", "int"};
+
+	for (int s = 0; s < 3; ++s) {
+		string prefix = snames[s] + ".";
+
+		std::map<string, solfile_item>::const_iterator it = items.lower_bound(prefix);
+		if (it == items.end() || it->first.compare(0, prefix.length(), prefix) != 0)
+			continue;
+
+		printdebug("Reading the initial solution '" + snames[s] + "' from file");
+
+		solfile_stakeys(file, prefix + "skc", NUMCON, skc);
+		solfile_stakeys(file, prefix + "skx", NUMVAR, skx);
+
+		const double *xc  = solfile_slice(file, prefix + "xc",  NUMCON, &zeros[0]);
+		const double *slc = solfile_slice(file, prefix + "slc", NUMCON, &zeros[0]);
+		const double *suc = solfile_slice(file, prefix + "suc", NUMCON, &zeros[0]);
+		const double *xx  = solfile_slice(file, prefix + "xx",  NUMVAR, &zeros[0]);
+		const double *slx = solfile_slice(file, prefix + "slx", NUMVAR, &zeros[0]);
+		const double *sux = solfile_slice(file, prefix + "sux", NUMVAR, &zeros[0]);
+		const double *snx = solfile_slice(file, prefix + "snx", NUMVAR, &zeros[0]);
+
+		// The dual of the constraints is not stored, but given by its bounds
+		for (MSKintt i = 0; i < NUMCON; ++i)
+			y[i] = slc[i] - suc[i];
+
+		errcatch( MSK_putsolution(task, get_msksoltype(snames[s]), &skc[0], &skx[0], &skn[0],
+				xc, xx, &y[0], slc, suc, slx, sux, snx) );
+	}
+}
@@ -0,0 +1,76 @@
+#ifndef OMSK_UTILS_SOLFILE_H_
+#define OMSK_UTILS_SOLFILE_H_
+
+#include "omsk_msg_mosek.h"
+#include "omsk_obj_arguments.h"
+
+#include <octave/oct.h>
+#include <octave/ov-struct.h>
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+// ------------------------------
+// Binary solution files
+// ------------------------------
+//
+// A solution file holds the items of one or more solution types, written from
+// the task in chunks of OMSK_SOLFILE_CHUNK elements so that memory use does not
+// depend on the problem size. All fields are native-endian and every section
+// starts at an offset divisible by 8, so the file can be memory-mapped as is:
+//
+//   Header (64 bytes):
+//     0  char[8]   magic "OMSKSOL1"
+//     8  uint32    version (1)
+//    12  uint32    number of items
+//    16  uint64    number of variables
+//    24  uint64    number of constraints
+//    32  reserved  (zero)
+//
+//   Item table (40 bytes per item, directly after the header):
+//     0  char[16]  name, e.g. "itr.xx" (zero-padded)
+//    16  uint32    element type (OMSK_SOLFILE_*)
+//    20  uint32    reserved (zero)
+//    24  uint64    number of elements
+//    32  uint64    offset of the data from the beginning of the file
+//
+//   Data sections in the order of the item table, each zero-padded to a
+//   multiple of 8 bytes.
+//
+#define OMSK_SOLFILE_MAGIC			"OMSKSOL1"
+#define OMSK_SOLFILE_VERSION		1
+#define OMSK_SOLFILE_HEADER_SIZE	64
+#define OMSK_SOLFILE_ITEM_SIZE		40
+#define OMSK_SOLFILE_NAME_SIZE		16
+#define OMSK_SOLFILE_CHUNK			65536
+
+#define OMSK_SOLFILE_FLOAT64		1	/* Solution slices, e.g. xx */
+#define OMSK_SOLFILE_UINT8			2	/* Status key codes, e.g. skx */
+#define OMSK_SOLFILE_INT32			3	/* Solution and problem status codes */
+#define OMSK_SOLFILE_TEXT			4	/* NUL-terminated strings (count in bytes) */
+
+struct solfile_item {
+	std::string name;
+	uint32_t	type;
+	uint64_t	count;
+	uint64_t	offset;
+};
+
+// Writes the requested solution items of task to 'filepath', and adds the
+// solution and problem status of each solution type to 'solvec'
+void msk_writesolfile(const std::string &filepath, MSKtask_t task, const options_type &options, Octave_map &solvec);
+
+// Writes a solution given in Octave (as returned by mosek) to 'filepath'. The
+// task is only used to translate status names into codes.
+void msk_savesolfile(const std::string &filepath, MSKtask_t task, Octave_map &solvec);
+
+// Reads a solution file into Octave, with status keys as strings or codes. The
+// task is only used to translate status codes into names.
+void msk_loadsolfile(const std::string &filepath, MSKtask_t task, bool skcodes, Octave_map &solvec);
+
+// Puts the solutions of a solution file into task as initial solutions, with
+// one bulk call per solution type taking the vectors straight from the file
+void msk_putsolfile(MSKtask_t task, const std::string &filepath);
+
+#endif /* OMSK_UTILS_SOLFILE_H_ */
@@ -0,0 +1,390 @@
+#include "omsk_utils_threads.h"
+
+#include <string>
+#include <vector>
+#include <exception>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/time.h>
+#endif
+
+using std::string;
+using std::vector;
+using std::exception;
+
+
+// ------------------------------
+// Class msk_mutex
+// ------------------------------
+
+#ifdef _WIN32
+
+msk_mutex::msk_mutex()		{ InitializeCriticalSection(&cs); }
+msk_mutex::~msk_mutex()		{ DeleteCriticalSection(&cs); }
+void msk_mutex::lock()		{ EnterCriticalSection(&cs); }
+void msk_mutex::unlock()	{ LeaveCriticalSection(&cs); }
+
+#else
+
+msk_mutex::msk_mutex()		{ pthread_mutex_init(&mutex, NULL); }
+msk_mutex::~msk_mutex()		{ pthread_mutex_destroy(&mutex); }
+void msk_mutex::lock()		{ pthread_mutex_lock(&mutex); }
+void msk_mutex::unlock()	{ pthread_mutex_unlock(&mutex); }
+
+#endif
+
+
+// ------------------------------
+// Class msk_condition
+// ------------------------------
+
+#ifdef _WIN32
+
+msk_condition::msk_condition()				{ InitializeConditionVariable(&cv); }
+msk_condition::~msk_condition()				{}
+void msk_condition::wait(msk_mutex &mutex)	{ SleepConditionVariableCS(&cv, &mutex.cs, INFINITE); }
+void msk_condition::broadcast()				{ WakeAllConditionVariable(&cv); }
+
+#else
+
+msk_condition::msk_condition()				{ pthread_cond_init(&cond, NULL); }
+msk_condition::~msk_condition()				{ pthread_cond_destroy(&cond); }
+void msk_condition::wait(msk_mutex &mutex)	{ pthread_cond_wait(&cond, &mutex.mutex); }
+void msk_condition::broadcast()				{ pthread_cond_broadcast(&cond); }
+
+#endif
+
+
+// ------------------------------
+// Class msk_thread
+// ------------------------------
+
+struct msk_threadstart {
+	msk_threadfunc func;
+	void *data;
+};
+
+#ifdef _WIN32
+static DWORD WINAPI msk_threadmain(LPVOID arg)
+#else
+static void* msk_threadmain(void *arg)
+#endif
+{
+	msk_threadstart *start = static_cast<msk_threadstart*>(arg);
+	msk_threadfunc func = start->func;
+	void *data = start->data;
+	delete start;
+
+	func(data);
+	return 0;
+}
+
+void msk_thread::start(msk_threadfunc func, void *data) {
+	if (running)
+		throw msk_exception("Internal error in msk_thread::start, the thread is already running");
+
+	msk_threadstart *start = new msk_threadstart;
+	start->func = func;
+	start->data = data;
+
+#ifdef _WIN32
+	handle = CreateThread(NULL, 0, msk_threadmain, start, 0, NULL);
+	if (handle == NULL) {
+#else
+	if (pthread_create(&handle, NULL, msk_threadmain, start) != 0) {
+#endif
+		delete start;
+		throw msk_exception("A worker thread could not be started");
+	}
+
+	running = true;
+}
+
+void msk_thread::join() {
+	if (running) {
+#ifdef _WIN32
+		WaitForSingleObject(handle, INFINITE);
+		CloseHandle(handle);
+#else
+		pthread_join(handle, NULL);
+#endif
+		running = false;
+	}
+}
+
+msk_thread::~msk_thread() {
+	join();
+}
+
+
+// ------------------------------
+// Parallel loops
+// ------------------------------
+
+struct parallel_state {
+	msk_jobfunc job;
+	void *data;
+	int n;
+
+	msk_mutex mutex;
+	int next;
+	bool failed;
+	string error;
+};
+
+static void parallel_worker(void *arg)
+{
+	parallel_state *state = static_cast<parallel_state*>(arg);
+
+	while (true) {
+		int i;
+		{
+			msk_lock lock(state->mutex);
+			if (state->failed || state->next >= state->n)
+				return;
+			i = state->next++;
+		}
+
+		try {
+			state->job(i, state->data);
+
+		} catch (exception const& e) {
+			msk_lock lock(state->mutex);
+			if (!state->failed) {
+				state->failed = true;
+				state->error = e.what();
+			}
+
+		} catch (...) {
+			msk_lock lock(state->mutex);
+			if (!state->failed) {
+				state->failed = true;
+				state->error = "An unknown error occurred in a worker thread";
+			}
+		}
+	}
+}
+
+void run_parallel(msk_jobfunc job, void *data, int n, int numthreads)
+{
+	parallel_state state;
+	state.job = job;
+	state.data = data;
+	state.n = n;
+	state.next = 0;
+	state.failed = false;
+
+	if (numthreads > n)
+		numthreads = n;
+
+	// The calling thread takes part in the work, so one thread less is started
+	int numworkers = (numthreads > 1) ? numthreads - 1 : 0;
+	auto_array<msk_thread> threads( new msk_thread[numworkers] );
+	for (int t = 0; t < numworkers; ++t) {
+		try {
+			threads[t].start(parallel_worker, &state);
+
+		} catch (msk_exception const&) {
+			// Continue with the threads that could be started
+			break;
+		}
+	}
+
+	parallel_worker(&state);
+
+	for (int t = 0; t < numworkers; ++t)
+		threads[t].join();
+
+	if (state.failed)
+		throw msk_exception(state.error);
+}
+
+struct pipelined_state {
+	msk_jobfunc job;
+	void *data;
+	int n;
+
+	msk_mutex mutex;
+	msk_condition changed;
+	int ready;				/* Items [0, ready) have been prepared */
+	int next;				/* Next item to be taken by a worker */
+	vector<char> done;		/* Whether the job of an item has finished */
+	bool stopped;
+	bool failed;
+	string error;
+};
+
+/* This function runs the job of one item taken by a worker (or the calling thread). */
+static void pipelined_run(pipelined_state *state, int i)
+{
+	try {
+		state->job(i, state->data);
+
+	} catch (exception const& e) {
+		msk_lock lock(state->mutex);
+		if (!state->failed) {
+			state->failed = true;
+			state->error = e.what();
+		}
+
+	} catch (...) {
+		msk_lock lock(state->mutex);
+		if (!state->failed) {
+			state->failed = true;
+			state->error = "An unknown error occurred in a worker thread";
+		}
+	}
+
+	msk_lock lock(state->mutex);
+	state->done[i] = 1;
+	state->changed.broadcast();
+}
+
+static void pipelined_worker(void *arg)
+{
+	pipelined_state *state = static_cast<pipelined_state*>(arg);
+
+	while (true) {
+		int i;
+		{
+			msk_lock lock(state->mutex);
+			while (!state->stopped && !state->failed && state->next < state->n && state->next >= state->ready)
+				state->changed.wait(state->mutex);
+
+			if (state->stopped || state->failed || state->next >= state->n)
+				return;
+			i = state->next++;
+		}
+
+		pipelined_run(state, i);
+	}
+}
+
+/* Stops the workers and waits for them (also when the calling thread unwinds). */
+class pipelined_threads {
+private:
+	pipelined_state &state;
+
+public:
+	auto_array<msk_thread> threads;
+	int numthreads;
+
+	pipelined_threads(pipelined_state &state, int numthreads) :
+		state(state), threads(new msk_thread[numthreads]), numthreads(numthreads) {}
+
+	~pipelined_threads() {
+		stop();
+	}
+
+	void stop() {
+		{
+			msk_lock lock(state.mutex);
+			state.stopped = true;
+			state.changed.broadcast();
+		}
+		for (int t = 0; t < numthreads; ++t)
+			threads[t].join();
+	}
+};
+
+void run_pipelined(msk_jobfunc prepare, msk_jobfunc job, msk_jobfunc finish, void *data, int n, int numthreads, int window)
+{
+	pipelined_state state;
+	state.job = job;
+	state.data = data;
+	state.n = n;
+	state.ready = 0;
+	state.next = 0;
+	state.done.assign(n, 0);
+	state.stopped = false;
+	state.failed = false;
+
+	if (numthreads > n)
+		numthreads = n;
+	if (window < 1)
+		window = 1;
+
+	// The calling thread prepares and finishes the items, while the workers run the jobs
+	pipelined_threads workers(state, numthreads);
+	int numstarted = 0;
+	for (int t = 0; t < numthreads; ++t) {
+		try {
+			workers.threads[t].start(pipelined_worker, &state);
+			++numstarted;
+
+		} catch (msk_exception const&) {
+			// Continue with the threads that could be started
+			break;
+		}
+	}
+
+	int numprepared = 0;
+	for (int i = 0; i < n; ++i) {
+		while (numprepared < n && numprepared < i + window) {
+			prepare(numprepared, data);
+			++numprepared;
+
+			msk_lock lock(state.mutex);
+			state.ready = numprepared;
+			state.changed.broadcast();
+		}
+
+		// Wait for the job of item i (running it here if no worker could be started)
+		bool failed;
+		while (true) {
+			int j = -1;
+			{
+				msk_lock lock(state.mutex);
+				if (numstarted == 0 && !state.done[i] && !state.failed)
+					j = state.next++;
+				else
+					while (!state.done[i] && !state.failed)
+						state.changed.wait(state.mutex);
+
+				failed = state.failed;
+			}
+
+			if (j < 0)
+				break;
+			pipelined_run(&state, j);
+		}
+
+		if (failed)
+			break;
+
+		finish(i, data);
+	}
+
+	// Join the workers before reporting a failed job
+	workers.stop();
+
+	if (state.failed)
+		throw msk_exception(state.error);
+}
+
+int get_numprocessors()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int num = static_cast<int>(info.dwNumberOfProcessors);
+#else
+	int num = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+	return (num >= 1) ? num : 1;
+}
+
+double get_walltime()
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq, count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return static_cast<double>(count.QuadPart) / static_cast<double>(freq.QuadPart);
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+}
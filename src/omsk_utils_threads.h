@@ -0,0 +1,147 @@
+#ifndef OMSK_UTILS_THREADS_H_
+#define OMSK_UTILS_THREADS_H_
+
+#include "omsk_msg_base.h"
+
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// ------------------------------
+// THREADING UTILITIES
+// ------------------------------
+//
+// Worker threads run plain C++ and MOSEK code only. They must never call the
+// Octave API or the printing system (neither of which is thread-safe), so all
+// conversions to and from Octave values stay on the calling thread.
+//
+
+// ------------------------------
+// Class msk_mutex
+// ------------------------------
+class msk_mutex {
+private:
+#ifdef _WIN32
+	CRITICAL_SECTION cs;
+#else
+	pthread_mutex_t mutex;
+#endif
+
+	// Overwrite copy constructor and provide no implementation
+	msk_mutex(const msk_mutex& that);
+
+	friend class msk_condition;
+
+public:
+	msk_mutex();
+	~msk_mutex();
+
+	void lock();
+	void unlock();
+};
+
+// Locks a mutex for the lifetime of the object
+class msk_lock {
+private:
+	msk_mutex &mutex;
+
+	// Overwrite copy constructor and provide no implementation
+	msk_lock(const msk_lock& that);
+
+public:
+	explicit msk_lock(msk_mutex &mutex) : mutex(mutex) { mutex.lock(); }
+	~msk_lock() { mutex.unlock(); }
+};
+
+
+// ------------------------------
+// Class msk_condition
+// ------------------------------
+//
+// A condition variable used together with an msk_mutex. 'wait' must be called
+// with the mutex locked, and may return spuriously (so test in a loop).
+//
+class msk_condition {
+private:
+#ifdef _WIN32
+	CONDITION_VARIABLE cv;
+#else
+	pthread_cond_t cond;
+#endif
+
+	// Overwrite copy constructor and provide no implementation
+	msk_condition(const msk_condition& that);
+
+public:
+	msk_condition();
+	~msk_condition();
+
+	void wait(msk_mutex &mutex);
+	void broadcast();
+};
+
+
+// ------------------------------
+// Class msk_thread
+// ------------------------------
+//
+// A single background thread running 'func(data)'. The thread is joined by
+// 'join' or, at the latest, by the destructor.
+//
+typedef void (*msk_threadfunc)(void *data);
+
+class msk_thread {
+private:
+#ifdef _WIN32
+	HANDLE handle;
+#else
+	pthread_t handle;
+#endif
+	bool running;
+
+	// Overwrite copy constructor and provide no implementation
+	msk_thread(const msk_thread& that);
+
+public:
+	msk_thread() : running(false) {}
+	~msk_thread();
+
+	void start(msk_threadfunc func, void *data);
+	void join();
+	bool isrunning() const { return running; }
+};
+
+
+// ------------------------------
+// Parallel loops
+// ------------------------------
+//
+// Calls 'job(i, data)' for all i in [0, n) on at most 'numthreads' worker
+// threads, and returns when all calls have finished. The first exception
+// thrown by a job is rethrown as an msk_exception on the calling thread.
+//
+typedef void (*msk_jobfunc)(int i, void *data);
+
+void run_parallel(msk_jobfunc job, void *data, int n, int numthreads);
+
+// Calls 'prepare(i, data)' on the calling thread, then 'job(i, data)' on one of
+// at most 'numthreads' worker threads, and finally 'finish(i, data)' on the
+// calling thread, for all i in [0, n) with 'prepare' and 'finish' in order. At
+// most 'window' items are between 'prepare' and 'finish' at any time, such that
+// item i can use slot i % window of the caller. Exceptions of 'prepare' and
+// 'finish' are rethrown as they are, and the first exception of a job as an
+// msk_exception, in both cases after the running jobs have finished.
+//
+void run_pipelined(msk_jobfunc prepare, msk_jobfunc job, msk_jobfunc finish, void *data, int n, int numthreads, int window);
+
+// Number of processors available (at least one)
+int get_numprocessors();
+
+// Wall-clock time in seconds (safe to call from worker threads)
+double get_walltime();
+
+#endif /* OMSK_UTILS_THREADS_H_ */